@@ -0,0 +1,60 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* graphe d'un squelette curviligne (voir lskelgraph.c) */
+
+/* types de sommets */
+#define SG_ISOLE     0          /* amas de degre 0 (point isole) */
+#define SG_EXTREMITE 1          /* amas de degre 1 (extremite) */
+#define SG_BOUCLE    2          /* point choisi sur une courbe fermee sans autre sommet */
+#define SG_JONCTION  3          /* amas de degre 3 ou plus */
+
+typedef struct {
+  int32_t rs, cs, ds;           /* dimensions de l'image */
+  int32_t nbsom;                /* nombre de sommets */
+  int32_t nbarc;                /* nombre d'arcs (branches) */
+  int32_t maxarc;               /* capacite des tableaux d'arcs */
+  int32_t *tsom;                /* type du sommet (SG_...) */
+  int32_t *npsom;               /* nombre de points du sommet */
+  int32_t *dsom;                /* degre du sommet */
+  double *xsom, *ysom, *zsom;   /* barycentre des points du sommet */
+  int32_t *orig, *extr;         /* sommets origine et extremite de chaque arc */
+  int32_t *porig, *pextr;       /* points de ces sommets auxquels l'arc est attache */
+  int32_t *nparc;               /* nombre de points internes de la branche */
+  double *larc;                 /* longueur euclidienne de la branche */
+} skelgraphe;
+
+extern skelgraphe * lskelgraph(struct xvimage *image, int32_t connex);
+extern int32_t writeskelgraph(skelgraphe *g, char *filename);
+extern void freeskelgraph(skelgraphe *g);
@@ -41,3 +41,35 @@ extern int32_t lskelAK2(struct xvimage *image,
 extern int32_t lskelNK2(struct xvimage *image, 
 			int32_t nsteps,
 			struct xvimage *inhibit);
+extern int32_t lskelstack(int32_t (*skel)(struct xvimage *, int32_t, struct xvimage *),
+			  struct xvimage *image,
+			  int32_t nsteps,
+			  struct xvimage *inhibit);
+extern int32_t lskeltab_mode(int32_t mode);
+extern int32_t lskeltab(struct xvimage *image, 
+			int32_t mode,
+			int32_t nsteps,
+			struct xvimage *inhibit);
+extern int32_t lskeltabfront(struct xvimage *image, 
+			     int32_t mode,
+			     int32_t nsteps,
+			     struct xvimage *inhibit);
+extern int32_t lskelMK2b(struct xvimage *image, 
+			 int32_t nsteps,
+			 struct xvimage *inhibit);
+extern int32_t lskelAK2b(struct xvimage *image, 
+			 int32_t nsteps,
+			 struct xvimage *inhibit);
+extern int32_t lskelNK2b(struct xvimage *image, 
+			 int32_t nsteps,
+			 struct xvimage *inhibit);
+
+/* amincissement sequentiel guide par la distance (voir lskelpar.c) */
+#define LSKEL_MK2 0
+#define LSKEL_CK2 1
+#define LSKEL_EK2 2
+
+extern int32_t lskelseq2(struct xvimage *image, 
+			 int32_t nsteps,
+			 struct xvimage *inhibit,
+			 int32_t algo);
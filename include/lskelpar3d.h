@@ -35,6 +35,9 @@ knowledge of the CeCILL license and that you accept its terms.
 extern int32_t lskelMK3(struct xvimage *image, 
 			int32_t nsteps,
 			struct xvimage *inhibit);
+extern int32_t lskelMK3f(struct xvimage *image, 
+			 int32_t nsteps,
+			 struct xvimage *inhibit);
 extern int32_t lskelCK3(struct xvimage *image, 
 			int32_t nsteps,
 			struct xvimage *inhibit);
@@ -55,3 +58,34 @@ extern int32_t lskelEK3(struct xvimage *image,
 			int32_t nsteps,
 			struct xvimage *inhibit);
 
+/* codes des algorithmes pour lskelmulti3d */
+#define LSKEL_MK3 0
+#define LSKEL_CK3 1
+#define LSKEL_EK3 2
+
+extern int32_t lskelmulti3d(struct xvimage *image, 
+			    int32_t nsteps,
+			    struct xvimage *inhibit,
+			    int32_t nalgo,
+			    int32_t *algo,
+			    struct xvimage **result);
+
+/* amincissement sequentiel guide par la distance (voir lskelpar3d.c) */
+extern int32_t lskelseq3(struct xvimage *image, 
+			 int32_t nsteps,
+			 struct xvimage *inhibit,
+			 int32_t algo);
+
+/* re-squelettisation incrementale (voir lskelpar3d.c) */
+extern int32_t lskelCK3map(struct xvimage *image, 
+			   struct xvimage *inhibit,
+			   struct xvimage *map);
+extern int32_t lskelCK3inc(struct xvimage *image, 
+			   struct xvimage *inhibit,
+			   struct xvimage *previous,
+			   struct xvimage *map,
+			   int32_t *dirty);
+
+/* points de reprise (voir lskelpar3d.c) */
+extern void lskel3d_checkpoint(char *filename, int32_t nsteps, int32_t nsecs);
+extern void lskel3d_resume(char *filename);
@@ -71,7 +71,9 @@ struct xvimage {
 
   uint32_t data_storage_type;  /* storage type for disk data */
   double xdim, ydim, zdim;          /* voxel dimensions in real world */
-  uint8_t imagedata[1];
+  void *bloc;                       /* allocated block holding header and data */
+  size_t taillebloc;                /* size of bloc if mapped, 0 if malloc'ed */
+  uint8_t imagedata[1];             /* aligned (see allocimage) */
 };
 #endif
 
@@ -107,6 +109,27 @@ struct xvimage {
 #define nonbord(p,rs,N) ((p%rs!=rs-1)&&(p>=rs)&&(p%rs!=0)&&(p<N-rs))
 #define nonbord3d(p,rs,ps,N) ((p>=ps)&&(p<N-ps)&&(p%ps>=rs)&&(p%ps<ps-rs)&&(p%rs!=0)&&(p%rs!=rs-1))
 
+/* masques 27 bits du voisinage 3x3x3 (voir mask27, colonnes27) */
+#define MASK27_CENTRE  0x0002000  /* bit 13 : le point lui-meme */
+#define MASK27_TOUS    0x7ffffff  /* les 27 bits */
+#define MASK27_V6      0x0415410  /* bits des 6 voisins directs */
+#define MASK27_GAUCHE  0x36db6db  /* bits des colonnes x = 0 et x = 1 */
+#define MASK27_SUIVANT(m,c) ((((m) >> 1) & MASK27_GAUCHE) | etale27[c])
+
+/* traitement par lots des points d'une rangee (voir lignes27) */
+#define LIGNES27_MAX 62
+#define MASK27_LIGNES(L,k) ((uint32_t)( \
+   ((L)[0] >> (k) & 7)        | ((L)[1] >> (k) & 7) << 3  | ((L)[2] >> (k) & 7) << 6  | \
+   ((L)[3] >> (k) & 7) << 9  | ((L)[4] >> (k) & 7) << 12 | ((L)[5] >> (k) & 7) << 15 | \
+   ((L)[6] >> (k) & 7) << 18 | ((L)[7] >> (k) & 7) << 21 | ((L)[8] >> (k) & 7) << 24))
+#define INTERIEURS27(L) \
+  ((L)[4] & ((L)[4] >> 1) & ((L)[4] >> 2) & (((L)[1] & (L)[3] & (L)[5] & (L)[7]) >> 1))
+#ifdef __GNUC__
+#define RANG64(o) __builtin_ctzll(o)
+#else
+#define RANG64(o) rang64(o)
+#endif
+
 /* ============== */
 /* prototypes     */
 /* ============== */
@@ -117,6 +140,7 @@ extern int32_t voisin6(int32_t i, int32_t k, int32_t rs, int32_t n, int32_t nb);
 extern int32_t bord(int32_t i, int32_t rs, int32_t nb);
 extern int32_t bord3d(int32_t i, int32_t rs, int32_t ps, int32_t nb);
 extern int32_t voisin26(int32_t i, int32_t k, int32_t rs, int32_t n, int32_t nb);
+extern void offsetvois26(int32_t rs, int32_t ps, int32_t *off);
 extern int32_t voisin18(int32_t i, int32_t k, int32_t rs, int32_t n, int32_t nb);
 extern int32_t voisins4(int32_t i, int32_t j, int32_t rs);
 extern int32_t voisins8(int32_t i, int32_t j, int32_t rs);   
@@ -132,3 +156,10 @@ extern int32_t voisinENAR(int32_t i, int32_t k, int32_t rs, int32_t ps, int32_t
 extern int32_t voisinENAV(int32_t i, int32_t k, int32_t rs, int32_t ps, int32_t N );
 extern int32_t voisinONAR(int32_t i, int32_t k, int32_t rs, int32_t ps, int32_t N );
 extern uint32_t maskvois26(uint8_t *F, uint32_t bitmask, int32_t i, int32_t rs, int32_t ps, int32_t N);
+extern const uint32_t etale27[512];
+extern uint32_t mask27(uint8_t *F, int32_t i, int32_t rs, int32_t ps);
+extern void colonnes27(uint8_t *F, int32_t i, int32_t n, int32_t rs, int32_t ps, uint16_t *C);
+extern uint64_t lignes27(uint8_t *F, int32_t i, int32_t n, int32_t rs, int32_t ps, uint64_t *L);
+#ifndef __GNUC__
+extern int32_t rang64(uint64_t o);
+#endif
@@ -43,8 +43,16 @@ extern struct xvimage *allocheader(char * name, int32_t rs, int32_t cs, int32_t
 extern int32_t showheader(char * name);
 extern void freeimage(struct xvimage *image);
 extern struct xvimage *copyimage(struct xvimage *f);
+extern struct xvimage *allocscratch(int32_t rs, int32_t cs, int32_t d, int32_t t);
+extern struct xvimage *copyscratch(struct xvimage *f);
+extern void freescratch(struct xvimage *image);
+extern void purgescratch();
 extern int32_t copy2image(struct xvimage *dest, struct xvimage *source);
 extern int32_t equalimages(struct xvimage *im1, struct xvimage *im2);
+extern int32_t touchframe(struct xvimage *f);
+extern struct xvimage *addframe(struct xvimage *f);
+extern int32_t addframes(struct xvimage *f, struct xvimage *i, struct xvimage **ff, struct xvimage **fi);
+extern int32_t delframe(struct xvimage *f, struct xvimage *g);
 extern void list2image(struct xvimage * image, double *P, int32_t n);
 extern double * image2list(struct xvimage * image, int32_t *n);
 
@@ -69,6 +77,23 @@ extern void writerawimage(
   char *filename
 );
 
+#define LISTE_SANS    0                /* writelistimage : sans attribut */
+#define LISTE_VALEUR  1                /* valeur du point */
+#define LISTE_VOISINS 2                /* nombre de voisins non nuls du point */
+
+extern void writelistimage(
+  struct xvimage * image,
+  char *filename,
+  int32_t ascii,
+  int32_t attr
+);
+
+extern struct xvimage * readlistimage(
+  char *filename,
+  struct xvimage **attr,
+  int32_t *a
+);
+
 extern void writeascimage(
   struct xvimage * image,
   char *filename
@@ -40,6 +40,33 @@ typedef struct {
   int32_t Pts[1];
 } Lifo;
 
+/* listes extensibles : la capacite double quand elle est atteinte */
+
+typedef struct {
+  int64_t Max;          /* capacite courante */
+  int64_t Sp;           /* index de pile (pointe la 1ere case libre) */
+  int64_t *Pts;
+} Pile;
+
+typedef struct {
+  int64_t Max;          /* capacite courante (puissance de 2, 0 si non allouee) */
+  int64_t In;           /* nombre d'elements entres depuis la creation */
+  int64_t Out;          /* nombre d'elements sortis depuis la creation */
+  int64_t *Pts;         /* tampon circulaire : l'element k est Pts[k & (Max-1)] */
+} File;
+
+typedef struct {
+  int32_t NbNiv;        /* nombre de niveaux (priorites 0 a NbNiv-1) */
+  int32_t Niv;          /* aucun element n'a un niveau inferieur a Niv */
+  int64_t Nb;           /* nombre d'elements */
+  File *F;              /* une file par niveau */
+} Seaux;
+
+typedef struct {
+  int32_t Nb;           /* nombre de piles (une par thread) */
+  Pile **P;
+} Piles;
+
 /* ============== */
 /* prototypes     */
 /* ============== */
@@ -80,3 +107,33 @@ extern void LifoPrintLine(
 extern void LifoTermine(
   Lifo * L
 );
+
+extern Pile * CreePile(int64_t taille);
+extern void PileFlush(Pile * P);
+extern int32_t PileVide(Pile * P);
+extern int64_t PileTaille(Pile * P);
+extern void PilePush(Pile * P, int64_t V);
+extern int64_t PilePop(Pile * P);
+extern void PilePushN(Pile * P, int64_t *V, int64_t n);
+extern int64_t PilePopN(Pile * P, int64_t *V, int64_t n);
+extern void PileTermine(Pile * P);
+
+extern File * CreeFile(int64_t taille);
+extern void FileFlush(File * F);
+extern int32_t FileVide(File * F);
+extern int64_t FileTaille(File * F);
+extern void FilePush(File * F, int64_t V);
+extern int64_t FilePop(File * F);
+extern void FilePushN(File * F, int64_t *V, int64_t n);
+extern int64_t FilePopN(File * F, int64_t *V, int64_t n);
+extern void FileTermine(File * F);
+
+extern Seaux * CreeSeaux(int32_t nbniv);
+extern int32_t SeauxVide(Seaux * B);
+extern void SeauxPush(Seaux * B, int32_t niv, int64_t V);
+extern int64_t SeauxPop(Seaux * B, int32_t *niv);
+extern void SeauxTermine(Seaux * B);
+
+extern Piles * CreePiles(int32_t nb, int64_t taille);
+extern void PilesVerse(Piles * L, Pile * P);
+extern void PilesTermine(Piles * L);
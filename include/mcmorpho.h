@@ -0,0 +1,58 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* images binaires 0/1 en octets (F et R distincts) ; retournent 0 si le 
+   tampon de travail (8, 18, 26) ne peut etre alloue */
+extern int32_t morpho_dil4(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs);
+extern int32_t morpho_ero4(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs);
+extern int32_t morpho_dil8(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs);
+extern int32_t morpho_ero8(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs);
+extern int32_t morpho_dil6(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern int32_t morpho_ero6(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern int32_t morpho_dil18(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern int32_t morpho_ero18(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern int32_t morpho_dil26(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern int32_t morpho_ero26(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds);
+/* plans de bits : (cs+2) lignes de (rs+63)/64+2 mots, bords nuls (cf. lskelMK2b) */
+extern void morpho_dil4b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs);
+extern void morpho_ero4b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs);
+extern void morpho_dil8b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs);
+extern void morpho_ero8b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs);
+/* volumes de bits : (ds+2) plans comme ci-dessus, plans de bord nuls */
+extern void morpho_dil6b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern void morpho_ero6b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern void morpho_dil18b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern void morpho_ero18b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern void morpho_dil26b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds);
+extern void morpho_ero26b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds);
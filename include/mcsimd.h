@@ -0,0 +1,54 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* noyaux vectoriels choisis a l'execution (voir mcsimd.c) */
+
+#define MC_ISA_PORTABLE 0
+#define MC_ISA_SSE2     1
+#define MC_ISA_AVX2     2
+#define MC_ISA_AVX512   3
+
+extern int32_t mc_isa;                 /* jeu d'instructions retenu */
+extern const char *mc_isa_nom(int32_t isa);
+extern int32_t mc_isa_choix(int32_t isa);
+
+/* bit k a 1 ssi R[k] est non nul (0 <= k < n <= 64) */
+extern uint64_t (*mc_non_nuls64)(uint8_t *R, int32_t n);
+/* r := a et b et c (et non nul) ou a ou b ou c (et nul), octet par octet ; c peut etre r */
+extern void (*mc_combine)(uint8_t *a, uint8_t *b, uint8_t *c, uint8_t *r, int32_t n, int32_t et);
+/* pour S[i] non nul : S[i] := 0 si (S[i] & masque) == valeur, reste sinon ; 
+   retourne 1 si au moins un point a ete mis a 0 */
+extern int32_t (*mc_retire)(uint8_t *S, int32_t n, uint8_t masque, uint8_t valeur, uint8_t reste);
+/* echange les octets des n mots de 16 bits de T */
+extern void (*mc_echange16)(uint16_t *T, int32_t n);
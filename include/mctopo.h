@@ -154,6 +154,7 @@ extern void top8(uint8_t *img, int32_t p, int32_t rs, int32_t N, int32_t *t, int
 extern void top4_l(uint32_t *img, int32_t p, int32_t rs, int32_t N, int32_t *t, int32_t *tb);
 extern void top8_l(uint32_t *img, int32_t p, int32_t rs, int32_t N, int32_t *t, int32_t *tb);
 extern int32_t simple8(uint8_t *img, int32_t p, int32_t rs, int32_t N);
+extern int32_t simple8_nb(uint8_t *img, int32_t p, int32_t rs);
 extern int32_t simple4(uint8_t *img, int32_t p, int32_t rs, int32_t N);
 extern uint8_t mask(uint8_t *img, int32_t p, int32_t rs, int32_t N);
 extern uint8_t maskmm(uint8_t *img, int32_t p, int32_t rs, int32_t N);
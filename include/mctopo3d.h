@@ -125,6 +125,32 @@ extern int32_t simple26(              /* pour un objet en 26-connexite */
   int32_t rs,                      /* taille rangee */
   int32_t ps,                      /* taille plan */
   int32_t N);                      /* taille image */
+extern int32_t simple26_nb(           /* pour un objet en 26-connexite */
+  uint8_t *img,          /* pointeur base image */
+  int32_t p,                       /* index du point */
+  int32_t rs,                      /* taille rangee */
+  int32_t ps);                     /* taille plan */
+extern int32_t simple26_mask(         /* pour un objet en 26-connexite */
+  uint32_t m);                     /* masque 27 bits du voisinage (mask27) */
+extern void top26_mask(
+  uint32_t m,                      /* masque 27 bits du voisinage (mask27) */
+  int32_t *t,
+  int32_t *tb);                    /* resultats */
+extern void nbtopo_mask(
+  uint32_t m,                      /* masque 27 bits du voisinage (mask27) */
+  int32_t *t6,
+  int32_t *t26,
+  int32_t *t6b,
+  int32_t *t26b);                  /* resultats */
+extern void vois27(uint8_t *img, int32_t p, int32_t rs, int32_t ps, uint8_t *v);
+extern void vois27_s(uint16_t *img, int32_t p, int32_t rs, int32_t ps, uint16_t *v);
+extern uint32_t seuil27(uint8_t *v, int32_t h);
+extern uint32_t seuil27_s(uint16_t *v, int32_t h);
+extern uint32_t mask27h(uint8_t *img, int32_t p, int32_t h, int32_t rs, int32_t ps);
+extern uint32_t mask27h_l(uint32_t *img, int32_t p, uint32_t h, int32_t rs, int32_t ps);
+extern int32_t destr27(
+  uint32_t m,                      /* masque de la coupe (seuil27) */
+  int32_t connex);                 /* connexite des minima : 6 ou 26 */
 extern int32_t simple6h(              /* pour un objet en 6-connexite */
   uint8_t *img,          /* pointeur base image */
   int32_t p,                       /* index du point */
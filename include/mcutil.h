@@ -45,6 +45,17 @@ knowledge of the CeCILL license and that you accept its terms.
 /* retourne VRAI si Z est plus proche de A que de B */
 #define PlusProche(Z,A,B) (abs((Z)-(A))<abs((Z)-(B)))
 
+/* publication d'un pointeur partage entre threads (acces atomiques, GCC) :
+   Publie apres l'initialisation de l'objet, LitPublie avant son usage */
+#define LitPublie(X) __atomic_load_n(&(X), __ATOMIC_ACQUIRE)
+#define Publie(X,V) __atomic_store_n(&(X), (V), __ATOMIC_RELEASE)
+
+/* entrees de tables remplies a la demande par plusieurs threads : la valeur
+   ecrite ne depend que de l'entree, l'ordre des acces est indifferent */
+#define LitAtomique(X) __atomic_load_n(&(X), __ATOMIC_RELAXED)
+#define EcritAtomique(X,V) __atomic_store_n(&(X), (V), __ATOMIC_RELAXED)
+#define OuAtomique(X,V) __atomic_fetch_or(&(X), (V), __ATOMIC_RELAXED)
+
 #define TestNonNul(P) {if((P)==NULL){\
 perror("Erreur fatale : memoire insuffisante (malloc)\n");exit(0);}}
 
@@ -0,0 +1,116 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* $Id:  $ */
+/*! \file hthin3d.c
+
+\brief 3D grayscale homotopic thinning
+
+<B>Usage:</B> hthin3d in.pgm connex niter [cond.pgm] out.pgm
+
+<B>Description:</B>
+Grayscale homotopic thinning of the 3D image \b in.pgm: each destructible
+point (a point that is simple for the cut at its own level, for minima
+in \b connex-connectivity, 6 or 26) is lowered as much as possible 
+without changing the topology of any cut, until stability if \b niter 
+equals -1, or during \b niter iterations otherwise. The points of the
+image border are left unchanged.
+
+If the parameter \b cond.pgm is given, no point p is lowered below the
+value of p in \b cond.pgm.
+
+The topological tests are made on the 27-bit mask of each cut, obtained
+by a single vector comparison of the neighbourhood against the cut level,
+and answered by lookup tables (see mctopo3d).
+
+<B>Types supported:</B> byte 3d, short 3d
+
+<B>Category:</B> topogray
+\ingroup  topogray
+
+\author Michel Couprie
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <lhthin3d.h>
+
+/* =============================================================== */
+int32_t main(argc, argv) 
+/* =============================================================== */
+  int32_t argc; char **argv; 
+{
+  struct xvimage * image;
+  struct xvimage * cond = NULL;
+  int32_t connex, niter;
+
+  if ((argc != 5) && (argc != 6))
+  {
+    fprintf(stderr, "usage: %s in.pgm connex niter [cond.pgm] out.pgm\n", argv[0]);
+    exit(1);
+  }
+
+  image = readimage(argv[1]);
+  if (image == NULL)
+  {
+    fprintf(stderr, "%s: readimage failed\n", argv[0]);
+    exit(1);
+  }
+  connex = atoi(argv[2]);
+  niter = atoi(argv[3]);
+  if (argc == 6)
+  {
+    cond = readimage(argv[4]);
+    if (cond == NULL)
+    {
+      fprintf(stderr, "%s: readimage failed\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  if (! lhthin3d(image, cond, connex, niter))
+  {
+    fprintf(stderr, "%s: lhthin3d failed\n", argv[0]);
+    exit(1);
+  }
+
+  writeimage(image, argv[argc-1]);
+  freeimage(image);
+  if (cond != NULL) freeimage(cond);
+
+  return 0;
+} /* main */
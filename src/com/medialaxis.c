@@ -0,0 +1,148 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* $Id:  $ */
+/*! \file medialaxis.c
+
+\brief Euclidean medial axis, squared Euclidean distance map
+
+<B>Usage:</B> medialaxis [-d] [-j n] in.pgm out.pgm
+
+<B>Description:</B>
+Computes the exact squared Euclidean distance from each object point of 
+the binary image \b in.pgm to the nearest background point (points 
+outside the image are considered as background), in linear time 
+(algorithm of Meijster, Roerdink and Hesselink).
+
+By default, the result is the set of the object points whose Euclidean 
+ball (with radius the distance) is not included in the ball of one of 
+their 8 (2D) or 26 (3D) neighbours. This set contains the centers of the
+maximal balls of the object; it can be given as the \b inhibit parameter
+of skel_NK2 or skel_AK2 (2D) or of lskelAK3 (3D), which then keep all 
+its points.
+
+With option \b -d, the result is the squared distance map (int32_t image).
+
+With option \b -j, the computation is shared between \b n threads (only
+when the program is compiled with OpenMP; otherwise the option is ignored).
+
+Reference:
+A. Meijster, J.B.T.M. Roerdink and W.H. Hesselink,
+"A general algorithm for computing distance transforms in linear time",
+<I>Mathematical Morphology and its Applications to Image and Signal 
+Processing</I>, pp. 331-340, 2000.
+
+<B>Types supported:</B> byte 2d, byte 3d
+
+<B>Category:</B> morpho
+\ingroup  morpho
+
+\author Michel Couprie
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <mcdist.h>
+
+/* =============================================================== */
+int32_t main(argc, argv) 
+/* =============================================================== */
+  int32_t argc; char **argv; 
+{
+  struct xvimage * image;
+  struct xvimage * result;
+  int32_t dist = 0;
+  int32_t nthreads = 0;
+  char *prog = argv[0];
+
+  while ((argc > 2) && (argv[1][0] == '-'))
+  {
+    if (strcmp(argv[1], "-d") == 0) { dist = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-j") == 0) { nthreads = atoi(argv[2]); argc -= 2; argv += 2; }
+    else break;
+  }
+  argv[0] = prog;
+#ifdef _OPENMP
+  if (nthreads > 0) omp_set_num_threads(nthreads);
+#endif
+
+  if (argc != 3)
+  {
+    fprintf(stderr, "usage: %s [-d] [-j n] in.pgm out.pgm\n", argv[0]);
+    exit(1);
+  }
+
+  image = readimage(argv[1]);
+  if (image == NULL)
+  {
+    fprintf(stderr, "%s: readimage failed\n", argv[0]);
+    exit(1);
+  }
+
+  if (dist)
+  {
+    result = allocimage(NULL, rowsize(image), colsize(image), depth(image), VFF_TYP_4_BYTE);
+    if (result == NULL)
+    {
+      fprintf(stderr, "%s: allocimage failed\n", argv[0]);
+      exit(1);
+    }
+    if (! ldistquad(image, result))
+    {
+      fprintf(stderr, "%s: ldistquad failed\n", argv[0]);
+      exit(1);
+    }
+    writeimage(result, argv[argc-1]);
+    freeimage(result);
+  }
+  else
+  {
+    if (! lmedialaxis(image, image))
+    {
+      fprintf(stderr, "%s: lmedialaxis failed\n", argv[0]);
+      exit(1);
+    }
+    writeimage(image, argv[argc-1]);
+  }
+  freeimage(image);
+
+  return 0;
+} /* main */
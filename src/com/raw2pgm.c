@@ -72,6 +72,7 @@ Parameters:
 #include <mcimage.h>
 #include <mccodimage.h>
 #include <mcutil.h>
+#include <mcsimd.h>
 
 #define VERBOSE
 
@@ -83,8 +84,7 @@ int32_t main(argc, argv)
   FILE *fd = NULL;
   int32_t rs, cs, ds, N, nbytesperpix, headersize, littleendian;
   struct xvimage * image;
-  uint16_t tmp;
-  uint8_t tmp1;
+  uint16_t * T;
   uint32_t * I;
   int32_t i;
 
@@ -143,18 +143,16 @@ int32_t main(argc, argv)
     fread(UCHARDATA(image), sizeof(char), headersize, fd);
     // sera ecrase par la suite - attention: plante si la taille image est
     // < headersize
-    I = ULONGDATA(image);
-    for (i = 0; i < N; i++) 
-    { 
-      fread(&tmp, 2 * sizeof(char), 1, fd);
-      if (littleendian)
-      {
-        tmp1 = tmp & 0x00ff;
-        tmp = tmp >> 8;
-        tmp = tmp | (((uint32_t)tmp1) << 8);      
-      }
-      I[i] = (uint32_t)tmp; 
+    T = (uint16_t *)calloc(N, sizeof(uint16_t));
+    if (T == NULL)
+    {   fprintf(stderr,"%s : malloc failed\n", argv[0]);
+        exit(1);
     }
+    fread(T, 2 * sizeof(char), N, fd);
+    if (littleendian) mc_echange16(T, N);
+    I = ULONGDATA(image);
+    for (i = 0; i < N; i++) I[i] = (uint32_t)T[i];
+    free(T);
   }
   else if (nbytesperpix == 4)
   {
@@ -37,7 +37,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 \brief parallel 2D binary curvilinear skeleton
 
-<B>Usage:</B> skel_AK2 in.pgm nsteps [inhibit] out.pgm
+<B>Usage:</B> skel_AK2 [-b] [-s] [-j n] [-g graph] in.pgm nsteps [inhibit] out.pgm
 
 <B>Description:</B>
 Parallel 2D binary thinning or curvilinear skeleton. The parameter \b nsteps gives,
@@ -48,13 +48,32 @@ until stability.
 If the parameter \b inhibit is given and is a binary image name,
 then the points of this image will be left unchanged. 
 
+With option \b -b, the sets are stored as bit planes (64 pixels per 
+machine word) and each step is computed with logical operations on whole 
+words. The result is the same, with a much smaller memory footprint and 
+running time for large images.
+
+With option \b -j, the computation of each step is shared between \b n 
+threads, each one processing a band of rows (only when the program is 
+compiled with OpenMP; otherwise the option is ignored).
+
+With option \b -s, the input image (and the inhibit image) may be 3D: 
+the 2D algorithm is then applied independently to each plane z = constant,
+the planes being processed in parallel, and the result is a 3D image.
+
+With option \b -g \b graph (2D only), the graph of the skeleton is also 
+written in file \b graph (see lskelgraph): one vertex per end point, 
+isolated point or junction (cluster of adjacent points that are not 
+curve points, see curve8), and one arc per branch with its number of 
+points and its Euclidean length.
+
 Reference:
 G. Bertrand and M. Couprie,
 "Two-dimensional thinning algorithms based on critical kernels", 
 <I> Journal of Mathematical Imaging and Vision</I>, submitted, 2006.
 <A HREF="http://igm.univ-mlv.fr/LabInfo/rapportsInternes/2006/02.pdf">Preprint: IGM2006-02</A>.
 
-<B>Types supported:</B> byte 2d
+<B>Types supported:</B> byte 2d, byte 3d (option -s)
 
 <B>Category:</B> topobin
 \ingroup  topobin
@@ -65,9 +84,14 @@ G. Bertrand and M. Couprie,
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <mccodimage.h>
 #include <mcimage.h>
 #include <lskelpar.h>
+#include <lskelgraph.h>
 
 /* =============================================================== */
 int32_t main(argc, argv) 
@@ -78,10 +102,28 @@ int32_t main(argc, argv)
   struct xvimage * inhibit = NULL;
   int32_t ret, nsteps;
   int32_t filter = 0;
+  int32_t bits = 0;
+  int32_t nthreads = 0;
+  int32_t stack = 0;
+  char *graphname = NULL;
+  char *prog = argv[0];
+
+  while ((argc > 2) && (argv[1][0] == '-'))
+  {
+    if (strcmp(argv[1], "-b") == 0) { bits = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-s") == 0) { stack = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-j") == 0) { nthreads = atoi(argv[2]); argc -= 2; argv += 2; }
+    else if (strcmp(argv[1], "-g") == 0) { graphname = argv[2]; argc -= 2; argv += 2; }
+    else break;
+  }
+  argv[0] = prog;
+#ifdef _OPENMP
+  if (nthreads > 0) omp_set_num_threads(nthreads);
+#endif
 
   if ((argc != 4) && (argc != 5))
   {
-    fprintf(stderr, "usage: %s in.pgm nsteps [inhibit] out.pgm\n", argv[0]);
+    fprintf(stderr, "usage: %s [-b] [-s] [-j n] [-g graph] in.pgm nsteps [inhibit] out.pgm\n", argv[0]);
     exit(1);
   }
 
@@ -105,19 +147,39 @@ int32_t main(argc, argv)
 
   if (depth(image) == 1)
   {
-    if (! lskelAK2(image, nsteps, inhibit))
+    if (bits) ret = lskelAK2b(image, nsteps, inhibit);
+    else ret = lskelAK2(image, nsteps, inhibit);
+    if (! ret)
     {
       fprintf(stderr, "%s: lskelAK2 failed\n", argv[0]);
       exit(1);
     } 
   }
+  else if (stack && (graphname == NULL))
+  {
+    if (! lskelstack(bits ? lskelAK2b : lskelAK2, image, nsteps, inhibit))
+    {
+      fprintf(stderr, "%s: lskelstack failed\n", argv[0]);
+      exit(1);
+    }
+  }
   else
   {
-    fprintf(stderr, "%s: image must be 2D\n", argv[0]);
+    fprintf(stderr, "%s: image must be 2D (see option -s, not compatible with -g)\n", argv[0]);
     exit(1);
   }
 
   writeimage(image, argv[argc-1]);
+  if (graphname != NULL)
+  {
+    skelgraphe *g = lskelgraph(image, 8);
+    if ((g == NULL) || ! writeskelgraph(g, graphname))
+    {
+      fprintf(stderr, "%s: lskelgraph failed\n", argv[0]);
+      exit(1);
+    }
+    freeskelgraph(g);
+  }
   freeimage(image);
 
   return 0;
@@ -0,0 +1,126 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* $Id:  $ */
+/*! \file skel_CK3inc.c
+
+\brief incremental parallel 3D binary curvilinear skeleton
+
+<B>Usage:</B> skel_CK3inc in.pgm previous.pgm map.pgm [inhibit] out.pgm outmap.pgm
+
+<B>Description:</B>
+Computes the same result as <B>skel_CK3 -m outmap.pgm in.pgm -1 [inhibit] out.pgm</B>,
+when the image \b in.pgm differs from \b previous.pgm only locally, and 
+\b map.pgm is the map of deletion steps of \b previous.pgm 
+(computed by skel_CK3 with option \b -m, or by skel_CK3inc).
+
+Only the points that may be influenced by the modifications are 
+recomputed: at each step, the region where the thinnings of \b previous.pgm 
+and \b in.pgm differ is enlarged by the radius of influence of a step,
+and the computation stops as soon as both thinnings coincide again. 
+If this region becomes too large, the skeleton is computed from scratch.
+
+If the parameter \b inhibit is given and is a binary image name,
+then the points of this image will be left unchanged. It must be the same
+as the one used for computing \b map.pgm.
+
+<B>Types supported:</B> byte 3d
+
+<B>Category:</B> topobin
+\ingroup  topobin
+
+\author Michel Couprie
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <lskelpar3d.h>
+
+/* =============================================================== */
+int32_t main(argc, argv) 
+/* =============================================================== */
+  int32_t argc; char **argv; 
+{
+  struct xvimage * image;
+  struct xvimage * previous;
+  struct xvimage * map;
+  struct xvimage * inhibit = NULL;
+
+  if ((argc != 6) && (argc != 7))
+  {
+    fprintf(stderr, "usage: %s in.pgm previous.pgm map.pgm [inhibit] out.pgm outmap.pgm\n", argv[0]);
+    exit(1);
+  }
+
+  image = readimage(argv[1]);
+  previous = readimage(argv[2]);
+  map = readimage(argv[3]);
+  if ((image == NULL) || (previous == NULL) || (map == NULL))
+  {
+    fprintf(stderr, "%s: readimage failed\n", argv[0]);
+    exit(1);
+  }
+  if (argc == 7)
+  {
+    inhibit = readimage(argv[4]);
+    if (inhibit == NULL)
+    {
+      fprintf(stderr, "%s: readimage failed\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  if (depth(image) == 1)
+  {
+    fprintf(stderr, "%s: image must be 3D\n", argv[0]);
+    exit(1);
+  }
+  if (! lskelCK3inc(image, inhibit, previous, map, NULL))
+  {
+    fprintf(stderr, "%s: lskelCK3inc failed\n", argv[0]);
+    exit(1);
+  } 
+
+  writeimage(image, argv[argc-2]);
+  writeimage(map, argv[argc-1]);
+  freeimage(image);
+  freeimage(previous);
+  freeimage(map);
+  if (inhibit) freeimage(inhibit);
+
+  return 0;
+} /* main */
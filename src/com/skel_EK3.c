@@ -37,7 +37,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 \brief parallel 3D binary curvilinear skeleton based on ends
 
-<B>Usage:</B> skel_EK3 in.pgm nsteps [inhibit] out.pgm
+<B>Usage:</B> skel_EK3 [-q] [-l|-L [-n]] [-c ckpt [-k nsteps] [-t nsecs]] [-r ckpt] [-g graph] in.pgm nsteps [inhibit] out.pgm
 
 <B>Description:</B>
 Parallel 3D binary thinning or curvilinear skeleton based on ends. 
@@ -49,6 +49,36 @@ until stability.
 If the parameter \b inhibit is given and is a binary image name,
 then the points of this image will be left unchanged. 
 
+Options \b -c, \b -k, \b -t and \b -r allow long runs to be interrupted
+and resumed. With \b -c \b ckpt, the state of the algorithm (current set,
+step number and, if needed, the inhibit image) is saved in file \b ckpt 
+every \b -k steps and/or every \b -t seconds (default: every 600 seconds).
+With \b -r \b ckpt, the algorithm resumes from the state saved in \b ckpt 
+instead of starting from scratch; \b in.pgm must be the original image and 
+\b nsteps counts the steps done before the interruption.
+
+With option \b -q, a sequential thinning guided by the Euclidean 
+distance map is used instead (see lskelseq3): the simple points are 
+removed one at a time, by increasing distance to the background, the end points being kept. 
+The result is not symmetric, but it is obtained in a time roughly 
+proportional to the number of object points, which is much faster for 
+thick objects. The parameter \b nsteps then bounds the distance of the
+removed points (-1: no bound), and the checkpoint options are ignored.
+
+With option \b -l (binary) or \b -L (text), \b out.pgm is written as 
+the sorted list of the skeleton points instead of the whole volume (see
+writelistimage): a few kilobytes for a skeleton, which readimage turns
+back into the binary image. With option \b -n, each point of the list 
+carries the number of its 26-neighbours in the skeleton (1 for an end
+point, 3 or more for a junction).
+
+With option \b -g \b graph, the graph of the skeleton is also written in
+file \b graph (see lskelgraph): one vertex per end point, isolated point
+or junction (cluster of adjacent points that are not curve points, see 
+curve26), and one arc per branch with its number of points and its
+Euclidean length. The graph is computed directly from the result in 
+memory, after thinning its parts that are 2 points thick.
+
 <B>Types supported:</B> byte 3d
 
 <B>Category:</B> topobin
@@ -60,9 +90,11 @@ then the points of this image will be left unchanged.
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mccodimage.h>
 #include <mcimage.h>
 #include <lskelpar3d.h>
+#include <lskelgraph.h>
 
 /* =============================================================== */
 int32_t main(argc, argv) 
@@ -73,10 +105,31 @@ int32_t main(argc, argv)
   struct xvimage * inhibit = NULL;
   int32_t ret, nsteps;
   int32_t filter = 0;
+  char *ckpt = NULL, *resume = NULL;
+  int32_t ckptsteps = 0, ckptsecs = 0;
+  int32_t seq = 0;
+  int32_t liste = 0, voisins = 0;
+  char *graphname = NULL;
+  char *prog = argv[0];
+
+  while ((argc > 2) && (argv[1][0] == '-'))
+  {
+    if (strcmp(argv[1], "-q") == 0) { seq = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-l") == 0) { liste = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-L") == 0) { liste = 2; argc--; argv++; }
+    else if (strcmp(argv[1], "-n") == 0) { voisins = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-c") == 0) { ckpt = argv[2]; argc -= 2; argv += 2; }
+    else if (strcmp(argv[1], "-k") == 0) { ckptsteps = atoi(argv[2]); argc -= 2; argv += 2; }
+    else if (strcmp(argv[1], "-t") == 0) { ckptsecs = atoi(argv[2]); argc -= 2; argv += 2; }
+    else if (strcmp(argv[1], "-r") == 0) { resume = argv[2]; argc -= 2; argv += 2; }
+    else if (strcmp(argv[1], "-g") == 0) { graphname = argv[2]; argc -= 2; argv += 2; }
+    else break;
+  }
+  argv[0] = prog;
 
   if ((argc != 4) && (argc != 5))
   {
-    fprintf(stderr, "usage: %s in.pgm nsteps [inhibit] out.pgm\n", argv[0]);
+    fprintf(stderr, "usage: %s [-q] [-l|-L [-n]] [-c ckpt [-k nsteps] [-t nsecs]] [-r ckpt] [-g graph] in.pgm nsteps [inhibit] out.pgm\n", argv[0]);
     exit(1);
   }
 
@@ -98,9 +151,15 @@ int32_t main(argc, argv)
     }
   }
 
+  if (ckpt != NULL) 
+    lskel3d_checkpoint(ckpt, ckptsteps, (ckptsteps || ckptsecs) ? ckptsecs : 600);
+  if (resume != NULL) lskel3d_resume(resume);
+
   if (depth(image) != 1)
   {
-    if (! lskelEK3(image, nsteps, inhibit))
+    if (seq) ret = lskelseq3(image, nsteps, inhibit, LSKEL_EK3);
+    else ret = lskelEK3(image, nsteps, inhibit);
+    if (! ret)
     {
       fprintf(stderr, "%s: lskelEK3 failed\n", argv[0]);
       exit(1);
@@ -112,7 +171,20 @@ int32_t main(argc, argv)
     exit(1);
   }
 
-  writeimage(image, argv[argc-1]);
+  if (liste) 
+    writelistimage(image, argv[argc-1], liste == 2, voisins ? LISTE_VOISINS : LISTE_SANS);
+  else
+    writeimage(image, argv[argc-1]);
+  if (graphname != NULL)
+  {
+    skelgraphe *g = lskelgraph(image, 26);
+    if ((g == NULL) || ! writeskelgraph(g, graphname))
+    {
+      fprintf(stderr, "%s: lskelgraph failed\n", argv[0]);
+      exit(1);
+    }
+    freeskelgraph(g);
+  }
   freeimage(image);
 
   return 0;
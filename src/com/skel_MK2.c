@@ -37,7 +37,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 \brief parallel 2D binary ultimate skeleton
 
-<B>Usage:</B> skel_MK2 in.pgm nsteps [inhibit] out.pgm
+<B>Usage:</B> skel_MK2 [-q] [-b] [-s] [-j n] in.pgm nsteps [inhibit] out.pgm
 
 <B>Description:</B>
 Parallel 2D binary thinning or ultimate skeleton. The parameter \b nsteps gives,
@@ -48,13 +48,34 @@ until stability.
 If the parameter \b inhibit is given and is a binary image name,
 then the points of this image will be left unchanged. 
 
+With option \b -b, the sets are stored as bit planes (64 pixels per 
+machine word) and each step is computed with logical operations on whole 
+words. The result is the same, with a much smaller memory footprint and 
+running time for large images.
+
+With option \b -j, the computation of each step is shared between \b n 
+threads, each one processing a band of rows (only when the program is 
+compiled with OpenMP; otherwise the option is ignored).
+
+With option \b -s, the input image (and the inhibit image) may be 3D: 
+the 2D algorithm is then applied independently to each plane z = constant,
+the planes being processed in parallel, and the result is a 3D image.
+
 Reference:
 G. Bertrand and M. Couprie,
 "Two-dimensional thinning algorithms based on critical kernels", 
 <I> Journal of Mathematical Imaging and Vision</I>, submitted, 2006.
 <A HREF="http://igm.univ-mlv.fr/LabInfo/rapportsInternes/2006/02.pdf">Preprint: IGM2006-02</A>.
 
-<B>Types supported:</B> byte 2d
+With option \b -q, a sequential thinning guided by the Euclidean 
+distance map is used instead (see lskelseq2): the simple points are 
+removed one at a time, by increasing distance to the background, until stability. 
+The result is not symmetric, but it is obtained in a time roughly 
+proportional to the number of object points, which is much faster for 
+thick objects. The parameter \b nsteps then bounds the distance of the
+removed points (-1: no bound). Options \b -b and \b -j are ignored.
+
+<B>Types supported:</B> byte 2d, byte 3d (option -s)
 
 <B>Category:</B> topobin
 \ingroup  topobin
@@ -65,10 +86,21 @@ G. Bertrand and M. Couprie,
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <mccodimage.h>
 #include <mcimage.h>
 #include <lskelpar.h>
 
+/* =============================================================== */
+static int32_t seq2(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* =============================================================== */
+{
+  return lskelseq2(image, nsteps, inhibit, LSKEL_MK2);
+} /* seq2() */
+
 /* =============================================================== */
 int32_t main(argc, argv) 
 /* =============================================================== */
@@ -78,10 +110,28 @@ int32_t main(argc, argv)
   struct xvimage * inhibit = NULL;
   int32_t ret, nsteps;
   int32_t filter = 0;
+  int32_t bits = 0;
+  int32_t nthreads = 0;
+  int32_t stack = 0;
+  int32_t seq = 0;
+  char *prog = argv[0];
+
+  while ((argc > 2) && (argv[1][0] == '-'))
+  {
+    if (strcmp(argv[1], "-q") == 0) { seq = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-b") == 0) { bits = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-s") == 0) { stack = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-j") == 0) { nthreads = atoi(argv[2]); argc -= 2; argv += 2; }
+    else break;
+  }
+  argv[0] = prog;
+#ifdef _OPENMP
+  if (nthreads > 0) omp_set_num_threads(nthreads);
+#endif
 
   if ((argc != 4) && (argc != 5))
   {
-    fprintf(stderr, "usage: %s in.pgm nsteps [inhibit] out.pgm\n", argv[0]);
+    fprintf(stderr, "usage: %s [-q] [-b] [-s] [-j n] in.pgm nsteps [inhibit] out.pgm\n", argv[0]);
     exit(1);
   }
 
@@ -105,15 +155,26 @@ int32_t main(argc, argv)
 
   if (depth(image) == 1)
   {
-    if (! lskelMK2(image, nsteps, inhibit))
+    if (seq) ret = lskelseq2(image, nsteps, inhibit, LSKEL_MK2);
+    else if (bits) ret = lskelMK2b(image, nsteps, inhibit);
+    else ret = lskelMK2(image, nsteps, inhibit);
+    if (! ret)
     {
       fprintf(stderr, "%s: lskelMK2 failed\n", argv[0]);
       exit(1);
     } 
   }
+  else if (stack)
+  {
+    if (! lskelstack(seq ? seq2 : bits ? lskelMK2b : lskelMK2, image, nsteps, inhibit))
+    {
+      fprintf(stderr, "%s: lskelstack failed\n", argv[0]);
+      exit(1);
+    }
+  }
   else
   {
-    fprintf(stderr, "%s: image must be 2D\n", argv[0]);
+    fprintf(stderr, "%s: image must be 2D (see option -s)\n", argv[0]);
     exit(1);
   }
 
@@ -0,0 +1,163 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* $Id:  $ */
+/*! \file skel_multi3d.c
+
+\brief several parallel 3D binary skeletons of the same image
+
+<B>Usage:</B> skel_multi3d in.pgm nsteps [inhibit] algo out.pgm [algo out.pgm ...]
+
+<B>Description:</B>
+Computes, for the same input image, the result of several 3D parallel
+thinning algorithms. Each pair \b algo \b out.pgm selects an algorithm
+among \b MK3 (see skel_MK3), \b CK3 (see skel_CK3) and \b EK3 (see skel_EK3)
+and the name of the file where its result is written.
+
+The result for each algorithm is the same as the one given by the
+corresponding program, but the input images are read only once, and the
+classification of simple points is shared between the algorithms for 
+the parts of the image where their current states coincide.
+When compiled with OpenMP, the algorithms run concurrently.
+
+The parameter \b nsteps gives,
+if positive, the number of parallel thinning steps to be processed.
+If the value given for \b nsteps equals -1, the thinning is continued
+until stability.
+
+If the parameter \b inhibit is given and is a binary image name,
+then the points of this image will be left unchanged. 
+
+<B>Types supported:</B> byte 3d
+
+<B>Category:</B> topobin
+\ingroup  topobin
+
+\author Michel Couprie
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <lskelpar3d.h>
+
+/* =============================================================== */
+int32_t main(argc, argv) 
+/* =============================================================== */
+  int32_t argc; char **argv; 
+{
+  struct xvimage * image;
+  struct xvimage * inhibit = NULL;
+  struct xvimage ** result;
+  int32_t nsteps, nalgo, first, a;
+  int32_t * algo;
+
+  if (argc < 5)
+  {
+    fprintf(stderr, "usage: %s in.pgm nsteps [inhibit] algo out.pgm [algo out.pgm ...]\n", argv[0]);
+    fprintf(stderr, "       algo in: MK3, CK3, EK3\n");
+    exit(1);
+  }
+
+  image = readimage(argv[1]);
+  if (image == NULL)
+  {
+    fprintf(stderr, "%s: readimage failed\n", argv[0]);
+    exit(1);
+  }
+
+  nsteps = atoi(argv[2]);
+  first = 3;
+  if ((argc - first) % 2) // nombre impair : image d'inhibition
+  {
+    inhibit = readimage(argv[first]);
+    if (inhibit == NULL)
+    {
+      fprintf(stderr, "%s: readimage failed\n", argv[0]);
+      exit(1);
+    }
+    first++;
+  }
+  nalgo = (argc - first) / 2;
+  if (nalgo < 1)
+  {
+    fprintf(stderr, "usage: %s in.pgm nsteps [inhibit] algo out.pgm [algo out.pgm ...]\n", argv[0]);
+    exit(1);
+  }
+
+  algo = (int32_t *)calloc(nalgo, sizeof(int32_t));
+  result = (struct xvimage **)calloc(nalgo, sizeof(struct xvimage *));
+  if ((algo == NULL) || (result == NULL))
+  {
+    fprintf(stderr, "%s: malloc failed\n", argv[0]);
+    exit(1);
+  }
+  for (a = 0; a < nalgo; a++)
+  {
+    char *name = argv[first + 2 * a];
+    if (strcmp(name, "MK3") == 0) algo[a] = LSKEL_MK3; else
+    if (strcmp(name, "CK3") == 0) algo[a] = LSKEL_CK3; else
+    if (strcmp(name, "EK3") == 0) algo[a] = LSKEL_EK3; else
+    {
+      fprintf(stderr, "%s: bad algorithm: %s\n", argv[0], name);
+      exit(1);
+    }
+  }
+
+  if (depth(image) == 1)
+  {
+    fprintf(stderr, "%s: image must be 3D\n", argv[0]);
+    exit(1);
+  }
+  if (! lskelmulti3d(image, nsteps, inhibit, nalgo, algo, result))
+  {
+    fprintf(stderr, "%s: lskelmulti3d failed\n", argv[0]);
+    exit(1);
+  } 
+
+  for (a = 0; a < nalgo; a++)
+  {
+    writeimage(result[a], argv[first + 2 * a + 1]);
+    freeimage(result[a]);
+  }
+  freeimage(image);
+  if (inhibit) freeimage(inhibit);
+  free(algo);
+  free(result);
+
+  return 0;
+} /* main */
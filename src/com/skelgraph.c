@@ -0,0 +1,125 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* $Id:  $ */
+/*! \file skelgraph.c
+
+\brief graph of a curvilinear skeleton (vertices, branches, lengths)
+
+<B>Usage:</B> skelgraph in.pgm connex out.graph
+
+<B>Description:</B>
+Computes the graph of the binary curvilinear skeleton \b in.pgm (for 
+example the result of skel_CK3, skel_EK3 or skel_AK2, possibly written 
+as a point list), with the connectivity \b connex (26 in 3D, 8 or 26 in
+2D). The parts of the skeleton that are 2 points thick, as left by the
+parallel algorithms, are first thinned: the simple points that are not
+end points are removed one at a time, by directional passes, which 
+preserves the topology and the end points (the input image is not 
+modified). A branch point then has exactly 2 neighbours, lying in 2 distinct 
+connected components of its neighbourhood (topological number T equal to
+2, see curve8 and curve26). The other points are grouped into clusters 
+of adjacent points, and each cluster is a vertex whose type is given by
+its degree: isolated (0), end (1) or junction (3 or more); a cluster of
+degree 2 is a thick part of a branch and is merged into it. A point is 
+chosen as a vertex on each closed curve without other vertex. Each
+branch gives an arc between the vertices it links, with its number of 
+points and its Euclidean length (sum of the steps 1, sqrt(2) and 
+sqrt(3)); a branch coming back to its starting vertex is kept only if it
+closes a curve.
+
+The graph is written in text form in \b out.graph: a line "SKELGRAPH rs
+cs ds", a line with the numbers of vertices and arcs, then one line per 
+vertex (number, type: 0 isolated, 1 end, 2 closed curve, 3 junction, 
+number of points, degree, coordinates x y z of the barycenter) and one 
+line per arc (number, origin, end, number of points, length).
+
+The skeleton commands skel_CK3, skel_EK3 and skel_AK2 can also write 
+this graph directly (option \b -g).
+
+<B>Types supported:</B> byte 2d, byte 3d
+
+<B>Category:</B> topobin
+\ingroup  topobin
+
+\author Michel Couprie
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <lskelgraph.h>
+
+/* =============================================================== */
+int32_t main(argc, argv) 
+/* =============================================================== */
+  int32_t argc; char **argv; 
+{
+  struct xvimage * image;
+  skelgraphe * g;
+  int32_t connex;
+
+  if (argc != 4)
+  {
+    fprintf(stderr, "usage: %s in.pgm connex out.graph\n", argv[0]);
+    exit(1);
+  }
+
+  image = readimage(argv[1]);
+  if (image == NULL)
+  {
+    fprintf(stderr, "%s: readimage failed\n", argv[0]);
+    exit(1);
+  }
+
+  connex = atoi(argv[2]);
+  g = lskelgraph(image, connex);
+  if (g == NULL)
+  {
+    fprintf(stderr, "%s: lskelgraph failed\n", argv[0]);
+    exit(1);
+  }
+  if (! writeskelgraph(g, argv[argc-1]))
+  {
+    fprintf(stderr, "%s: writeskelgraph failed\n", argv[0]);
+    exit(1);
+  }
+  freeskelgraph(g);
+  freeimage(image);
+
+  return 0;
+} /* main */
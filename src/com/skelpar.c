@@ -36,7 +36,7 @@ knowledge of the CeCILL license and that you accept its terms.
 
 \brief parallel binary skeleton
 
-<B>Usage:</B> skelpar in.pgm algorithm nsteps [inhibit] out.pgm
+<B>Usage:</B> skelpar [-f] [-s] [-j n] in.pgm algorithm nsteps [inhibit] out.pgm
 
 <B>Description:</B>
 Parallel binary thinning or skeleton. The parameter \b nsteps gives,
@@ -75,14 +75,36 @@ The possible choices are:
 If the parameter \b inhibit is given and is a binary image name,
 then the points of this image will be left unchanged. 
 
-<B>Warning:</B> The object must not have any point on the frame of the image.
+For the algorithms whose deletion decision only depends on a 3x3 or 5x5
+neighbourhood (all but 2, 3, 4, 7, 14, 23, 25), the decision is compiled 
+into a lookup table indexed by the neighbourhood configuration, and each 
+step costs one table lookup per object pixel (see lskeltab).
+With option \b -f, these algorithms only examine, at each step, the points
+near a point deleted since their last examination (see lskeltabfront): the
+result is the same, and the cost of a step depends on the number of deleted 
+points instead of the size of the image. This is faster for thin objects
+and for the last steps of the thinning.
+Algorithms 2 and 4 (without inhibit image for 4) are computed on bit 
+planes, 64 pixels per machine word (see lskelMK2b, lskelAK2b).
+
+With option \b -j, the computation of each step is shared between \b n 
+threads, each one processing a band of rows (only when the program is 
+compiled with OpenMP; otherwise the option is ignored).
+
+With option \b -s, the input image (and the inhibit image) may be 3D: 
+the 2D algorithm is then applied independently to each plane z = constant,
+the planes being processed in parallel, and the result is a 3D image.
+
+If the object has points on the frame of the image, the thinning is
+made on a copy of the image surrounded by a null frame, which is removed 
+before the result is written.
 
 References:<BR> 
 [COU05] M. Couprie, Note on fifteen 2D parallel thinning algorithms,
 IGM2006-01}, Universit\'e de Marne-la-Vall\'ee, 2006,
 http://igm.univ-mlv.fr/LabInfo/rapportsInternes/2006/01.pdf<BR>
 
-<B>Types supported:</B> byte 2d
+<B>Types supported:</B> byte 2d, byte 3d (option -s)
 
 <B>Category:</B> topobin
 \ingroup  topobin
@@ -94,230 +116,306 @@ http://igm.univ-mlv.fr/LabInfo/rapportsInternes/2006/01.pdf<BR>
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <mccodimage.h>
 #include <mcimage.h>
 #include <lskelpar.h>
 
+static int32_t mode;
+static int32_t front = 0;
+static char *prog;
+
 /* =============================================================== */
-int main(int argc, char **argv)
+static int32_t skel2d(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
 /* =============================================================== */
+// applies the algorithm given by mode to the 2D image
 {
-  struct xvimage * image;
-  struct xvimage * inhibit = NULL;
-  int32_t mode, nsteps;
-
-  if ((argc != 5) && (argc != 6))
+  if (lskeltab_mode(mode))
   {
-    fprintf(stderr, "usage: %s in.pgm algorithm nsteps [inhibit] out.pgm\n", argv[0]);
-    fprintf(stderr, "  0: Pavlidis 1981\n");
-    fprintf(stderr, "  1: Eckhardt and Maderlechner 1993\n");
-    fprintf(stderr, "  2: Couprie and Bertrand, ultimate (MK2)\n");
-    fprintf(stderr, "  3: Couprie and Bertrand, curvilinear\n");
-    fprintf(stderr, "  4: Couprie and Bertrand, curvilinear with reconstruction property (AK2)\n");
-    fprintf(stderr, "  5: Rutovitz 1966 [DOES NOT PRESERVE TOPOLOGY]\n");
-    fprintf(stderr, "  6: Zhang and Wang 1988 [DOES NOT PRESERVE TOPOLOGY]\n");
-    fprintf(stderr, "  7: Han, La and Rhee\n");
-    fprintf(stderr, "  8: Guo and Hall 1992 (1)\n");
-    fprintf(stderr, "  9: Guo and Hall 1992 (2)\n");
-    fprintf(stderr, "  10: Guo and Hall 1992 (3)\n");
-    fprintf(stderr, "  11: Chin and Wan and Stover and Iverson 1987\n");
-    fprintf(stderr, "  12: Jang and Chin 1992 [DOES NOT PRESERVE TOPOLOGY]\n");
-    fprintf(stderr, "  13: Jang and Chin (correction mc)\n");
-    fprintf(stderr, "  14: MNS preservation\n");
-    fprintf(stderr, "  15: Jang and Chin 1993 (reconstruction)\n");
-    fprintf(stderr, "  16: Choy, Choy and Siu 1995 [DOES NOT PRESERVE TOPOLOGY]\n");
-    fprintf(stderr, "  17: Bernard and Manzanera 1999\n");
-    fprintf(stderr, "  18: Holt et al. 1987\n");
-    fprintf(stderr, "  19: Hall 1989\n");
-    fprintf(stderr, "  20: Wu and Tsai 1992 [DOES NOT PRESERVE TOPOLOGY]\n");
-    fprintf(stderr, "  21: Manzanera and Bernard (variant by GB)\n");
-    fprintf(stderr, "  22: Bertrand curvilinear with reconstruction, asymmetrical\n");
-    fprintf(stderr, "  23: Bertrand curvilinear with reconstruction, symmetrical\n");
-    fprintf(stderr, "  24: Rosenfeld directionnel\n");
-    exit(1);
-  }
-
-  image = readimage(argv[1]);
-  if (image == NULL)
-  {
-    fprintf(stderr, "%s: readimage failed\n", argv[0]);
-    exit(1);
-  }
-
-  mode = atoi(argv[2]);
-  nsteps = atoi(argv[3]);
-
-  if (argc == 6)
-  {
-    inhibit = readimage(argv[4]);
-    if (inhibit == NULL)
+    if (! (front ? lskeltabfront(image, mode, nsteps, inhibit) : lskeltab(image, mode, nsteps, inhibit)))
     {
-      fprintf(stderr, "%s: readimage failed\n", argv[0]);
+      fprintf(stderr, "%s: lskeltab failed\n", prog);
       exit(1);
     }
   }
-
-  if (depth(image) == 1)
+  else
   {
     switch (mode)
     {
     case 0:
       if (! lskelpavlidis(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelpavlidis failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelpavlidis failed\n", prog);
 	exit(1);
       } break;
     case 1:
       if (! lskeleckhardt(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskeleckhardt failed\n", argv[0]);
+	fprintf(stderr, "%s: lskeleckhardt failed\n", prog);
 	exit(1);
       } break;
     case 2:
       //      if (! lskelmcultime(image, nsteps, inhibit))
-      if (! lskelMK2(image, nsteps, inhibit))
+      if (! lskelMK2b(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelMK2 failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelMK2 failed\n", prog);
 	exit(1);
       } break;
     case 3:
       if (! lskelmccurv(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelmccurv failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelmccurv failed\n", prog);
 	exit(1);
       } break;
     case 4:
       //      if (! lskelmccurvrec(image, nsteps, inhibit))
-      if (! lskelAK2(image, nsteps, inhibit))
+      if (! lskelAK2b(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelAK2 failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelAK2 failed\n", prog);
 	exit(1);
       } break;
     case 5:
       if (! lskelrutovitz(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelrutovitz failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelrutovitz failed\n", prog);
 	exit(1);
       } break;
     case 6:
       if (! lskelzhangwang(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelzhangwang failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelzhangwang failed\n", prog);
 	exit(1);
       } break;
     case 7:
       if (! lskelhanlarhee(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelhanlarhee failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelhanlarhee failed\n", prog);
 	exit(1);
       } break;
     case 8:
       if (! lskelguohall(image, nsteps, inhibit, 1))
       {
-	fprintf(stderr, "%s: lskelguohall failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelguohall failed\n", prog);
 	exit(1);
       } break;
     case 9:
       if (! lskelguohall(image, nsteps, inhibit, 2))
       {
-	fprintf(stderr, "%s: lskelguohall failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelguohall failed\n", prog);
 	exit(1);
       } break;
     case 10:
       if (! lskelguohall(image, nsteps, inhibit, 3))
       {
-	fprintf(stderr, "%s: lskelguohall failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelguohall failed\n", prog);
 	exit(1);
       } break;
     case 11:
       if (! lskelchinwan(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelchinwan failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelchinwan failed\n", prog);
 	exit(1);
       } break;
     case 12:
       if (! lskeljang(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskeljang failed\n", argv[0]);
+	fprintf(stderr, "%s: lskeljang failed\n", prog);
 	exit(1);
       } break;
     case 13:
       if (! lskeljangcor(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskeljangcor failed\n", argv[0]);
+	fprintf(stderr, "%s: lskeljangcor failed\n", prog);
 	exit(1);
       } break;
     case 14:
       if (! lskelmns(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelmns failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelmns failed\n", prog);
 	exit(1);
       } break;
     case 16:
       if (! lskelchoy(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelchoy failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelchoy failed\n", prog);
 	exit(1);
       } break;
     case 17:
       if (! lskelmanz(image, nsteps, inhibit, 1))
       {
-	fprintf(stderr, "%s: lskelmanz failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelmanz failed\n", prog);
 	exit(1);
       } break;
     case 18:
       if (! lskelhall(image, nsteps, inhibit, 1))
       {
-	fprintf(stderr, "%s: lskelhall failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelhall failed\n", prog);
 	exit(1);
       } break;
     case 19:
       if (! lskelhall(image, nsteps, inhibit, 2))
       {
-	fprintf(stderr, "%s: lskelhall failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelhall failed\n", prog);
 	exit(1);
       } break;
     case 20:
       if (! lskelwutsai(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelwutsai failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelwutsai failed\n", prog);
 	exit(1);
       } break;
     case 21:
       if (! lskelmanz(image, nsteps, inhibit, 2))
       {
-	fprintf(stderr, "%s: lskelmanz failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelmanz failed\n", prog);
 	exit(1);
       } break;
     case 23:
       if (! lskelbertrand_sym(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelbertrand_sym failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelbertrand_sym failed\n", prog);
 	exit(1);
       } break;
     case 24:
       if (! lskelrosenfeld(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelbertrand_asym_s failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelbertrand_asym_s failed\n", prog);
 	exit(1);
       } break;
     case 25:
       if (! lskelbertrand_asym_s(image, nsteps, inhibit))
       {
-	fprintf(stderr, "%s: lskelbertrand_asym_s failed\n", argv[0]);
+	fprintf(stderr, "%s: lskelbertrand_asym_s failed\n", prog);
 	exit(1);
       } break;
     default: 
-      fprintf(stderr, "%s: mode %d not implemented\n", argv[0], mode);
+      fprintf(stderr, "%s: mode %d not implemented\n", prog, mode);
+      exit(1);
+    }
+  }
+  return 1;
+} /* skel2d() */
+
+/* =============================================================== */
+int main(int argc, char **argv)
+/* =============================================================== */
+{
+  struct xvimage * image;
+  struct xvimage * inhibit = NULL;
+  struct xvimage * orig = NULL;
+  struct xvimage * tmp = NULL;
+  int32_t nsteps;
+  int32_t nthreads = 0;
+  int32_t stack = 0;
+
+  prog = argv[0];
+
+  while ((argc > 2) && (argv[1][0] == '-'))
+  {
+    if (strcmp(argv[1], "-s") == 0) { stack = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-f") == 0) { front = 1; argc--; argv++; }
+    else if (strcmp(argv[1], "-j") == 0) { nthreads = atoi(argv[2]); argc -= 2; argv += 2; }
+    else break;
+  }
+  argv[0] = prog;
+#ifdef _OPENMP
+  if (nthreads > 0) omp_set_num_threads(nthreads);
+#endif
+
+  if ((argc != 5) && (argc != 6))
+  {
+    fprintf(stderr, "usage: %s [-f] [-s] [-j n] in.pgm algorithm nsteps [inhibit] out.pgm\n", argv[0]);
+    fprintf(stderr, "  0: Pavlidis 1981\n");
+    fprintf(stderr, "  1: Eckhardt and Maderlechner 1993\n");
+    fprintf(stderr, "  2: Couprie and Bertrand, ultimate (MK2)\n");
+    fprintf(stderr, "  3: Couprie and Bertrand, curvilinear\n");
+    fprintf(stderr, "  4: Couprie and Bertrand, curvilinear with reconstruction property (AK2)\n");
+    fprintf(stderr, "  5: Rutovitz 1966 [DOES NOT PRESERVE TOPOLOGY]\n");
+    fprintf(stderr, "  6: Zhang and Wang 1988 [DOES NOT PRESERVE TOPOLOGY]\n");
+    fprintf(stderr, "  7: Han, La and Rhee\n");
+    fprintf(stderr, "  8: Guo and Hall 1992 (1)\n");
+    fprintf(stderr, "  9: Guo and Hall 1992 (2)\n");
+    fprintf(stderr, "  10: Guo and Hall 1992 (3)\n");
+    fprintf(stderr, "  11: Chin and Wan and Stover and Iverson 1987\n");
+    fprintf(stderr, "  12: Jang and Chin 1992 [DOES NOT PRESERVE TOPOLOGY]\n");
+    fprintf(stderr, "  13: Jang and Chin (correction mc)\n");
+    fprintf(stderr, "  14: MNS preservation\n");
+    fprintf(stderr, "  15: Jang and Chin 1993 (reconstruction)\n");
+    fprintf(stderr, "  16: Choy, Choy and Siu 1995 [DOES NOT PRESERVE TOPOLOGY]\n");
+    fprintf(stderr, "  17: Bernard and Manzanera 1999\n");
+    fprintf(stderr, "  18: Holt et al. 1987\n");
+    fprintf(stderr, "  19: Hall 1989\n");
+    fprintf(stderr, "  20: Wu and Tsai 1992 [DOES NOT PRESERVE TOPOLOGY]\n");
+    fprintf(stderr, "  21: Manzanera and Bernard (variant by GB)\n");
+    fprintf(stderr, "  22: Bertrand curvilinear with reconstruction, asymmetrical\n");
+    fprintf(stderr, "  23: Bertrand curvilinear with reconstruction, symmetrical\n");
+    fprintf(stderr, "  24: Rosenfeld directionnel\n");
+    exit(1);
+  }
+
+  image = readimage(argv[1]);
+  if (image == NULL)
+  {
+    fprintf(stderr, "%s: readimage failed\n", argv[0]);
+    exit(1);
+  }
+
+  mode = atoi(argv[2]);
+  nsteps = atoi(argv[3]);
+
+  if (argc == 6)
+  {
+    inhibit = readimage(argv[4]);
+    if (inhibit == NULL)
+    {
+      fprintf(stderr, "%s: readimage failed\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  if ((depth(image) == 1) && touchframe(image))
+  { // the algorithms ignore the points of the frame: adds a null frame
+    orig = image;
+    image = addframe(orig);
+    if (inhibit != NULL) 
+    {
+      tmp = inhibit;
+      inhibit = addframe(tmp);
+      freeimage(tmp);
+    }
+    if ((image == NULL) || ((tmp != NULL) && (inhibit == NULL)))
+    {
+      fprintf(stderr, "%s: addframe failed\n", argv[0]);
+      exit(1);
+    }
+  }
+
+  if (depth(image) == 1)
+    skel2d(image, nsteps, inhibit);
+  else if (stack)
+  {
+    if (! lskelstack(skel2d, image, nsteps, inhibit))
+    {
+      fprintf(stderr, "%s: lskelstack failed\n", argv[0]);
       exit(1);
     }
   }
   else
   {
-    fprintf(stderr, "%s: 3D not implemented\n", argv[0]);
+    fprintf(stderr, "%s: 3D not implemented (see option -s)\n", argv[0]);
     exit(1);
   }
 
+  if (orig != NULL)
+  {
+    delframe(orig, image);
+    freeimage(image);
+    image = orig;
+  }
+
   writeimage(image, argv[argc-1]);
   freeimage(image);
 
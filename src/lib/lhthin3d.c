@@ -0,0 +1,198 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Amincissement homotopique en niveaux de gris 3D
+
+   Un point p est destructible (pour des minima 6- ou 26-connexes) si 
+   l'abaisser d'un niveau ne change la topologie d'aucune coupe : il est
+   simple pour la coupe au niveau F[p] (voir pdestr6, pdestr26 dans 
+   mctopo3d). Il peut alors etre abaisse jusqu'a delta-(p), la plus petite
+   valeur atteinte en le descendant de voisin en voisin tant qu'il reste 
+   destructible (voir delta6m, delta26m).
+
+   lhthin3d abaisse les points destructibles jusqu'a stabilite (ou pendant 
+   nitermax iterations). Les points sont traites dans l'ordre d'une file ;
+   quand un point est abaisse, ses voisins sont remis dans la file pour 
+   l'iteration suivante. Les points de bord de l'image ne sont pas traites.
+
+   Pour chaque point, les 27 valeurs du voisinage sont lues une seule fois
+   (vois27) ; chaque coupe est ensuite obtenue par une comparaison 
+   vectorielle (seuil27) et testee par les tables de mctopo3d (destr27), 
+   sans calcul de composantes connexes.
+
+   Si imagecond est donnee, aucun point p n'est abaisse sous imagecond[p].
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <mclifo.h>
+#include <mctopo3d.h>
+#include <lhthin3d.h>
+
+/* ==================================== */
+static int32_t delta_b(uint8_t *F, int32_t p, int32_t rs, int32_t ps, int32_t connex, int32_t min)
+/* ==================================== */
+// valeur a laquelle p peut etre abaisse (pas en dessous de min)
+{
+  uint8_t v[32];
+  int32_t k, a, val = F[p];
+
+  vois27(F, p, rs, ps, v);
+  while ((val > min) && destr27(seuil27(v, val), connex))
+  {
+    for (a = -1, k = 0; k < 27; k++) 
+      if ((k != 13) && (v[k] < val) && (v[k] > a)) a = v[k];
+    if (a < 0) break;
+    val = (a < min) ? min : a;
+  }
+  return val;
+} /* delta_b() */
+
+/* ==================================== */
+static int32_t delta_s(uint16_t *F, int32_t p, int32_t rs, int32_t ps, int32_t connex, int32_t min)
+/* ==================================== */
+// comme delta_b, pour une image 16 bits
+{
+  uint16_t v[32];
+  int32_t k, a, val = F[p];
+
+  vois27_s(F, p, rs, ps, v);
+  while ((val > min) && destr27(seuil27_s(v, val), connex))
+  {
+    for (a = -1, k = 0; k < 27; k++) 
+      if ((k != 13) && (v[k] < val) && (v[k] > a)) a = v[k];
+    if (a < 0) break;
+    val = (a < min) ? min : a;
+  }
+  return val;
+} /* delta_s() */
+
+/* ==================================== */
+int32_t lhthin3d(struct xvimage *image, struct xvimage *imagecond, int32_t connex, int32_t nitermax)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "lhthin3d"
+{
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image);
+  int32_t ps = rs * cs, N = ps * ds;
+  int32_t p, q, k, n, niter, val, min;
+  int32_t t = datatype(image);
+  uint8_t *F = UCHARDATA(image), *C = NULL, *M;
+  uint16_t *F16 = USHORTDATA(image), *C16 = NULL;
+  struct xvimage *m;
+  File *L;
+
+  if (ds < 3)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((connex != 6) && (connex != 26))
+  {
+    fprintf(stderr, "%s: bad connectivity: %d\n", F_NAME, connex);
+    return 0;
+  }
+  if ((t != VFF_TYP_1_BYTE) && (t != VFF_TYP_2_BYTE))
+  {
+    fprintf(stderr, "%s: bad image type\n", F_NAME);
+    return 0;
+  }
+  if (imagecond != NULL)
+  {
+    if ((rowsize(imagecond) != rs) || (colsize(imagecond) != cs) || (depth(imagecond) != ds))
+    {
+      fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+      return 0;
+    }
+    if (datatype(imagecond) != t)
+    {
+      fprintf(stderr, "%s: incompatible image types\n", F_NAME);
+      return 0;
+    }
+    C = UCHARDATA(imagecond);
+    C16 = USHORTDATA(imagecond);
+  }
+  if (nitermax == -1) nitermax = 1000000000;
+
+  init_topo3d();
+  m = allocscratch(rs, cs, ds, VFF_TYP_1_BYTE); // M[p] : p est dans la file
+  L = CreeFile(N);
+  if ((m == NULL) || (L == NULL))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    if (m != NULL) freescratch(m);
+    if (L != NULL) FileTermine(L);
+    termine_topo3d();
+    return 0;
+  }
+  M = UCHARDATA(m);
+  for (p = 0; p < N; p++)
+    if (nonbord3d(p, rs, ps, N)) { FilePush(L, p); M[p] = 1; }
+
+  for (niter = 0; (niter < nitermax) && !FileVide(L); niter++)
+  {
+    for (n = FileTaille(L); n > 0; n--)
+    {
+      p = (int32_t)FilePop(L);
+      M[p] = 0;
+      if (t == VFF_TYP_1_BYTE)
+      {
+	min = C ? C[p] : 0;
+	if ((val = delta_b(F, p, rs, ps, connex, min)) >= F[p]) continue;
+	F[p] = (uint8_t)val;
+      }
+      else
+      {
+	min = C16 ? C16[p] : 0;
+	if ((val = delta_s(F16, p, rs, ps, connex, min)) >= F16[p]) continue;
+	F16[p] = (uint16_t)val;
+      }
+      for (k = 0; k < 26; k++)
+      {
+	q = voisin26(p, k, rs, ps, N);
+	if (!M[q] && nonbord3d(q, rs, ps, N)) { FilePush(L, q); M[q] = 1; }
+      }
+    }
+  }
+
+  FileTermine(L);
+  freescratch(m);
+  termine_topo3d();
+  return 1;
+} /* lhthin3d() */
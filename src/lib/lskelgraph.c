@@ -0,0 +1,553 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Graphe d'un squelette curviligne
+
+   lskelgraph construit le graphe d'un squelette curviligne binaire (par 
+   exemple le resultat de lskelCK3, lskelEK3 ou lskelAK2, directement en 
+   memoire) en 26-connexite (3D) ou en 8-connexite (2D).
+
+   Les points du squelette sont d'abord enumeres par mots de 64 octets 
+   (mc_non_nuls64), seul passage sur l'image entiere. Les resultats 
+   paralleles (lskelCK3, lskelEK3 sans -q) peuvent avoir des parties 
+   epaisses de 2 points : le squelette est d'abord aminci (amincit) par 
+   sous-iterations directionnelles, en retirant un a un les points simples
+   qui ne sont pas des extremites, ce qui preserve sa topologie et ses 
+   extremites. Les points retires sont marques dans L, l'image n'est pas 
+   modifiee. Les points restants sont ensuite classes selon un
+   critere topologique : un point de branche (point de courbe, voir curve8
+   et curve26) a exactement 2 voisins, et ces voisins sont dans 2 
+   composantes connexes distinctes de son voisinage (T8 ou T26 egal a 2).
+   Le critere est evalue sur le masque du voisinage borne a l'image (t8, 
+   top26_mask) : les points du bord de l'image sont traites comme les 
+   autres. Le nombre de voisins seul ne suffit pas : dans un coin de 
+   chemin 8-connexe, les points du coin ont 2 ou 3 voisins adjacents entre
+   eux.
+
+   Les autres points sont regroupes par adjacence en amas, par un parcours
+   en largeur (File) : chaque amas est un sommet. Chaque branche est 
+   ensuite suivie a partir d'un point de sommet, de voisin en voisin, 
+   jusqu'au sommet suivant ; sa longueur est la somme des pas (1, racine 
+   de 2 ou racine de 3). Les courbes fermees sans sommet recoivent un 
+   sommet SG_BOUCLE et un arc de ce sommet a lui-meme. Un retour sur le 
+   sommet de depart n'est retenu que s'il ferme une vraie courbe, qui a au
+   moins 4 points (la branche et ses points d'attache).
+
+   Le type d'un amas est donne par son degre : 0 point isole, 1 extremite,
+   3 ou plus jonction. Un amas de degre 2 n'est qu'un passage epais de la 
+   courbe : ses deux arcs sont fusionnes (reduitgraphe), la longueur 
+   ajoutee etant la distance entre leurs points d'attache ; s'il ne porte 
+   qu'un arc de lui-meme a lui-meme, c'est une boucle (SG_BOUCLE).
+
+   Les traitements qui suivent l'enumeration ne lisent et n'ecrivent que 
+   les points du squelette, mais le tableau d'etiquettes L est dense : il 
+   occupe 4 octets par point de l'image.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <math.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <mcutil.h>
+#include <mcsimd.h>
+#include <mclifo.h>
+#include <mctopo.h>
+#include <mctopo3d.h>
+#include <lskelgraph.h>
+
+/* etiquettes provisoires des points (les sommets sont etiquetes 0, 1, ...) */
+#define P_BRANCHE   -1          /* point de branche non parcouru */
+#define P_PARCOURU  -2          /* point de branche parcouru */
+#define P_SOMMET    -3          /* point de sommet non encore rattache */
+#define P_SUPPRIME  -4          /* point retire par l'amincissement */
+
+/* point du squelette non retire (L n'est lu que pour les points non nuls) */
+#define SQUEL(q) (F[q] && (L[q] != P_SUPPRIME))
+
+/* ==================================== */
+static int32_t voisins_squel(uint8_t *F, int32_t *L, int32_t p, int32_t rs, int32_t ps, int32_t N, int32_t connex, int32_t *V)
+/* ==================================== */
+// range dans V les voisins de p dans le squelette, retourne leur nombre
+{
+  int32_t k, q, n = 0;
+
+  if (connex == 8)
+  {
+    for (k = 0; k < 8; k++)
+      if (((q = voisin(p, k, rs, N)) >= 0) && SQUEL(q)) V[n++] = q;
+  }
+  else
+  {
+    for (k = 0; k < 26; k++)
+      if (((q = voisin26(p, k, rs, ps, N)) >= 0) && SQUEL(q)) V[n++] = q;
+  }
+  return n;
+} /* voisins_squel() */
+
+/* ==================================== */
+static int32_t voisin_dir(int32_t p, int32_t dx, int32_t dy, int32_t dz, int32_t rs, int32_t ps, int32_t N)
+/* ==================================== */
+// voisin de p de decalage (dx, dy, dz), -1 hors de l'image
+{
+  int32_t x = p % rs + dx, y = (p % ps) / rs + dy, z = p / ps + dz;
+  if ((x < 0) || (x >= rs) || (y < 0) || (y >= ps / rs) || (z < 0) || (z >= N / ps)) return -1;
+  return p + dz * ps + dy * rs + dx;
+} /* voisin_dir() */
+
+/* ==================================== */
+static uint32_t masque_squel(uint8_t *F, int32_t *L, int32_t p, int32_t rs, int32_t ps, int32_t N, int32_t connex, int32_t *n)
+/* ==================================== */
+// masque du voisinage de p dans le squelette, p pouvant etre un point de 
+// bord : 8 bits dans l'ordre de voisin (voir t8) ou 27 bits dans l'ordre de
+// mask27 ; range dans n le nombre de voisins de p
+{
+  int32_t k, q, dx, dy, dz;
+  uint32_t m = 0;
+
+  *n = 0;
+  if (connex == 8)
+  {
+    for (k = 0; k < 8; k++)
+      if (((q = voisin(p, k, rs, N)) >= 0) && SQUEL(q)) { m |= (1 << k); (*n)++; }
+    return m;
+  }
+  for (k = 0, dz = -1; dz <= 1; dz++)
+    for (dy = -1; dy <= 1; dy++)
+      for (dx = -1; dx <= 1; dx++, k++)
+        if (((q = voisin_dir(p, dx, dy, dz, rs, ps, N)) >= 0) && SQUEL(q)) { m |= (1 << k); (*n)++; }
+  (*n)--; // le point p lui-meme
+  return m;
+} /* masque_squel() */
+
+/* ==================================== */
+static int32_t amincit(uint8_t *F, int32_t *L, int32_t *P, int32_t np, int32_t *C, 
+                       int32_t rs, int32_t ps, int32_t N, int32_t connex)
+/* ==================================== */
+// amincit le squelette (points P[0..np-1]) : a la sous-iteration de 
+// direction d, les candidats sont les points dont le 6-voisin dans la 
+// direction d est absent et le 6-voisin oppose present ; chacun est retire
+// (L = P_SUPPRIME) s'il est simple et a au moins 2 voisins. Un objet d'un 
+// seul point d'epaisseur dans la direction d n'a pas de candidat. Les 
+// points restants sont ranges en tete de P, retourne leur nombre.
+{
+  static const int32_t dx[6] = {1, -1, 0, 0, 0, 0};
+  static const int32_t dy[6] = {0, 0, 1, -1, 0, 0};
+  static const int32_t dz[6] = {0, 0, 0, 0, 1, -1};
+  int32_t d, j, n, nc, p, q, r, simple, change = 1;
+  uint32_t m;
+
+  while (change)
+  {
+    change = 0;
+    for (d = 0; d < 6; d++)
+    {
+      for (nc = 0, j = 0; j < np; j++)
+      {
+        p = P[j];
+        if (L[p] == P_SUPPRIME) continue;
+        q = voisin_dir(p, dx[d], dy[d], dz[d], rs, ps, N);
+        r = voisin_dir(p, -dx[d], -dy[d], -dz[d], rs, ps, N);
+        if (((q < 0) || !SQUEL(q)) && (r >= 0) && SQUEL(r)) C[nc++] = p;
+      }
+      for (j = 0; j < nc; j++)
+      {
+        p = C[j];
+        m = masque_squel(F, L, p, rs, ps, N, connex, &n);
+        if (n < 2) continue;
+        if (connex == 8) simple = (t8(m) == 1) && (t4b(m) == 1);
+        else simple = simple26_mask(m);
+        if (simple) { L[p] = P_SUPPRIME; change = 1; }
+      }
+    }
+    for (n = 0, j = 0; j < np; j++) if (L[P[j]] != P_SUPPRIME) P[n++] = P[j];
+    np = n;
+  }
+  return np;
+} /* amincit() */
+
+/* ==================================== */
+static double distance(int32_t p, int32_t q, int32_t rs, int32_t ps)
+/* ==================================== */
+// distance euclidienne entre les points p et q (1, racine de 2 ou racine 
+// de 3 pour deux voisins)
+{
+  double dx = p % rs - q % rs, dy = (p % ps) / rs - (q % ps) / rs, dz = p / ps - q / ps;
+  return sqrt(dx * dx + dy * dy + dz * dz);
+} /* distance() */
+
+/* ==================================== */
+static int32_t ajoutearc(skelgraphe *g, int32_t i, int32_t j, int32_t pi, int32_t pj, int32_t n, double l)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "ajoutearc"
+{
+  if (g->nbarc == g->maxarc)
+  {
+    int32_t m = (g->maxarc == 0) ? 1024 : 2 * g->maxarc;
+    int32_t *o = (int32_t *)realloc(g->orig, m * sizeof(int32_t));
+    int32_t *e = (o == NULL) ? NULL : (int32_t *)realloc(g->extr, m * sizeof(int32_t));
+    int32_t *po = (e == NULL) ? NULL : (int32_t *)realloc(g->porig, m * sizeof(int32_t));
+    int32_t *pe = (po == NULL) ? NULL : (int32_t *)realloc(g->pextr, m * sizeof(int32_t));
+    int32_t *np = (pe == NULL) ? NULL : (int32_t *)realloc(g->nparc, m * sizeof(int32_t));
+    double *la = (np == NULL) ? NULL : (double *)realloc(g->larc, m * sizeof(double));
+    if (o != NULL) g->orig = o;
+    if (e != NULL) g->extr = e;
+    if (po != NULL) g->porig = po;
+    if (pe != NULL) g->pextr = pe;
+    if (np != NULL) g->nparc = np;
+    if (la == NULL)
+    {
+      fprintf(stderr, "%s: realloc failed\n", F_NAME);
+      return 0;
+    }
+    g->larc = la;
+    g->maxarc = m;
+  }
+  g->orig[g->nbarc] = i;
+  g->extr[g->nbarc] = j;
+  g->porig[g->nbarc] = pi;
+  g->pextr[g->nbarc] = pj;
+  g->nparc[g->nbarc] = n;
+  g->larc[g->nbarc] = l;
+  g->nbarc++;
+  g->dsom[i]++;
+  g->dsom[j]++;
+  return 1;
+} /* ajoutearc() */
+
+/* ==================================== */
+static int32_t suitbranche(skelgraphe *g, uint8_t *F, int32_t *L, int32_t p, int32_t q, 
+                           int32_t rs, int32_t ps, int32_t N, int32_t connex)
+/* ==================================== */
+// suit la branche issue du point de sommet p par le point de branche q
+{
+  int32_t V[26], prec = p, cour = q, suiv, n = 0;
+  double l = distance(p, q, rs, ps);
+
+  while (1)
+  {
+    L[cour] = P_PARCOURU;
+    n++;
+    voisins_squel(F, L, cour, rs, ps, N, connex, V); // exactement 2 voisins
+    suiv = (V[0] == prec) ? V[1] : V[0];
+    l += distance(cour, suiv, rs, ps);
+    if (L[suiv] >= 0) break;
+    if (L[suiv] != P_BRANCHE) return 1; // ne se produit pas pour une branche simple
+    prec = cour; cour = suiv;
+  }
+  // retour sur le sommet de depart : une courbe fermee a au moins 4 points
+  if ((L[suiv] == L[p]) && (n + ((suiv == p) ? 1 : 2) < 4)) return 1;
+  return ajoutearc(g, L[p], L[suiv], p, suiv, n, l);
+} /* suitbranche() */
+
+/* ==================================== */
+static int32_t reduitgraphe(skelgraphe *g)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "reduitgraphe"
+// fusionne les deux arcs de chaque amas de jonction de degre 2, puis 
+// renumerote les sommets et les arcs restants
+{
+  int32_t rs = g->rs, ps = g->rs * g->cs;
+  int32_t a, b, s, t, k, pa, pb, pt, *I, *R;
+  uint8_t *mortarc, *mortsom;
+
+  I = (int32_t *)malloc(2 * (g->nbsom + 1) * sizeof(int32_t));
+  R = (int32_t *)malloc((g->nbsom + 1) * sizeof(int32_t));
+  mortarc = (uint8_t *)calloc(g->nbarc + 1, 1);
+  mortsom = (uint8_t *)calloc(g->nbsom + 1, 1);
+  if ((I == NULL) || (R == NULL) || (mortarc == NULL) || (mortsom == NULL))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    free(I); free(R); free(mortarc); free(mortsom);
+    return 0;
+  }
+
+#define DEG2(s) ((g->tsom[s] == SG_JONCTION) && (g->dsom[s] == 2))
+  // les deux arcs incidents a chaque amas de degre 2
+  for (s = 0; s < g->nbsom; s++) I[2*s] = I[2*s+1] = -1;
+  for (a = 0; a < g->nbarc; a++)
+  {
+    s = g->orig[a]; if (DEG2(s)) I[2*s + (I[2*s] >= 0)] = a;
+    s = g->extr[a]; if (DEG2(s)) I[2*s + (I[2*s] >= 0)] = a;
+  }
+
+  for (s = 0; s < g->nbsom; s++)
+  {
+    if (! DEG2(s)) continue;
+    a = I[2*s]; b = I[2*s+1];
+    if (a == b) { g->tsom[s] = SG_BOUCLE; continue; } // courbe fermee
+    // l'extremite de a en s est remplacee par l'autre extremite t de b
+    pa = (g->orig[a] == s) ? g->porig[a] : g->pextr[a];
+    if (g->orig[b] == s) { t = g->extr[b]; pt = g->pextr[b]; pb = g->porig[b]; }
+    else { t = g->orig[b]; pt = g->porig[b]; pb = g->pextr[b]; }
+    g->larc[a] += g->larc[b] + distance(pa, pb, rs, ps);
+    g->nparc[a] += g->nparc[b] + g->npsom[s];
+    if (g->orig[a] == s) { g->orig[a] = t; g->porig[a] = pt; }
+    else { g->extr[a] = t; g->pextr[a] = pt; }
+    mortarc[b] = 1; mortsom[s] = 1;
+    if (DEG2(t)) for (k = 2*t; k < 2*t+2; k++) if (I[k] == b) I[k] = a;
+    g->tsom[s] = -1;
+  }
+#undef DEG2
+
+  for (t = 0, s = 0; s < g->nbsom; s++)
+  {
+    if (mortsom[s]) continue;
+    R[s] = t;
+    g->tsom[t] = g->tsom[s];
+    g->npsom[t] = g->npsom[s]; g->dsom[t] = g->dsom[s];
+    g->xsom[t] = g->xsom[s]; g->ysom[t] = g->ysom[s]; g->zsom[t] = g->zsom[s];
+    t++;
+  }
+  g->nbsom = t;
+  for (b = 0, a = 0; a < g->nbarc; a++)
+  {
+    if (mortarc[a]) continue;
+    g->orig[b] = R[g->orig[a]]; g->extr[b] = R[g->extr[a]];
+    g->porig[b] = g->porig[a]; g->pextr[b] = g->pextr[a];
+    g->nparc[b] = g->nparc[a]; g->larc[b] = g->larc[a];
+    b++;
+  }
+  g->nbarc = b;
+
+  free(I); free(R); free(mortarc); free(mortsom);
+  return 1;
+} /* reduitgraphe() */
+
+/* ==================================== */
+void freeskelgraph(skelgraphe *g)
+/* ==================================== */
+{
+  if (g == NULL) return;
+  free(g->tsom); free(g->npsom); free(g->dsom);
+  free(g->xsom); free(g->ysom); free(g->zsom);
+  free(g->orig); free(g->extr); free(g->porig); free(g->pextr);
+  free(g->nparc); free(g->larc);
+  free(g);
+} /* freeskelgraph() */
+
+/* ==================================== */
+skelgraphe * lskelgraph(struct xvimage *image, int32_t connex)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "lskelgraph"
+{
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image);
+  int32_t ps = rs * cs, N = ps * ds;
+  uint8_t *F = UCHARDATA(image);
+  int32_t *L = NULL, *P = NULL, *C = NULL, *Q;
+  int32_t V[26], i, j, k, n, p, q, s, t, tb, np = 0, maxp = 1024;
+  uint32_t m;
+  uint64_t o;
+  skelgraphe *g = NULL;
+  File *T = NULL;
+
+  if (datatype(image) != VFF_TYP_1_BYTE)
+  {
+    fprintf(stderr, "%s: image type must be byte\n", F_NAME);
+    return NULL;
+  }
+  if ((connex != 26) && !((connex == 8) && (ds == 1)))
+  {
+    fprintf(stderr, "%s: bad connectivity: %d\n", F_NAME, connex);
+    return NULL;
+  }
+
+  L = (int32_t *)malloc(N * sizeof(int32_t)); // seuls les points du squelette sont lus
+  P = (int32_t *)malloc(maxp * sizeof(int32_t));
+  g = (skelgraphe *)calloc(1, sizeof(skelgraphe));
+  T = CreeFile(1024);
+  if ((L == NULL) || (P == NULL) || (g == NULL) || (T == NULL)) goto echec;
+  g->rs = rs; g->cs = cs; g->ds = ds;
+
+  // enumeration des points
+  for (i = 0; i < N; i += 64)
+  {
+    k = min(64, N - i);
+    for (o = mc_non_nuls64(F + i, k); o; o &= o - 1)
+    {
+      if (np == maxp)
+      {
+        Q = (int32_t *)realloc(P, 2 * maxp * sizeof(int32_t));
+        if (Q == NULL) goto echec;
+        P = Q; maxp *= 2;
+      }
+      P[np++] = i + RANG64(o);
+    }
+  }
+
+  // amincissement, puis classification : points de branche et points de 
+  // sommet
+  C = (int32_t *)malloc((np + 1) * sizeof(int32_t));
+  if (C == NULL) goto echec;
+  for (j = 0; j < np; j++) L[P[j]] = P_SOMMET;
+  if (connex == 26) init_topo3d();
+  np = amincit(F, L, P, np, C, rs, ps, N, connex);
+  for (j = 0; j < np; j++)
+  {
+    p = P[j];
+    m = masque_squel(F, L, p, rs, ps, N, connex, &n);
+    if (connex == 8) t = t8(m); else top26_mask(m, &t, &tb);
+    L[p] = ((t == 2) && (n == 2)) ? P_BRANCHE : P_SOMMET;
+  }
+  if (connex == 26) termine_topo3d();
+  free(C); C = NULL;
+
+  // sommets : au plus un par point ; le type est fixe par le degre
+  g->tsom = (int32_t *)malloc((np + 1) * sizeof(int32_t));
+  g->npsom = (int32_t *)calloc(np + 1, sizeof(int32_t));
+  g->dsom = (int32_t *)calloc(np + 1, sizeof(int32_t));
+  g->xsom = (double *)calloc(np + 1, sizeof(double));
+  g->ysom = (double *)calloc(np + 1, sizeof(double));
+  g->zsom = (double *)calloc(np + 1, sizeof(double));
+  if ((g->tsom == NULL) || (g->npsom == NULL) || (g->dsom == NULL) ||
+      (g->xsom == NULL) || (g->ysom == NULL) || (g->zsom == NULL)) goto echec;
+
+  for (j = 0; j < np; j++)
+  {
+    p = P[j];
+    if (L[p] == P_SOMMET)
+    {
+      s = g->nbsom++;
+      g->tsom[s] = SG_JONCTION;
+      L[p] = s;
+      FilePush(T, p);
+      while (! FileVide(T))
+      {
+        q = (int32_t)FilePop(T);
+        g->npsom[s]++;
+        g->xsom[s] += q % rs; g->ysom[s] += (q % ps) / rs; g->zsom[s] += q / ps;
+        n = voisins_squel(F, L, q, rs, ps, N, connex, V);
+        for (k = 0; k < n; k++)
+          if (L[V[k]] == P_SOMMET) { L[V[k]] = s; FilePush(T, V[k]); }
+      }
+      g->xsom[s] /= g->npsom[s]; g->ysom[s] /= g->npsom[s]; g->zsom[s] /= g->npsom[s];
+    }
+  }
+
+  // branches issues des sommets (deux sommets distincts ne sont jamais 
+  // adjacents)
+  for (j = 0; j < np; j++)
+  {
+    p = P[j];
+    if (L[p] < 0) continue;
+    n = voisins_squel(F, L, p, rs, ps, N, connex, V);
+    for (k = 0; k < n; k++)
+      if (L[V[k]] == P_BRANCHE)
+        if (! suitbranche(g, F, L, p, V[k], rs, ps, N, connex)) goto echec;
+  }
+
+  // courbes fermees sans sommet
+  for (j = 0; j < np; j++)
+  {
+    p = P[j];
+    if (L[p] != P_BRANCHE) continue;
+    s = g->nbsom++;
+    g->tsom[s] = SG_BOUCLE;
+    g->npsom[s] = 1;
+    g->xsom[s] = p % rs; g->ysom[s] = (p % ps) / rs; g->zsom[s] = p / ps;
+    L[p] = s;
+    voisins_squel(F, L, p, rs, ps, N, connex, V);
+    if (! suitbranche(g, F, L, p, V[0], rs, ps, N, connex)) goto echec;
+  }
+
+  for (s = 0; s < g->nbsom; s++)
+    if (g->tsom[s] == SG_JONCTION)
+    {
+      if (g->dsom[s] == 0) g->tsom[s] = SG_ISOLE;
+      else if (g->dsom[s] == 1) g->tsom[s] = SG_EXTREMITE;
+    }
+
+  free(L); free(P);
+  FileTermine(T);
+  if (! reduitgraphe(g))
+  {
+    freeskelgraph(g);
+    return NULL;
+  }
+  return g;
+
+ echec:
+  fprintf(stderr, "%s: malloc failed\n", F_NAME);
+  free(L); free(P); free(C);
+  if (T != NULL) FileTermine(T);
+  freeskelgraph(g);
+  return NULL;
+} /* lskelgraph() */
+
+/* ==================================== */
+int32_t writeskelgraph(skelgraphe *g, char *filename)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "writeskelgraph"
+/* 
+  Format texte :
+    SKELGRAPH rs cs ds
+    nbsom nbarc
+  puis une ligne par sommet : 
+    numero type nbpoints degre x y z
+  (type : 0 point isole, 1 extremite, 2 boucle, 3 jonction ; x y z : 
+  barycentre des points du sommet), puis une ligne par arc :
+    numero origine extremite nbpoints longueur
+  (nbpoints : nombre de points de la branche hors sommets).
+*/
+{
+  FILE *fd;
+  int32_t i;
+
+  fd = fopen(filename, "w");
+  if (fd == NULL)
+  {
+    fprintf(stderr, "%s: cannot open file: %s\n", F_NAME, filename);
+    return 0;
+  }
+  fprintf(fd, "SKELGRAPH %d %d %d\n", g->rs, g->cs, g->ds);
+  fprintf(fd, "%d %d\n", g->nbsom, g->nbarc);
+  for (i = 0; i < g->nbsom; i++)
+    fprintf(fd, "%d %d %d %d %g %g %g\n", i, g->tsom[i], g->npsom[i], g->dsom[i], 
+            g->xsom[i], g->ysom[i], g->zsom[i]);
+  for (i = 0; i < g->nbarc; i++)
+    fprintf(fd, "%d %d %d %d %.3f\n", i, g->orig[i], g->extr[i], g->nparc[i], g->larc[i]);
+  if (fclose(fd) != 0)
+  {
+    fprintf(stderr, "%s: write error on file: %s\n", F_NAME, filename);
+    return 0;
+  }
+  return 1;
+} /* writeskelgraph() */
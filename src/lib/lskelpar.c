@@ -182,10 +182,16 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <sys/types.h>
 #include <stdlib.h>
 #include <assert.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <mccodimage.h>
 #include <mcimage.h>
 #include <mctopo.h>
 #include <mcutil.h>
+#include <mclifo.h>
+#include <mcmorpho.h>
+#include <mcdist.h>
 #include <lskelpar.h>
 
 //#define DEBUG_PAV
@@ -498,7 +504,7 @@ int32_t lskelpavlidis(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step;
 
@@ -548,7 +554,7 @@ int32_t lskelpavlidis(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelpavlidis() */
 
@@ -567,7 +573,7 @@ int32_t lskelpavlidis1(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 1; // normalize values
@@ -583,7 +589,7 @@ int32_t lskelpavlidis1(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelpavlidis1() */
 
@@ -614,7 +620,7 @@ int32_t lskeleckhardt(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -671,7 +677,7 @@ int32_t lskeleckhardt(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskeleckhardt() */
 
@@ -727,7 +733,7 @@ int32_t lskelrutovitz(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -773,7 +779,7 @@ int32_t lskelrutovitz(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelrutovitz() */
 
@@ -814,7 +820,7 @@ int32_t lskelzhangwang(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -860,7 +866,7 @@ int32_t lskelzhangwang(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelzhangwang() */
 
@@ -1070,9 +1076,9 @@ int32_t lskelhanlarhee(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
-  struct xvimage *nbn = copyimage(image); 
+  struct xvimage *nbn = copyscratch(image); 
   uint8_t *B = UCHARDATA(nbn);
   int32_t step, nonstab;
 
@@ -1100,7 +1106,13 @@ int32_t lskelhanlarhee(struct xvimage *image,
     printf("step %d\n", step);
 #endif
     memset(T, 0, N);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (i = 0; i < N; i++) if (F[i]) B[i] = nbvois8(F, i, rs, N);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) 
       if (F[i] && hanlarhee_match(B, i, rs, N))
       {
@@ -1118,8 +1130,8 @@ int32_t lskelhanlarhee(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
-  freeimage(nbn);
+  freescratch(tmp);
+  freescratch(nbn);
   return(1);
 } /* lskelhanlarhee() */
 
@@ -1226,7 +1238,7 @@ int32_t lskelguohall(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -1310,7 +1322,7 @@ int32_t lskelguohall(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelguohall() */
 
@@ -1390,7 +1402,7 @@ int32_t lskelchinwan(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -1438,7 +1450,7 @@ int32_t lskelchinwan(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelchinwan() */
 
@@ -1696,7 +1708,7 @@ int32_t lskeljang(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12;
@@ -1762,7 +1774,7 @@ int32_t lskeljang(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskeljang() */
 
@@ -1781,7 +1793,7 @@ int32_t lskeljangcor(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13;
@@ -1847,7 +1859,7 @@ int32_t lskeljangcor(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskeljangcor() */
 
@@ -1993,7 +2005,7 @@ int32_t lskelmns(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6;
@@ -2025,6 +2037,9 @@ int32_t lskelmns(struct xvimage *image,
     for (i = 0; i < N; i++) 
       if ((F[i] == 1) && simple8(F, i, rs, N))
 	F[i] = 2;
+#ifdef _OPENMP
+#pragma omp parallel for private(m1, m2, m3, m4, m5, m6)
+#endif
     for (i = 0; i < N; i++) 
       if (F[i] == 2)
       { 
@@ -2056,6 +2071,9 @@ int32_t lskelmns(struct xvimage *image,
     printf("\n");
 #endif
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) 
       if ((F[i] == 2) && !T[i]) { F[i] = 0; nonstab = 1; }
     for (i = 0; i < N; i++) if (F[i]) F[i] = 1;
@@ -2067,7 +2085,7 @@ int32_t lskelmns(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelmns() */
 
@@ -2265,7 +2283,7 @@ int32_t lskeljangrec(struct xvimage *image,
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
   uint8_t *I;            /* l'image d'inhibition (axe mdian) */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11;
@@ -2331,7 +2349,7 @@ int32_t lskeljangrec(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskeljangrec() */
 
@@ -2571,7 +2589,7 @@ int32_t lskelchoy(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13;
@@ -2640,7 +2658,7 @@ int32_t lskelchoy(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelchoy() */
 
@@ -2733,7 +2751,7 @@ int32_t lskelmanz(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3;
@@ -2799,7 +2817,7 @@ int32_t lskelmanz(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelmanz() */
 
@@ -2847,7 +2865,7 @@ int32_t lskelhall(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -2939,7 +2957,7 @@ int32_t lskelhall(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelhall() */
 
@@ -3132,7 +3150,7 @@ int32_t lskelwutsai(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11;
@@ -3197,7 +3215,7 @@ int32_t lskelwutsai(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelwutsai() */
 
@@ -3482,7 +3500,7 @@ int32_t lskelmcultime(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6;
@@ -3556,7 +3574,7 @@ int32_t lskelmcultime(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelmcultime() */
 
@@ -3573,7 +3591,7 @@ int32_t lskelmccurv(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2, m3, m4, m5, m6;
@@ -3605,6 +3623,9 @@ int32_t lskelmccurv(struct xvimage *image,
     for (i = 0; i < N; i++) 
       if ((F[i] == 1) && simple8(F, i, rs, N)  && !mc_end2(F, i, rs, N))
 	F[i] = 2;
+#ifdef _OPENMP
+#pragma omp parallel for private(m1, m2, m3, m4, m5, m6)
+#endif
     for (i = 0; i < N; i++) 
       if (F[i] == 2)
       { 
@@ -3636,6 +3657,9 @@ int32_t lskelmccurv(struct xvimage *image,
     printf("\n");
 #endif
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) 
       if ((F[i] == 2) && !T[i]) { F[i] = 0; nonstab = 1; }
     for (i = 0; i < N; i++) if (F[i]) F[i] = 1;
@@ -3647,7 +3671,7 @@ int32_t lskelmccurv(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelmccurv() */
 
@@ -3664,7 +3688,7 @@ int32_t lskelmccurvrec(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *X = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   uint8_t *M = (uint8_t *)malloc(N);
   uint8_t *E = (uint8_t *)malloc(N);
@@ -3780,7 +3804,7 @@ int32_t lskelmccurvrec(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (X[i]) X[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   free(M);
   free(E);
   free(R);
@@ -3800,7 +3824,7 @@ int32_t lskelmccurvrecold(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *X = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   uint8_t *Y = (uint8_t *)malloc(N);
   uint8_t *I = (uint8_t *)malloc(N);
@@ -3934,7 +3958,7 @@ int32_t lskelmccurvrecold(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (X[i]) X[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   free(Y);
   free(I);
   free(D);
@@ -3975,7 +3999,7 @@ A   2*  B
 } /* bertrand_match1() */
 
 /* ==================================== */
-int32_t lskelNK2(struct xvimage *image, 
+static int32_t lskelNK2_nb(struct xvimage *image, 
 	      int32_t nsteps,
 	      struct xvimage *inhibit)
 /* ==================================== */
@@ -3990,7 +4014,7 @@ int32_t lskelNK2(struct xvimage *image,
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
   uint8_t *I;            /* l'image d'inhibition (axe mdian) */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
   int32_t m1, m2;
@@ -4031,8 +4055,11 @@ int32_t lskelNK2(struct xvimage *image,
     memset(T, 0, N);
 
     for (i = 0; i < N; i++) 
-      if ((F[i] == 1) && simple8(F, i, rs, N)  && !I[i])
+      if ((F[i] == 1) && simple8_nb(F, i, rs)  && !I[i])
 	F[i] = 2;
+#ifdef _OPENMP
+#pragma omp parallel for private(m1, m2)
+#endif
     for (i = 0; i < N; i++) 
       if (F[i] == 2)
       { 
@@ -4060,6 +4087,9 @@ int32_t lskelNK2(struct xvimage *image,
     printf("\n");
 #endif
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) 
       if ((F[i] == 2) && !T[i]) 
       { 
@@ -4088,9 +4118,9 @@ int32_t lskelNK2(struct xvimage *image,
   writeimage(tmp2,"_etude");
 #endif
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
-} /* lskelNK2() */
+} /* lskelNK2_nb() */
 
 /* ==================================== */
 int32_t bertrand_match3(uint8_t *F, int32_t x, int32_t rs, int32_t N)
@@ -4135,9 +4165,9 @@ R
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
+  struct xvimage *t = copyscratch(image); 
   uint8_t *T = UCHARDATA(t);
-  struct xvimage *r = copyimage(image); 
+  struct xvimage *r = copyscratch(image); 
   uint8_t *R = UCHARDATA(r);
   int32_t step, nonstab;
   int32_t m1;
@@ -4171,14 +4201,15 @@ R
     printf("step %d\n", step);
 #endif
 
-    memset(R, 0, N);
-    for (i = 0; i < N; i++) 
-      if (T[i] && (nbvois4(T, i, rs, N) == 4)) R[i] = 1; // calcule R = eros (T)
+    morpho_ero4(T, R, rs, cs);                           // calcule R = eros (T)
     for (i = 0; i < N; i++) T[i] = R[i];                 // T = eros (T)
     for (i = 0; i < N; i++) 
       if ((F[i] == 1) && simple8(F, i, rs, N)  && (nbvois4(T, i, rs, N) > 0))
 	F[i] = 2; //  pixels simples pour F et 4-voisins d'un point de T  
     memset(R, 0, N);
+#ifdef _OPENMP
+#pragma omp parallel for private(m1)
+#endif
     for (i = 0; i < N; i++) 
       if (F[i] == 2)
       { 
@@ -4189,6 +4220,9 @@ R
 	}
       }
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) 
       if ((F[i] == 2) && !R[i]) 
       { 
@@ -4211,8 +4245,8 @@ R
   writeimage(tmp2,"_etude");
 #endif
 
-  freeimage(t);
-  freeimage(r);
+  freescratch(t);
+  freescratch(r);
   return(1);
 } /* lskelbertrand_sym() */
 
@@ -4231,7 +4265,7 @@ int32_t lskelbertrand_asym_s(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *X = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   uint8_t *M = (uint8_t *)malloc(N);
   uint8_t *E = (uint8_t *)malloc(N);
@@ -4263,12 +4297,13 @@ int32_t lskelbertrand_asym_s(struct xvimage *image,
     printf("step %d\n", step);
 #endif
 
-    memset(E, 0, N);   // T = eros (T)
-    for (i = 0; i < N; i++) 
-      if (T[i] && (nbvois4(T, i, rs, N) == 4)) E[i] = 1;
+    morpho_ero4(T, E, rs, cs);   // T = eros (T)
     memcpy(T, E, N);
 
     memset(M, 0, N);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (i = 0; i < N; i++) 
       if (nbvois4(T, i, rs, N) >= 1) M[i] = 1;           // calcule M = Dilat(T)
     for (i = 0; i < N; i++) 
@@ -4276,6 +4311,9 @@ int32_t lskelbertrand_asym_s(struct xvimage *image,
 	X[i] = 2;
     
     memset(R, 0, N);
+#ifdef _OPENMP
+#pragma omp parallel for private(m1, m2)
+#endif
     for (i = 0; i < N; i++) 
       if (X[i] == 2)
       { 
@@ -4287,6 +4325,9 @@ int32_t lskelbertrand_asym_s(struct xvimage *image,
 	}
       }
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) 
       if ((X[i] == 2) && !R[i]) { X[i] = 0; nonstab = 1; }
     for (i = 0; i < N; i++) if (X[i]) X[i] = 1;
@@ -4298,7 +4339,7 @@ int32_t lskelbertrand_asym_s(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (X[i]) X[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   free(M);
   free(E);
   free(R);
@@ -4306,7 +4347,7 @@ int32_t lskelbertrand_asym_s(struct xvimage *image,
 } /* lskelbertrand_asym_s() */
 
 /* ==================================== */
-int32_t lskelMK2(struct xvimage *image, 
+static int32_t lskelMK2_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -4327,9 +4368,9 @@ R
   int32_t N = rs * cs;             /* taille image */
   uint8_t *S = UCHARDATA(image);   /* l'image de depart */
   uint8_t *I;                      /* l'image d'inhibition */
-  struct xvimage *t = copyimage(image); 
+  struct xvimage *t = copyscratch(image); 
   uint8_t *T = UCHARDATA(t);
-  struct xvimage *r = copyimage(image); 
+  struct xvimage *r = copyscratch(image); 
   uint8_t *R = UCHARDATA(r);
   int32_t step, nonstab;
   int32_t m1;
@@ -4368,9 +4409,12 @@ R
 #endif
 
     for (i = 0; i < N; i++) 
-      if ((S[i] == 1) && simple8(S, i, rs, N))
+      if ((S[i] == 1) && simple8_nb(S, i, rs))
 	S[i] = 2; //  pixels simples pour S
     memset(R, 0, N);
+#ifdef _OPENMP
+#pragma omp parallel for private(m1)
+#endif
     for (i = 0; i < N; i++) 
       if (S[i] == 2)
       { 
@@ -4390,12 +4434,19 @@ R
 	if ((S[i] == 1) || R[i])
 	  T[i] = 1;
     }
-    memset(R, 0, N);
-    for (i = 0; i < N; i++)
-      if (nbvois8(T, i, rs, N) >= 1) R[i] = 1; // calcule R = Dilat(T)
+    if (!morpho_dil8(T, R, rs, cs)) // calcule R = Dilat(T) (R = T \oplus \Gamma_8* hors de T)
+    {
+      fprintf(stderr, "%s: malloc failed\n", F_NAME);
+      freescratch(t);
+      freescratch(r);
+      return 0;
+    }
     for (i = 0; i < N; i++)
       if (T[i] || (S[i] && !R[i])) T[i] = 1; else T[i] = 0; // T := T \cup [S \ R]
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++)
       if (S[i] && !T[i]) 
       {
@@ -4411,13 +4462,13 @@ R
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
-  freeimage(r);
+  freescratch(t);
+  freescratch(r);
   return(1);
-} /* lskelMK2() */
+} /* lskelMK2_nb() */
 
 /* ==================================== */
-int32_t lskelAK2(struct xvimage *image, 
+static int32_t lskelAK2_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -4433,6 +4484,13 @@ R
   P := pixels de S \ K simples pour S
   R := pixels de P qui s'apparient avec le masque C (bertrand_match3)
   S := [S  \  P]  \cup  R
+
+Aprs n tapes, T est l'ensemble des points de distance d4 au fond 
+suprieure  n, et K l'ensemble des centres de boules d4 maximales de rayon
+au plus n (maxima locaux de la distance). La distance B et les maxima M sont
+donc calculs une fois pour toutes (mcdist) et K = {x, M[x] et B[x] <= step}.
+Si l'image inhibit est fournie, elle remplace l'ensemble K (M := inhibit,
+B := 0).
 */
 #undef F_NAME
 #define F_NAME "lskelAK2"
@@ -4442,39 +4500,45 @@ R
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
-  uint8_t *T = UCHARDATA(t);
-  struct xvimage *r = copyimage(image); 
+  struct xvimage *r = copyscratch(image); 
   uint8_t *R = UCHARDATA(r);
-  struct xvimage *e = copyimage(image); 
-  uint8_t *E = UCHARDATA(e);
-  struct xvimage *d = copyimage(image); 
+  struct xvimage *d = copyscratch(image); 
   uint8_t *D = UCHARDATA(d);
-  struct xvimage *k = copyimage(image); 
-  uint8_t *K = UCHARDATA(k);
+  struct xvimage *m = copyscratch(image); 
+  uint8_t *M = UCHARDATA(m);
+  int32_t *B;
 
   int32_t step, nonstab;
   int32_t m1;
 
-  if (inhibit != NULL)
-  {
-    fprintf(stderr, "%s: inhibit image not implemented\n", F_NAME);
-    return 0;
-  }
-
   if (nsteps == -1) nsteps = 1000000000;
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 1; // normalize values
 
+  B = (int32_t *)malloc(N * sizeof(int32_t));
+  if ((B == NULL) || ((inhibit == NULL) && !dist_bloc(S, B, rs, cs, 1)))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    freescratch(r);
+    freescratch(d);
+    freescratch(m);
+    if (B) free(B);
+    return 0;
+  }
+  if (inhibit != NULL)
+  {
+    uint8_t *I = UCHARDATA(inhibit);
+    for (i = 0; i < N; i++) M[i] = (I[i] != 0);
+    memset(B, 0, N * sizeof(int32_t));
+  }
+  else dist_axebloc(B, M, rs, cs, 1);
+
   /* ================================================ */
   /*               DEBUT ALGO                         */
   /* ================================================ */
 
   step = 0;
   nonstab = 1;
-  // K := \emptyset ; T := S
-  memset(K, 0, N);
-  memcpy(T, S, N);
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -4483,34 +4547,16 @@ R
     printf("step %d\n", step);
 #endif
 
-    //  E := T \ominus \Gamma_4 
-    memset(E, 0, N);
-    for (i = 0; i < N; i++) 
-      if (T[i] && (nbvois4(T, i, rs, N) == 4)) E[i] = 1;
-
-    //  D := E \oplus \Gamma_4
-    memset(D, 0, N);
-    for (i = 0; i < N; i++)
-      if (E[i] || nbvois4(E, i, rs, N) >= 1) D[i] = 1;
-
-    //  D := T \ D
-    for (i = 0; i < N; i++)
-      if (T[i] && !D[i]) D[i] = 1; else D[i] = 0;
-
-    //  T := E
-    memcpy(T, E, N);
-
-    //  K := K \cup D
-    for (i = 0; i < N; i++)
-      if (D[i]) K[i] = 1;
-    
     //  P := pixels de S \ K simples pour S (P est reprsent par les points  2 dans S)
     for (i = 0; i < N; i++)
-      if (S[i] && !K[i] && simple8(S, i, rs, N))
+      if (S[i] && !(M[i] && (B[i] <= step)) && simple8_nb(S, i, rs))
 	S[i] = 2;
 
     //  R := pixels de P qui s'apparient avec le masque C (bertrand_match3)
     memset(R, 0, N);
+#ifdef _OPENMP
+#pragma omp parallel for private(m1)
+#endif
     for (i = 0; i < N; i++) 
       if (S[i] == 2)
       { 
@@ -4519,10 +4565,14 @@ R
       }
 
     //  D := [S  \  P]  \cup  R
+    memset(D, 0, N);
     for (i = 0; i < N; i++)
       if ((S[i] == 1) || R[i])
 	D[i] = 1;
 
+#ifdef _OPENMP
+#pragma omp parallel for reduction(|:nonstab)
+#endif
     for (i = 0; i < N; i++) // pour  tester la stabilit
       if (S[i] && !D[i]) 
       {
@@ -4538,13 +4588,12 @@ R
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
-  freeimage(r);
-  freeimage(e);
-  freeimage(d);
-  freeimage(k);
+  freescratch(r);
+  freescratch(d);
+  freescratch(m);
+  free(B);
   return(1);
-} /* lskelAK2() */
+} /* lskelAK2_nb() */
 
 /* ==================================== */
 static int32_t ros_match(uint8_t *F, int32_t x, int32_t rs, int32_t N)
@@ -4648,7 +4697,7 @@ int32_t lskelrosenfeld(struct xvimage *image,
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t N = rs * cs;             /* taille image */
   uint8_t *F = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *tmp = copyimage(image); 
+  struct xvimage *tmp = copyscratch(image); 
   uint8_t *T = UCHARDATA(tmp);
   int32_t step, nonstab;
 
@@ -4708,6 +4757,1274 @@ int32_t lskelrosenfeld(struct xvimage *image,
 
   for (i = 0; i < N; i++) if (F[i]) F[i] = 255; // normalize values
 
-  freeimage(tmp);
+  freescratch(tmp);
   return(1);
 } /* lskelrosenfeld() */
+
+/* ==================================== */
+static int32_t lskelframe(
+  int32_t (*skel)(struct xvimage *, int32_t, struct xvimage *),
+  struct xvimage *image,
+  int32_t nsteps,
+  struct xvimage *inhibit)
+/* ==================================== */
+/*
+  Les fonctions *_nb supposent qu'aucun point objet n'est sur le bord de
+  l'image (simple8_nb ne fait aucun test de bord). Si l'objet touche le bord, 
+  l'algorithme travaille sur une copie entoure d'un cadre nul (addframe), 
+  retir  la fin (delframe), ainsi que l'image d'inhibition.
+*/
+#undef F_NAME
+#define F_NAME "lskelframe"
+{
+  struct xvimage *fimage, *finhibit = NULL;
+  int32_t ret;
+
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rowsize(image)) || (colsize(inhibit) != colsize(image))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  if (!touchframe(image)) return skel(image, nsteps, inhibit);
+
+  if (!addframes(image, inhibit, &fimage, &finhibit)) return 0;
+  ret = skel(fimage, nsteps, finhibit);
+  delframe(image, fimage);
+  freeimage(fimage);
+  if (finhibit != NULL)
+  {
+    delframe(inhibit, finhibit);
+    freeimage(finhibit);
+  }
+  return ret;
+} /* lskelframe() */
+
+/* ==================================== */
+int32_t lskelNK2(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelNK2_nb, image, nsteps, inhibit);
+} /* lskelNK2() */
+
+/* ==================================== */
+int32_t lskelMK2(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelMK2_nb, image, nsteps, inhibit);
+} /* lskelMK2() */
+
+/* ==================================== */
+int32_t lskelAK2(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelAK2_nb, image, nsteps, inhibit);
+} /* lskelAK2() */
+
+/* ==================================== */
+int32_t lskelstack(
+  int32_t (*skel)(struct xvimage *, int32_t, struct xvimage *),
+  struct xvimage *image,
+  int32_t nsteps,
+  struct xvimage *inhibit)
+/* ==================================== */
+/*
+  Applique l'algorithme 2D skel indpendamment  chaque plan z de l'image 3D
+  (avec le plan correspondant de l'image d'inhibition). Chaque plan est 
+  recopi dans une image 2D entoure d'un cadre nul ; les plans sont traits
+  en parallle.
+*/
+#undef F_NAME
+#define F_NAME "lskelstack"
+{
+  int32_t rs = rowsize(image);
+  int32_t cs = colsize(image);
+  int32_t ds = depth(image);
+  int32_t rs2 = rs + 2, N = rs * cs;
+  int32_t z, y, ret = 1;
+  struct xvimage *plan, *iplan;
+
+  if (datatype(image) != VFF_TYP_1_BYTE)
+  {
+    fprintf(stderr, "%s: image type must be byte\n", F_NAME);
+    return 0;
+  }
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs) || (depth(inhibit) != ds)))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) private(y, plan, iplan) reduction(&:ret)
+#endif
+  for (z = 0; z < ds; z++)
+  {
+    plan = allocscratch(rs2, cs + 2, 1, VFF_TYP_1_BYTE);
+    iplan = (inhibit != NULL) ? allocscratch(rs2, cs + 2, 1, VFF_TYP_1_BYTE) : NULL;
+    if ((plan == NULL) || ((inhibit != NULL) && (iplan == NULL)))
+    { // le plan n'est pas trait ; l'chec est rendu aprs la boucle
+      fprintf(stderr, "%s: allocimage failed\n", F_NAME);
+      if (plan != NULL) freescratch(plan);
+      if (iplan != NULL) freescratch(iplan);
+      ret = 0;
+      continue;
+    }
+    for (y = 0; y < cs; y++)
+      memcpy(UCHARDATA(plan) + (y+1)*rs2 + 1, UCHARDATA(image) + z*N + y*rs, rs);
+    if (iplan != NULL)
+    {
+      for (y = 0; y < cs; y++)
+	memcpy(UCHARDATA(iplan) + (y+1)*rs2 + 1, UCHARDATA(inhibit) + z*N + y*rs, rs);
+    }
+    if (skel(plan, nsteps, iplan))
+    {
+      for (y = 0; y < cs; y++)
+	memcpy(UCHARDATA(image) + z*N + y*rs, UCHARDATA(plan) + (y+1)*rs2 + 1, rs);
+    }
+    else ret = 0;
+    freescratch(plan);
+    if (iplan != NULL) freescratch(iplan);
+  }
+  return ret;
+} /* lskelstack() */
+
+/* ==================================== */
+/* ==================================== */
+/*       MOTEUR A TABLES                */
+/* ==================================== */
+/* ==================================== */
+/*
+  Pour la plupart des algorithmes ci-dessus, la dcision d'effacer un point x 
+  lors d'une tape ne dpend que des valeurs binaires de l'image dans une 
+  fentre 3x3 ou 5x5 centre en x (marquages intermdiaires compris, ds lors 
+  que ceux-ci ne sont lus qu' distance 1 de x). Cette dcision est alors 
+  compile en une table indexe par la configuration de la fentre, et une 
+  tape se rduit  une lecture de table par point objet.
+
+  Une rgle est dfinie par :
+  - une fonction de marquage optionnelle (marque), applique  tous les points 
+    avant la dcision et qui leur donne la valeur 2 (ex: bordext4 pour Pavlidis),
+  - une fonction de dcision (efface) value au point x.
+  Une entre de la table est calcule en appliquant ces fonctions  une image
+  de 9x9 pixels contenant la configuration,  la premire rencontre de cette
+  configuration (2^24 configurations pour la fentre 5x5). La table reste 
+  acquise pour les appels suivants.
+
+  Code d'une fentre de rayon r (largeur w = 2r+1) : le bit (dx+r)*w + (dy+r)
+  vaut 1 ssi le point (x+dx, y+dy) est objet. Les codes des colonnes (w bits)
+  sont calculs pour toute une ligne, puis le code d'un point objet est 
+  l'assemblage des codes de ses w colonnes. Le bit du point central (toujours 
+  1) n'est pas stock dans l'index de la table.
+
+  Algorithmes non traits ici : Han-La-Rhee (le nombre de voisins B conserve la 
+  valeur des points effacs aux tapes prcdentes), MNS, Couprie ultime et 
+  curviligne, MK2, AK2, NK2 et Bertrand (marques lues  distance 2 ou plus).
+*/
+
+#define TAB_RS 9                 /* taille de l'image de calcul des tables */
+#define TAB_CENTRE 40            /* point central de l'image de calcul */
+
+typedef struct {
+  int32_t rayon;                 /* 1: fentre 3x3, 2: fentre 5x5 */
+  int32_t (*marque)(uint8_t *F, int32_t x, int32_t rs, int32_t N);
+  int32_t (*efface)(uint8_t *F, int32_t x, int32_t rs, int32_t N);
+  uint8_t *tab;                  /* 0: non calcul, 1: conserv, 2: effac */
+} regle2d;
+
+static int32_t tpav_marque(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return F[x] && bordext4(F, x, rs, N); }
+static int32_t tpav_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return (F[x] == 2) && !pav_multiple(F, x, rs, N); }
+
+static int32_t teck_marque(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return F[x] && (nbvois4(F, x, rs, N) == 4); }
+static int32_t teck_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return (F[x] == 1) && simple8(F, x, rs, N) && eck_perfect(F, x, rs, N); }
+
+static int32_t tguohall1_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && bordext4(F, x, rs, N) && (nbvois8(F, x, rs, N) > 2) && 
+    (crossing_nb(F, x, rs, N) == 1) && !guohall_L(F, x, rs, N);
+}
+static int32_t tguohall2_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && bordext4(F, x, rs, N) && (nbvois8(F, x, rs, N) > 2) && 
+    (crossing_nb(F, x, rs, N) == 1) && !guohall_d1(F, x, rs, N) &&
+    !guohall_d2(F, x, rs, N) && !guohall_d3(F, x, rs, N);
+}
+static int32_t tguohall3_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return tguohall2_efface(F, x, rs, N) || 
+    (F[x] && (guohall_b1(F, x, rs, N) || guohall_b2(F, x, rs, N)));
+}
+
+static int32_t tchinwan_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && (chinwan_match1(F, x, rs, N) || chinwan_match2(F, x, rs, N)) &&
+    !chinwan_match3(F, x, rs, N);
+}
+
+static int32_t tjang_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && 
+    (jang_match1(F, x, rs, N) || jang_match5(F, x, rs, N) || jang_match9(F, x, rs, N) ||
+     jang_match13(F, x, rs, N) || jang_match17(F, x, rs, N)) &&
+    !jang_match21(F, x, rs, N) && !jang_match22(F, x, rs, N) && !jang_match23(F, x, rs, N) &&
+    !jang_match24(F, x, rs, N) && !jang_match25(F, x, rs, N) && !jang_match26(F, x, rs, N) &&
+    !jang_match27(F, x, rs, N);
+}
+static int32_t tjangcor_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && 
+    (jang_match1(F, x, rs, N) || jang_match5(F, x, rs, N) || jang_match9(F, x, rs, N) ||
+     jang_match13(F, x, rs, N) || jang_match17(F, x, rs, N)) &&
+    !jang_match21(F, x, rs, N) && !jang_match22(F, x, rs, N) && !jang_match23(F, x, rs, N) &&
+    !jang_match24(F, x, rs, N) && !jang_match25(F, x, rs, N) && !jang_match26(F, x, rs, N) &&
+    !jang_match27b(F, x, rs, N) && !jang_match28b(F, x, rs, N);
+}
+
+static int32_t tchoy_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && 
+    (choy_match1(F, x, rs, N) || choy_match5(F, x, rs, N) || choy_match9(F, x, rs, N)) &&
+    !choy_matchb1(F, x, rs, N) && !choy_matchb2(F, x, rs, N) && !choy_matchb3(F, x, rs, N) &&
+    !choy_matchb7(F, x, rs, N) && !choy_matchb8(F, x, rs, N) && !choy_matchb11(F, x, rs, N) &&
+    !choy_matchb21(F, x, rs, N) && !choy_matchb22(F, x, rs, N) && !choy_matchb23(F, x, rs, N) &&
+    !choy_matchb24(F, x, rs, N);
+}
+
+static int32_t tmanz1_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return F[x] && (mb_match1(F, x, rs, N) || mb_match2(F, x, rs, N)) && !mb_match3(F, x, rs, N); }
+static int32_t tmanz2_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return F[x] && mb_match1(F, x, rs, N) && !mb_match3(F, x, rs, N); }
+
+static int32_t thall1_marque(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && (nbvois8(F, x, rs, N) > 1) && (nbvois8(F, x, rs, N) < 7) && 
+    (crossing_nb(F, x, rs, N) == 1);
+}
+static int32_t thall2_marque(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && (nbvois8(F, x, rs, N) > 2) && (nbvois8(F, x, rs, N) < 7) && 
+    (crossing_nb(F, x, rs, N) == 1);
+}
+static int32_t thall_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return (F[x] == 2) && !hall_match1(F, x, rs, N) && !hall_match2(F, x, rs, N) && 
+    !hall_match3(F, x, rs, N);
+}
+
+static int32_t twutsai_efface(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ 
+  return F[x] && 
+    (wutsai_match1(F, x, rs, N) || wutsai_match2(F, x, rs, N) || wutsai_match3(F, x, rs, N) ||
+     wutsai_match4(F, x, rs, N) || wutsai_match5(F, x, rs, N) || wutsai_match6(F, x, rs, N) ||
+     wutsai_match7(F, x, rs, N) || wutsai_match8(F, x, rs, N) || wutsai_match9(F, x, rs, N) ||
+     wutsai_match10(F, x, rs, N) || wutsai_match11(F, x, rs, N));
+}
+
+static int32_t tros_north(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return (F[x] == 1) && simple8(F, x, rs, N) && ros_north(F, x, rs, N) && !ros_match(F, x, rs, N); }
+static int32_t tros_south(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return (F[x] == 1) && simple8(F, x, rs, N) && ros_south(F, x, rs, N) && !ros_match(F, x, rs, N); }
+static int32_t tros_east(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return (F[x] == 1) && simple8(F, x, rs, N) && ros_east(F, x, rs, N) && !ros_match(F, x, rs, N); }
+static int32_t tros_west(uint8_t *F, int32_t x, int32_t rs, int32_t N)
+{ return (F[x] == 1) && simple8(F, x, rs, N) && ros_west(F, x, rs, N) && !ros_match(F, x, rs, N); }
+
+static regle2d tab_pavlidis[1] =  {{2, tpav_marque, tpav_efface, NULL}};
+static regle2d tab_eckhardt[1] =  {{2, teck_marque, teck_efface, NULL}};
+static regle2d tab_rutovitz[1] =  {{2, NULL, rutovitz_match, NULL}};
+static regle2d tab_zhangwang[1] = {{2, NULL, zhangwang_match, NULL}};
+static regle2d tab_guohall1[1] =  {{2, NULL, tguohall1_efface, NULL}};
+static regle2d tab_guohall2[1] =  {{2, NULL, tguohall2_efface, NULL}};
+static regle2d tab_guohall3[1] =  {{2, NULL, tguohall3_efface, NULL}};
+static regle2d tab_chinwan[1] =   {{2, NULL, tchinwan_efface, NULL}};
+static regle2d tab_jang[1] =      {{2, NULL, tjang_efface, NULL}};
+static regle2d tab_jangcor[1] =   {{2, NULL, tjangcor_efface, NULL}};
+static regle2d tab_choy[1] =      {{2, NULL, tchoy_efface, NULL}};
+static regle2d tab_manz1[1] =     {{2, NULL, tmanz1_efface, NULL}};
+static regle2d tab_manz2[1] =     {{2, NULL, tmanz2_efface, NULL}};
+static regle2d tab_hall1[1] =     {{2, thall1_marque, thall_efface, NULL}};
+static regle2d tab_hall2[1] =     {{2, thall2_marque, thall_efface, NULL}};
+static regle2d tab_wutsai[1] =    {{2, NULL, twutsai_efface, NULL}};
+static regle2d tab_rosenfeld[4] = {{1, NULL, tros_north, NULL}, {1, NULL, tros_south, NULL},
+                                   {1, NULL, tros_east, NULL}, {1, NULL, tros_west, NULL}};
+
+/* ==================================== */
+static regle2d *lskeltab_regles(int32_t mode, int32_t *nregles)
+/* ==================================== */
+// retourne les rgles (sous-itrations) d'une tape de l'algorithme numro
+// mode (numrotation de skelpar), NULL si l'algorithme n'a pas de version table
+{
+  *nregles = 1;
+  switch (mode)
+  {
+  case 0: return tab_pavlidis;
+  case 1: return tab_eckhardt;
+  case 5: return tab_rutovitz;
+  case 6: return tab_zhangwang;
+  case 8: return tab_guohall1;
+  case 9: return tab_guohall2;
+  case 10: return tab_guohall3;
+  case 11: return tab_chinwan;
+  case 12: return tab_jang;
+  case 13: return tab_jangcor;
+  case 16: return tab_choy;
+  case 17: return tab_manz1;
+  case 18: return tab_hall1;
+  case 19: return tab_hall2;
+  case 20: return tab_wutsai;
+  case 21: return tab_manz2;
+  case 24: *nregles = 4; return tab_rosenfeld;
+  default: return NULL;
+  }
+} /* lskeltab_regles() */
+
+/* ==================================== */
+static uint8_t lskeltab_calcule(regle2d *r, uint32_t code)
+/* ==================================== */
+// calcule la dcision de la rgle r pour la configuration code (point central
+// compris) : 2 si le point central est effac, 1 sinon
+{
+  uint8_t S[TAB_RS * TAB_RS];
+  int32_t w = r->rayon + r->rayon + 1;
+  int32_t dx, dy, x;
+
+  memset(S, 0, TAB_RS * TAB_RS);
+  for (dx = -r->rayon; dx <= r->rayon; dx++)
+    for (dy = -r->rayon; dy <= r->rayon; dy++)
+      if (code & (1 << ((dx + r->rayon) * w + dy + r->rayon)))
+	S[TAB_CENTRE + dy*TAB_RS + dx] = 1;
+  if (r->marque != NULL) // les marques ne sont lues qu' distance 1
+    for (dy = -1; dy <= 1; dy++)
+      for (dx = -1; dx <= 1; dx++)
+      {
+	x = TAB_CENTRE + dy*TAB_RS + dx;
+	if (r->marque(S, x, TAB_RS, TAB_RS * TAB_RS)) S[x] = 2;
+      }
+  return r->efface(S, TAB_CENTRE, TAB_RS, TAB_RS * TAB_RS) ? 2 : 1;
+} /* lskeltab_calcule() */
+
+/* ==================================== */
+static uint8_t lskeltab_decision(regle2d *r, uint32_t k, uint32_t code)
+/* ==================================== */
+// dcision de la rgle r pour la configuration code, d'indice k dans la 
+// table, calcule au premier accs. Les threads remplissent la table en 
+// parallle : ses entres sont lues et crites atomiquement.
+{
+  uint8_t d = LitAtomique(r->tab[k]);
+  if (!d)
+  {
+    d = lskeltab_calcule(r, code);
+    EcritAtomique(r->tab[k], d);
+  }
+  return d;
+} /* lskeltab_decision() */
+
+/* ==================================== */
+static int32_t lskeltab_alloue(regle2d *r)
+/* ==================================== */
+// alloue la table de la rgle r si ce n'est pas dj fait ; retourne 0 en
+// cas d'chec. Les tables sont partages par les appels concurrents (cf. 
+// lskelstack) : le pointeur n'est crit que dans la section critique, et 
+// publi aprs l'initialisation de la table.
+{
+  int32_t w = r->rayon + r->rayon + 1, ret = 1;
+  uint8_t *tab;
+
+  if (LitPublie(r->tab) != NULL) return 1;
+#ifdef _OPENMP
+#pragma omp critical (lskeltab_alloc)
+#endif
+  if (r->tab == NULL)
+  {
+    tab = (uint8_t *)calloc(1, (size_t)1 << (w*w - 1));
+    if (tab == NULL)
+    {
+      fprintf(stderr, "lskeltab_alloue: malloc failed\n");
+      ret = 0;
+    }
+    else Publie(r->tab, tab);
+  }
+  return ret;
+} /* lskeltab_alloue() */
+
+/* ==================================== */
+static int32_t lskeltab_etape(
+  regle2d *r, 
+  uint8_t *F,                    /* image (0/1), sans objet  moins de r du bord */
+  uint8_t *I,                    /* image d'inhibition ou NULL */
+  Piles *L,                      /* une pile par thread, vide */
+  int32_t rs, int32_t y0, int32_t y1)
+/* ==================================== */
+// applique la rgle r en parallle aux points de F des lignes y0  y1 ;
+// retourne le nombre de points effacs, -1 en cas d'chec.
+// Avec OpenMP, les lignes sont rparties en bandes entre les threads ; chaque
+// thread a ses codes de colonnes (C) et sa pile de points effacs (L->P[t]),
+// applique une fois que tous les threads ont fini de lire F. Les piles sont
+// cres par l'appelant et gardent leur capacit d'une tape  l'autre.
+{
+  int32_t w = r->rayon + r->rayon + 1;
+  int32_t c = r->rayon * w + r->rayon;      /* bit du point central */
+  uint32_t masque = (1 << c) - 1;
+  int32_t ntot = 0, echec = 0;
+
+  if (!lskeltab_alloue(r)) return -1;
+
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:ntot)
+#endif
+  {
+  int32_t i, k, x, y;
+#ifdef _OPENMP
+  Pile *E = L->P[omp_get_thread_num()];
+#else
+  Pile *E = L->P[0];
+#endif
+  uint8_t *C = (uint8_t *)malloc(rs);
+  uint8_t *P;
+  uint32_t code;
+  uint64_t a, b, e;
+  uint8_t d;
+
+  if (C == NULL)
+  { // le thread participe  la boucle sans rien calculer
+    fprintf(stderr, "lskeltab_etape: malloc failed\n");
+    EcritAtomique(echec, 1);
+  }
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+  for (y = y0; y <= y1; y++)
+  {
+    if (C == NULL) continue;
+    P = F + y*rs;
+    if (w == 5)
+    {
+      // codes de colonnes calculs 8 par 8 : chaque octet (0 ou 1) d'un mot de
+      // 64 bits reoit le code de sa colonne, qui ne dborde pas sur le suivant
+      for (x = 0; x + 8 <= rs; x += 8)
+      {
+	memcpy(&a, P+x-rs-rs, 8); memcpy(&b, P+x-rs, 8); memcpy(&e, P+x, 8);
+	a = a | (b << 1) | (e << 2);
+	memcpy(&b, P+x+rs, 8); memcpy(&e, P+x+rs+rs, 8);
+	a = a | (b << 3) | (e << 4);
+	memcpy(C+x, &a, 8);
+      }
+      for (; x < rs; x++)
+	C[x] = P[x-rs-rs] | (P[x-rs] << 1) | (P[x] << 2) | (P[x+rs] << 3) | (P[x+rs+rs] << 4);
+      for (x = 2; x < rs - 2; x++)
+	if (P[x])
+	{
+	  code = C[x-2] | (C[x-1] << 5) | (C[x] << 10) | (C[x+1] << 15) | ((uint32_t)C[x+2] << 20);
+	  k = ((code >> (c + 1)) << c) | (code & masque);
+	  d = lskeltab_decision(r, k, code);
+	  if ((d == 2) && !(I && I[y*rs + x])) PilePush(E, y*rs + x);
+	}
+    }
+    else
+    {
+      for (x = 0; x + 8 <= rs; x += 8)
+      {
+	memcpy(&a, P+x-rs, 8); memcpy(&b, P+x, 8); memcpy(&e, P+x+rs, 8);
+	a = a | (b << 1) | (e << 2);
+	memcpy(C+x, &a, 8);
+      }
+      for (; x < rs; x++)
+	C[x] = P[x-rs] | (P[x] << 1) | (P[x+rs] << 2);
+      for (x = 1; x < rs - 1; x++)
+	if (P[x])
+	{
+	  code = C[x-1] | (C[x] << 3) | (C[x+1] << 6);
+	  k = ((code >> (c + 1)) << c) | (code & masque);
+	  d = lskeltab_decision(r, k, code);
+	  if ((d == 2) && !(I && I[y*rs + x])) PilePush(E, y*rs + x);
+	}
+    }
+  } // fin de la boucle parallle : barrire implicite
+  for (i = 0; i < E->Sp; i++) F[E->Pts[i]] = 0;
+  ntot += (int32_t)E->Sp;
+  PileFlush(E);
+  free(C);
+  }
+  if (echec) return -1;
+  return ntot;
+} /* lskeltab_etape() */
+
+/* ==================================== */
+static int32_t lskeltab_front(
+  regle2d *regles, int32_t nregles, 
+  uint8_t *F,                    /* image (0/1), sans objet  moins de marge du bord */
+  uint8_t *I,                    /* image d'inhibition ou NULL */
+  int32_t rs, int32_t N, int32_t marge, int32_t nsteps)
+/* ==================================== */
+/*
+  Version "front actif" des tapes de lskeltab : la rgle k n'est value 
+  qu'aux points de la liste A[k]. Au dpart, A[k] contient tous les points 
+  objet non inhibs ; ensuite, un point n'est remis dans les listes que si 
+  un point de sa fentre (rayon marge) a t effac. Un point qui n'est pas 
+  dans A[k] a donc la mme fentre que lors de sa dernire valuation par la 
+  rgle k, qui l'a conserv : le rsultat est celui de lskeltab_etape, mais 
+  le travail par tape est proportionnel au nombre de points effacs au 
+  voisinage plutt qu' la taille de l'image.
+  Le bit k de M[x] vaut 1 ssi x est dans A[k]. Retourne le nombre d'tapes,
+  -1 en cas d'chec.
+*/
+{
+  Lifo *A[4], *D;
+  uint8_t *M;
+  uint8_t tous = (1 << nregles) - 1;
+  int32_t i, k, x, y, dx, dy, w, c, step, nonstab;
+  uint32_t code, masque;
+  uint8_t d;
+
+  assert(nregles <= 4);
+  M = (uint8_t *)calloc(1, N);
+  D = CreeLifoVide(N);
+  for (k = 0, i = 1; k < nregles; k++) 
+    if ((A[k] = CreeLifoVide(N)) == NULL) i = 0;
+  if ((M == NULL) || (D == NULL) || !i)
+  {
+    fprintf(stderr, "lskeltab_front: malloc failed\n");
+    step = -1;
+    goto fin;
+  }
+  for (x = 0; x < N; x++)
+    if (F[x] && !(I && I[x]))
+    {
+      for (k = 0; k < nregles; k++) LifoPush(A[k], x);
+      M[x] = tous;
+    }
+
+  step = 0;
+  nonstab = 1;
+  while (nonstab && (step < nsteps))
+  {
+    nonstab = 0;
+    step++;
+#ifdef VERBOSE
+    printf("step %d\n", step);
+#endif
+    for (k = 0; k < nregles; k++)
+    {
+      if (!lskeltab_alloue(&regles[k])) { step = -1; goto fin; }
+      w = regles[k].rayon + regles[k].rayon + 1;
+      c = regles[k].rayon * w + regles[k].rayon;
+      masque = (1 << c) - 1;
+      while (!LifoVide(A[k]))
+      {
+	x = LifoPop(A[k]);
+	M[x] &= ~(1 << k);
+	if (!F[x]) continue;
+	for (code = 0, i = 0, dx = -regles[k].rayon; dx <= regles[k].rayon; dx++)
+	  for (dy = -regles[k].rayon; dy <= regles[k].rayon; dy++, i++)
+	    code |= (uint32_t)F[x + dy*rs + dx] << i;
+	i = ((code >> (c + 1)) << c) | (code & masque);
+	d = lskeltab_decision(&regles[k], i, code);
+	if (d == 2) LifoPush(D, x);
+      }
+      if (!LifoVide(D)) nonstab = 1;
+      for (i = 0; i < D->Sp; i++) F[D->Pts[i]] = 0;
+      while (!LifoVide(D))
+      {
+	x = LifoPop(D);
+	for (dy = -marge; dy <= marge; dy++)
+	  for (dx = -marge; dx <= marge; dx++)
+	  {
+	    y = x + dy*rs + dx;
+	    if (F[y] && (M[y] != tous) && !(I && I[y]))
+	    {
+	      for (i = 0; i < nregles; i++)
+		if (!(M[y] & (1 << i))) LifoPush(A[i], y);
+	      M[y] = tous;
+	    }
+	  }
+      }
+    }
+  }
+
+fin:
+  free(M);
+  if (D != NULL) LifoTermine(D);
+  for (k = 0; k < nregles; k++) if (A[k] != NULL) LifoTermine(A[k]);
+  return step;
+} /* lskeltab_front() */
+
+/* ==================================== */
+int32_t lskeltab_mode(int32_t mode)
+/* ==================================== */
+// retourne 1 si l'algorithme numro mode (numrotation de skelpar) a une
+// version table, 0 sinon
+{
+  int32_t n;
+  return lskeltab_regles(mode, &n) != NULL;
+} /* lskeltab_mode() */
+
+/* ==================================== */
+static int32_t lskeltab_gen(struct xvimage *image, 
+			    int32_t mode,
+			    int32_t nsteps,
+			    struct xvimage *inhibit,
+			    int32_t front)
+/* ==================================== */
+/*
+  Amincissement parallle par l'algorithme numro mode (numrotation de 
+  skelpar), avec les rgles compiles en tables (voir ci-dessus). 
+  Le rsultat est celui de la fonction lskel* correspondante lorsque l'objet 
+  est  au moins 2 pixels du bord. L'algorithme travaille sur une copie 
+  entoure d'un cadre nul de la largeur de la fentre, de sorte que les 
+  points proches du bord sont traits comme les autres.
+  Les points de l'image inhibit, si elle est donne, ne sont pas effacs.
+  Si front vaut 1, les tapes sont calcules par lskeltab_front, sinon par
+  balayage des lignes de l'objet (lskeltab_etape).
+*/
+#undef F_NAME
+#define F_NAME "lskeltab"
+{ 
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  uint8_t *F = UCHARDATA(image);
+  int32_t rs2, cs2, N2, i, y, y0, y1, k, n, nregles, marge, step, nonstab;
+  regle2d *regles;
+  uint8_t *G, *I = NULL;
+  Piles *L;
+
+  if ((regles = lskeltab_regles(mode, &nregles)) == NULL)
+  {
+    fprintf(stderr, "%s: mode %d has no table version\n", F_NAME, mode);
+    return 0;
+  }
+  if ((depth(image) != 1) || (datatype(image) != VFF_TYP_1_BYTE))
+  {
+    fprintf(stderr, "%s: only 2D byte images are allowed\n", F_NAME);
+    return 0;
+  }
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs) || (datatype(inhibit) != VFF_TYP_1_BYTE)))
+  {
+    fprintf(stderr, "%s: incompatible inhibit image\n", F_NAME);
+    return 0;
+  }
+
+  // copie cadre et normalise (0/1) de l'image
+  for (marge = 0, k = 0; k < nregles; k++) marge = max(marge, regles[k].rayon);
+  rs2 = rs + 2*marge; cs2 = cs + 2*marge; N2 = rs2 * cs2;
+  G = (uint8_t *)calloc(1, N2);
+  if (inhibit != NULL) I = (uint8_t *)calloc(1, N2);
+  if ((G == NULL) || ((inhibit != NULL) && (I == NULL)))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    return 0;
+  }
+  for (y = 0; y < cs; y++)
+    for (i = 0; i < rs; i++)
+    {
+      G[(y+marge)*rs2 + i+marge] = (F[y*rs + i] != 0);
+      if (I) I[(y+marge)*rs2 + i+marge] = (UCHARDATA(inhibit)[y*rs + i] != 0);
+    }
+
+  // lignes extrmes de l'objet, qui ne peut que diminuer
+  for (y0 = 0; (y0 < cs2) && !memchr(G + y0*rs2, 1, rs2); y0++) ;
+  for (y1 = cs2 - 1; (y1 > y0) && !memchr(G + y1*rs2, 1, rs2); y1--) ;
+
+  if (nsteps == -1) nsteps = 1000000000;
+
+  if (front)
+    step = lskeltab_front(regles, nregles, G, I, rs2, N2, marge, nsteps);
+  else
+  {
+#ifdef _OPENMP
+    L = CreePiles(omp_get_max_threads(), rs2);
+#else
+    L = CreePiles(1, rs2);
+#endif
+    if (L == NULL)
+    {
+      fprintf(stderr, "%s: malloc failed\n", F_NAME);
+      return 0;
+    }
+    step = 0;
+    nonstab = 1;
+    while (nonstab && (step < nsteps))
+    {
+      nonstab = 0;
+      step++;
+#ifdef VERBOSE
+      printf("step %d\n", step);
+#endif
+      if (y0 < cs2)
+	for (k = 0; (k < nregles) && (step > 0); k++)
+	{
+	  n = lskeltab_etape(&regles[k], G, I, L, rs2, y0, y1);
+	  if (n < 0) step = -1;
+	  else if (n) nonstab = 1;
+	}
+      if (step < 0) break;
+    }
+    PilesTermine(L);
+  }
+  if (step < 0)
+  {
+    free(G);
+    if (I) free(I);
+    return 0;
+  }
+
+#ifdef VERBOSE1
+    printf("number of steps: %d\n", step);
+#endif
+
+  for (y = 0; y < cs; y++)
+    for (i = 0; i < rs; i++)
+      F[y*rs + i] = G[(y+marge)*rs2 + i+marge] ? 255 : 0;
+
+  free(G);
+  if (I) free(I);
+  return(1);
+} /* lskeltab_gen() */
+
+/* ==================================== */
+int32_t lskeltab(struct xvimage *image, 
+		 int32_t mode,
+		 int32_t nsteps,
+		 struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskeltab_gen(image, mode, nsteps, inhibit, 0);
+} /* lskeltab() */
+
+/* ==================================== */
+int32_t lskeltabfront(struct xvimage *image, 
+		      int32_t mode,
+		      int32_t nsteps,
+		      struct xvimage *inhibit)
+/* ==================================== */
+// comme lskeltab, en ne rvaluant  chaque tape que les points voisins de
+// points effacs (voir lskeltab_front) ;  prfrer pour les objets minces
+{
+  return lskeltab_gen(image, mode, nsteps, inhibit, 1);
+} /* lskeltabfront() */
+
+/* ==================================== */
+/* ==================================== */
+/*   MK2, AK2, NK2 : VERSIONS BIT A BIT */
+/* ==================================== */
+/* ==================================== */
+/*
+  Les ensembles sont reprsents par des plans de bits : le pixel (x,y) est 
+  le bit x%64 du mot x/64 de la ligne y. Chaque ligne est borde d'un mot nul 
+   gauche et  droite, et le plan d'une ligne nulle en haut et en bas : les 
+  voisins des 64 pixels d'un mot s'obtiennent par dcalages, sans test de 
+  bord (l'extrieur de l'image est nul, comme avec lskelframe).
+
+  Le test de point simple (8-connexit) est la forme boolenne du nombre de
+  connexit de Hilditch : x est simple ssi X_H(x) = 1, avec 
+    X_H(x) = somme pour k = 0..3 de [ !v(2k) et (v(2k+1) ou v(2k+2)) ]
+  (voisins numrots comme dans extract_vois, v(8) = v(0)), ce qui quivaut 
+   t8 = t4b = 1. Les masques bertrand_match1/2/3 et les dilatations et 
+  rosions se rduisent de mme  des oprations logiques sur les mots des 
+  lignes y-1, y et y+1. Le rsultat est identique  celui des versions 
+  octet par octet.
+*/
+
+#define BIT_E(p,w) (((p)[w] >> 1) | ((p)[(w)+1] << 63))  /* voisin est */
+#define BIT_O(p,w) (((p)[w] << 1) | ((p)[(w)-1] >> 63))  /* voisin ouest */
+
+/* les 8 voisins du mot w de la ligne c (n: ligne au-dessus, s: au-dessous) */
+#define BIT_VOIS(n,c,s,w) \
+  e = BIT_E(c,w); o = BIT_O(c,w); nn = (n)[w]; ss = (s)[w]; \
+  ne = BIT_E(n,w); no = BIT_O(n,w); se = BIT_E(s,w); so = BIT_O(s,w)
+
+/* ==================================== */
+static uint64_t *bitplan(int32_t ws, int32_t cs)
+/* ==================================== */
+// alloue un plan nul de cs lignes de ws mots (bords compris), NULL si echec
+{
+  return (uint64_t *)calloc((size_t)(cs + 2) * ws, sizeof(uint64_t));
+} /* bitplan() */
+
+/* ==================================== */
+static void bitpack(uint8_t *F, int32_t rs, int32_t cs, uint64_t *P, int32_t ws)
+/* ==================================== */
+// P := points non nuls de F
+{
+  int32_t x, y;
+  uint64_t *L;
+  for (y = 0; y < cs; y++)
+  {
+    L = P + (y+1)*ws + 1;
+    memset(L, 0, (ws - 2) * sizeof(uint64_t));
+    for (x = 0; x < rs; x++)
+      if (F[y*rs + x]) L[x >> 6] |= (uint64_t)1 << (x & 63);
+  }
+} /* bitpack() */
+
+/* ==================================== */
+static void bitunpack(uint64_t *P, int32_t ws, uint8_t *F, int32_t rs, int32_t cs)
+/* ==================================== */
+// F := 255 sur les points de P, 0 ailleurs
+{
+  int32_t x, y;
+  uint64_t *L;
+  for (y = 0; y < cs; y++)
+  {
+    L = P + (y+1)*ws + 1;
+    for (x = 0; x < rs; x++)
+      F[y*rs + x] = ((L[x >> 6] >> (x & 63)) & 1) ? 255 : 0;
+  }
+} /* bitunpack() */
+
+/* ==================================== */
+static void bitsimples(uint64_t *S, uint64_t *X, uint64_t *P, int32_t ws, int32_t cs)
+/* ==================================== */
+// P := points de S \ X simples pour S (X peut tre NULL)
+{
+  int32_t y, w, nm = ws - 2;
+  uint64_t *n, *c, *s, *p, *x;
+  uint64_t e, o, nn, ss, ne, no, se, so, b0, b1, b2, b3;
+#ifdef _OPENMP
+#pragma omp parallel for private(w, n, c, s, p, x, e, o, nn, ss, ne, no, se, so, b0, b1, b2, b3)
+#endif
+  for (y = 0; y < cs; y++)
+  {
+    c = S + (y+1)*ws + 1; n = c - ws; s = c + ws;
+    p = P + (y+1)*ws + 1;
+    x = X ? X + (y+1)*ws + 1 : NULL;
+    for (w = 0; w < nm; w++)
+    {
+      if (!c[w]) { p[w] = 0; continue; }
+      BIT_VOIS(n,c,s,w);
+      b0 = ~e & (ne | nn);
+      b1 = ~nn & (no | o);
+      b2 = ~o & (so | ss);
+      b3 = ~ss & (se | e);
+      p[w] = c[w] & ((b0 ^ b1) ^ (b2 ^ b3)) & ~(b0 & b1) & ~(b2 & b3); // X_H = 1
+      if (x) p[w] &= ~x[w];
+    }
+  }
+} /* bitsimples() */
+
+/* ==================================== */
+static int32_t bitretire(uint64_t *S, uint64_t *P, uint64_t *Snew, int32_t ws, int32_t cs, int32_t sym)
+/* ==================================== */
+// Snew := [S \ P] \cup R, o R est l'ensemble des points de P qui s'apparient 
+// avec le masque C (bertrand_match3, sym = 1) ou avec les masques de 
+// bertrand_match1 et bertrand_match2 (sym = 0) ; retourne 1 si Snew != S
+{
+  int32_t y, w, nm = ws - 2, nonstab = 0;
+  uint64_t *n, *c, *s, *p, *pn, *ps, *r;
+  uint64_t e, o, nn, ss, ne, no, se, so, R;
+#ifdef _OPENMP
+#pragma omp parallel for private(w, n, c, s, p, pn, ps, r, e, o, nn, ss, ne, no, se, so, R) reduction(|:nonstab)
+#endif
+  for (y = 0; y < cs; y++)
+  {
+    c = S + (y+1)*ws + 1; n = c - ws; s = c + ws;
+    p = P + (y+1)*ws + 1; pn = p - ws; ps = p + ws;
+    r = Snew + (y+1)*ws + 1;
+    for (w = 0; w < nm; w++)
+    {
+      if (!p[w]) { r[w] = c[w]; continue; }
+      BIT_VOIS(n,c,s,w);
+      R = BIT_E(p,w) & (ne | nn) & (ss | se);                    // 2  l'est
+      R |= pn[w] & (no | o) & (e | ne);                          // 2 au nord
+      if (sym)
+      {
+	R |= ps[w] & (se | e) & (o | so);                          // 2 au sud
+	R |= BIT_O(p,w) & (so | ss) & (nn | no);                   // 2  l'ouest
+      }
+      r[w] = (c[w] & ~p[w]) | (p[w] & R);
+      if (r[w] != c[w]) nonstab = 1;
+    }
+  }
+  return nonstab;
+} /* bitretire() */
+
+/* ==================================== */
+int32_t lskelMK2b(struct xvimage *image, 
+		  int32_t nsteps,
+		  struct xvimage *inhibit)
+/* ==================================== */
+// version bit  bit de lskelMK2
+#undef F_NAME
+#define F_NAME "lskelMK2b"
+{ 
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  int32_t ws = (rs + 63) / 64 + 2; /* mots par ligne, bords compris */
+  int32_t nm = ws - 2;
+  uint64_t *S, *P, *T, *I = NULL;
+  uint64_t *n, *c, *s, *p, *t, *i;
+  uint64_t e, o, nn, ss, ne, no, se, so, D;
+  int32_t y, w, step, nonstab;
+
+  if (inhibit != NULL) 
+  {
+    if ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs))
+    {
+      fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+      return 0;
+    }
+    if (datatype(inhibit) != VFF_TYP_1_BYTE)
+    {
+      fprintf(stderr, "%s: incompatible image types\n", F_NAME);
+      return 0;
+    }
+    I = bitplan(ws, cs);
+  }
+
+  if (nsteps == -1) nsteps = 1000000000;
+
+  S = bitplan(ws, cs);
+  P = bitplan(ws, cs);
+  T = bitplan(ws, cs);
+  if (!S || !P || !T || ((inhibit != NULL) && !I))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    free(S); free(P); free(T); free(I);
+    return 0;
+  }
+  if (I) bitpack(UCHARDATA(inhibit), rs, cs, I, ws);
+  bitpack(UCHARDATA(image), rs, cs, S, ws);
+
+  step = 0;
+  nonstab = 1;
+  while (nonstab && (step < nsteps))
+  {
+    nonstab = 0;
+    step++;
+#ifdef VERBOSE
+    printf("step %d\n", step);
+#endif
+    bitsimples(S, NULL, P, ws, cs);                      // P := pixels simples pour S
+    bitretire(S, P, T, ws, cs, 1);                       // T := [S \ P] \cup R
+    if (I)                                               // T := T \cup I
+    {
+#ifdef _OPENMP
+#pragma omp parallel for private(w, t, i)
+#endif
+      for (y = 0; y < cs; y++)
+      {
+	t = T + (y+1)*ws + 1; i = I + (y+1)*ws + 1;
+	for (w = 0; w < nm; w++) t[w] |= i[w];
+      }
+    }
+#ifdef _OPENMP
+#pragma omp parallel for private(w, n, c, s, p, t, e, o, nn, ss, ne, no, se, so, D) reduction(|:nonstab)
+#endif
+    for (y = 0; y < cs; y++)                             // S := T \cup [S \ (T \oplus \Gamma_8*)]
+    {
+      t = T + (y+1)*ws + 1; n = t - ws; s = t + ws; 
+      c = S + (y+1)*ws + 1; p = t;
+      for (w = 0; w < nm; w++)
+      {
+	if (!c[w]) continue;
+	BIT_VOIS(n,p,s,w);
+	D = e | o | nn | ss | ne | no | se | so;
+	D = c[w] & (t[w] | ~D);
+	if (D != c[w]) { c[w] = D; nonstab = 1; }
+      }
+    }
+  }
+
+#ifdef VERBOSE1
+    printf("number of steps: %d\n", step);
+#endif
+
+  bitunpack(S, ws, UCHARDATA(image), rs, cs);
+  free(S); free(P); free(T);
+  if (I) free(I);
+  return(1);
+} /* lskelMK2b() */
+
+/* ==================================== */
+int32_t lskelAK2b(struct xvimage *image, 
+		  int32_t nsteps,
+		  struct xvimage *inhibit)
+/* ==================================== */
+// version bit  bit de lskelAK2
+#undef F_NAME
+#define F_NAME "lskelAK2b"
+{ 
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  int32_t ws = (rs + 63) / 64 + 2; /* mots par ligne, bords compris */
+  int32_t nm = ws - 2;
+  uint64_t *S, *S2, *P, *T, *E, *K, *tmp;
+  uint64_t *c, *k, *x;
+  int32_t y, w, step, nonstab;
+
+  if (inhibit != NULL) 
+  {
+    if ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs))
+    {
+      fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+      return 0;
+    }
+    if (datatype(inhibit) != VFF_TYP_1_BYTE)
+    {
+      fprintf(stderr, "%s: incompatible image types\n", F_NAME);
+      return 0;
+    }
+  }
+
+  if (nsteps == -1) nsteps = 1000000000;
+
+  S = bitplan(ws, cs);
+  S2 = bitplan(ws, cs);
+  P = bitplan(ws, cs);
+  T = bitplan(ws, cs);
+  E = bitplan(ws, cs);
+  K = bitplan(ws, cs);
+  if (!S || !S2 || !P || !T || !E || !K)
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    free(S); free(S2); free(P); free(T); free(E); free(K);
+    return 0;
+  }
+  bitpack(UCHARDATA(image), rs, cs, S, ws);
+  memcpy(T, S, (size_t)(cs + 2) * ws * sizeof(uint64_t)); // K := \emptyset ; T := S
+  if (inhibit != NULL) bitpack(UCHARDATA(inhibit), rs, cs, K, ws); // K := inhibit, fixe
+
+  step = 0;
+  nonstab = 1;
+  while (nonstab && (step < nsteps))
+  {
+    step++;
+#ifdef VERBOSE
+    printf("step %d\n", step);
+#endif
+    if (inhibit == NULL)
+    {
+      morpho_ero4b(T, E, rs, cs);                        // E := T \ominus \Gamma_4
+      morpho_dil4b(E, P, rs, cs);                        // P := E \oplus \Gamma_4
+#ifdef _OPENMP
+#pragma omp parallel for private(w, c, x, k)
+#endif
+      for (y = 0; y < cs; y++)                           // K := K \cup [T \ P]
+      {
+        c = P + (y+1)*ws + 1; x = T + (y+1)*ws + 1; k = K + (y+1)*ws + 1;
+        for (w = 0; w < nm; w++) k[w] |= x[w] & ~c[w];
+      }
+      tmp = T; T = E; E = tmp;                           // T := E
+    }
+    bitsimples(S, K, P, ws, cs);                         // P := pixels de S \ K simples pour S
+    nonstab = bitretire(S, P, S2, ws, cs, 1);            // S := [S \ P] \cup R
+    tmp = S; S = S2; S2 = tmp;
+  }
+
+#ifdef VERBOSE1
+    printf("number of steps: %d\n", step);
+#endif
+
+  bitunpack(S, ws, UCHARDATA(image), rs, cs);
+  free(S); free(S2); free(P); free(T); free(E); free(K);
+  return(1);
+} /* lskelAK2b() */
+
+/* ==================================== */
+int32_t lskelNK2b(struct xvimage *image, 
+		  int32_t nsteps,
+		  struct xvimage *inhibit)
+/* ==================================== */
+// version bit  bit de lskelNK2
+#undef F_NAME
+#define F_NAME "lskelNK2b"
+{ 
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  int32_t ws = (rs + 63) / 64 + 2; /* mots par ligne, bords compris */
+  uint64_t *S, *S2, *P, *I, *tmp;
+  int32_t step, nonstab;
+
+  if (inhibit == NULL)
+  {
+    fprintf(stderr, "%s: inhibit image (medial axis) must be present\n", F_NAME);
+    return 0;
+  }
+  if ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+
+  if (nsteps == -1) nsteps = 1000000000;
+
+  S = bitplan(ws, cs);
+  S2 = bitplan(ws, cs);
+  P = bitplan(ws, cs);
+  I = bitplan(ws, cs);
+  if (!S || !S2 || !P || !I)
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    free(S); free(S2); free(P); free(I);
+    return 0;
+  }
+  bitpack(UCHARDATA(image), rs, cs, S, ws);
+  bitpack(UCHARDATA(inhibit), rs, cs, I, ws);
+
+  step = 0;
+  nonstab = 1;
+  while (nonstab && (step < nsteps))
+  {
+    step++;
+#ifdef VERBOSE
+    printf("step %d\n", step);
+#endif
+    bitsimples(S, I, P, ws, cs);
+    nonstab = bitretire(S, P, S2, ws, cs, 0);
+    tmp = S; S = S2; S2 = tmp;
+  }
+
+#ifdef VERBOSE1
+    printf("number of steps: %d\n", step);
+#endif
+
+  bitunpack(S, ws, UCHARDATA(image), rs, cs);
+  free(S); free(S2); free(P); free(I);
+  return(1);
+} /* lskelNK2b() */
+
+/* ==================================== */
+/* ==================================== */
+/*        AMINCISSEMENT SEQUENTIEL      */
+/* ==================================== */
+/* ==================================== */
+
+/* ==================================== */
+int32_t lskelseq2(struct xvimage *image, 
+		  int32_t nsteps,
+		  struct xvimage *inhibit,
+		  int32_t algo)
+/* ==================================== */
+/*
+Amincissement squentiel guid par la distance euclidienne, 
+version 2D de lskelseq3 (voir lskelpar3d.c)
+Donnes: S, I (contrainte), algo (LSKEL_MK2, LSKEL_CK2 ou LSKEL_EK2)
+  D := carr de la distance euclidienne au fond (dist_quad)
+  F := points de bord de S \ I (D = 1), rangs par valeur de D
+  Tant que F non vide
+    x := point de F de plus petite distance (premier arriv)
+    si x simple pour S
+      si algo = EK2 et x point extrmit alors I := I \cup {x}
+      sinon S := S \ {x} ; F := F \cup (voisins de x dans S \ I)
+    sinon si algo = CK2 et T(x) > 1 (point de courbe) alors I := I \cup {x}
+Si nsteps >= 0, seuls les points de distance au plus nsteps sont traits.
+*/
+#undef F_NAME
+#define F_NAME "lskelseq2"
+{ 
+  int32_t i, j, n;
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  int32_t N = rs * cs;             /* taille image */
+  uint8_t *S = UCHARDATA(image);      /* l'image de depart */
+  uint8_t *I = NULL;
+  int32_t *D;
+  uint8_t *Q;
+  Seaux *F;
+  int32_t dmax, top, topb, nret = 0;
+
+  if ((algo != LSKEL_MK2) && (algo != LSKEL_CK2) && (algo != LSKEL_EK2))
+  {
+    fprintf(stderr, "%s: bad algorithm code: %d\n", F_NAME, algo);
+    return 0;
+  }
+  if (inhibit != NULL)
+  {
+    if ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs))
+    {
+      fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+      return 0;
+    }
+    I = UCHARDATA(inhibit);
+  }
+  else
+  {
+    I = (uint8_t *)calloc(N, 1);
+    if (I == NULL)
+    {
+      fprintf(stderr, "%s: malloc failed\n", F_NAME);
+      return 0;
+    }
+  }
+
+  for (i = 0; i < N; i++) if (S[i]) S[i] = 1; // normalize values
+
+  D = (int32_t *)malloc(N * sizeof(int32_t));
+  Q = (uint8_t *)calloc(N, 1);
+  if ((D == NULL) || (Q == NULL))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    if (D) free(D);
+    if (Q) free(Q);
+    if (inhibit == NULL) free(I);
+    return 0;
+  }
+  if (!dist_quad(S, D, rs, cs, 1))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    free(D); free(Q);
+    if (inhibit == NULL) free(I);
+    return 0;
+  }
+  dmax = 0;
+  for (i = 0; i < N; i++) if (D[i] > dmax) dmax = D[i];
+  if ((nsteps >= 0) && (nsteps < 46341) && (nsteps * nsteps < dmax)) dmax = nsteps * nsteps;
+  if ((F = CreeSeaux(dmax + 1)) == NULL)
+  {
+    fprintf(stderr, "%s: CreeSeaux failed\n", F_NAME);
+    free(D); free(Q);
+    if (inhibit == NULL) free(I);
+    return 0;
+  }
+
+  /* ================================================ */
+  /*               DEBUT ALGO                         */
+  /* ================================================ */
+
+  for (i = 0; i < N; i++)
+    if (S[i] && !I[i] && (D[i] == 1) && (dmax >= 1)) { SeauxPush(F, 1, i); Q[i] = 1; }
+
+  while (!SeauxVide(F))
+  {
+    i = (int32_t)SeauxPop(F, NULL); 
+    Q[i] = 0;
+    if (!S[i] || I[i]) continue;
+    if (simple8(S, i, rs, N))
+    {
+      if ((algo == LSKEL_EK2) && extremite8(S, i, rs, N)) { I[i] = 1; continue; }
+      S[i] = 0;
+      nret++;
+      for (n = 0; n < 8; n++)
+      {
+	j = voisin(i, n, rs, N);
+	if ((j != -1) && S[j] && !I[j] && !Q[j] && (D[j] <= dmax))
+	{
+	  SeauxPush(F, D[j], j);
+	  Q[j] = 1;
+	}
+      }
+    }
+    else if (algo == LSKEL_CK2)
+    {
+      top8(S, i, rs, N, &top, &topb);
+      if (top > 1) I[i] = 1;
+    }
+  }
+
+#ifdef VERBOSE1
+    printf("number of deleted points: %d\n", nret);
+#endif
+
+  for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
+
+  free(D); free(Q);
+  SeauxTermine(F);
+  if (inhibit == NULL) free(I);
+  return(1);
+} /* lskelseq2() */
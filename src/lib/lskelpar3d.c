@@ -44,11 +44,18 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <sys/types.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <mccodimage.h>
 #include <mcimage.h>
 #include <mctopo.h>
 #include <mctopo3d.h>
 #include <mcutil.h>
+#include <mclifo.h>
+#include <mcckpt.h>
+#include <mcmorpho.h>
+#include <mcdist.h>
+#include <mcsimd.h>
+#include <mctable.h>
 #include <lskelpar3d.h>
 
 #define S_OBJECT      1
@@ -92,15 +99,13 @@ int32_t trace = 1;
 #endif
 
 /* ==================================== */
-static void extract_vois(
-  uint8_t *img,          /* pointeur base image */
-  int32_t p,                       /* index du point */
+static void decalages_vois(
   int32_t rs,                      /* taille rangee */
   int32_t ps,                      /* taille plan */
-  int32_t N,                       /* taille image */
-  uint8_t *vois)    
+  int32_t off[3][27])
 /* 
-  retourne dans "vois" les valeurs des 27 voisins de p, dans l'ordre suivant: 
+  retourne dans "off[0]" les decalages (index) des 27 voisins d'un point, 
+  dans l'ordre suivant: 
 
                12      11      10       
                13       8       9
@@ -114,157 +119,53 @@ static void extract_vois(
                22      17      18
                23      24      25
 
-  le point p ne doit pas tre un point de bord de l'image
+  et dans "off[1]" (resp. "off[2]") ceux du voisinage transforme par 
+  l'isometrie qui echange les axes X et Z (resp. Y et Z, + symetries). 
+  Ces isometries sont des involutions. Les predicats match_vois* lisent et 
+  marquent l'image directement a travers ces tables, sans copie ni 
+  permutation du voisinage.
+
+  les points testes ne doivent pas tre des points de bord de l'image : 
+  les algorithmes travaillent sur une image dont les points objet ne sont 
+  pas sur le bord, cf. lskelframe
 */
 /* ==================================== */
 {
-#undef F_NAME
-#define F_NAME "extract_vois"
-  register uint8_t * ptr = img+p;
-  if ((p%rs==rs-1) || (p%ps<rs) || (p%rs==0) || (p%ps>=ps-rs) || 
-      (p < ps) || (p >= N-ps)) /* point de bord */
-  {
-    printf("%s: ERREUR: point de bord\n", F_NAME);
-    exit(0);
-  }
-  vois[ 0] = *(ptr+1);
-  vois[ 1] = *(ptr+1-rs);
-  vois[ 2] = *(ptr-rs);
-  vois[ 3] = *(ptr-rs-1);
-  vois[ 4] = *(ptr-1);
-  vois[ 5] = *(ptr-1+rs);
-  vois[ 6] = *(ptr+rs);
-  vois[ 7] = *(ptr+rs+1);
-
-  vois[ 8] = *(ptr-ps);
-  vois[ 9] = *(ptr-ps+1);
-  vois[10] = *(ptr-ps+1-rs);
-  vois[11] = *(ptr-ps-rs);
-  vois[12] = *(ptr-ps-rs-1);
-  vois[13] = *(ptr-ps-1);
-  vois[14] = *(ptr-ps-1+rs);
-  vois[15] = *(ptr-ps+rs);
-  vois[16] = *(ptr-ps+rs+1);
-
-  vois[17] = *(ptr+ps);
-  vois[18] = *(ptr+ps+1);
-  vois[19] = *(ptr+ps+1-rs);
-  vois[20] = *(ptr+ps-rs);
-  vois[21] = *(ptr+ps-rs-1);
-  vois[22] = *(ptr+ps-1);
-  vois[23] = *(ptr+ps-1+rs);
-  vois[24] = *(ptr+ps+rs);
-  vois[25] = *(ptr+ps+rs+1);
-
-  vois[26] = *(ptr);
-} /* extract_vois() */
-
-/* ==================================== */
-static void insert_vois(
-  uint8_t *vois,			
-  uint8_t *img,          /* pointeur base image */
-  int32_t p,                       /* index du point */
-  int32_t rs,                      /* taille rangee */
-  int32_t ps,                      /* taille plan */
-  int32_t N)                       /* taille image */    
-/* 
-  recopie vois dans le voisinage de p
-  le point p ne doit pas tre un point de bord de l'image
-*/
+  static const int8_t dx[27] = { 1, 1, 0,-1,-1,-1, 0, 1, 
+				  0, 1, 1, 0,-1,-1,-1, 0, 1, 
+				  0, 1, 1, 0,-1,-1,-1, 0, 1, 0 };
+  static const int8_t dy[27] = { 0,-1,-1,-1, 0, 1, 1, 1, 
+				  0, 0,-1,-1,-1, 0, 1, 1, 1, 
+				  0, 0,-1,-1,-1, 0, 1, 1, 1, 0 };
+  static const int8_t dz[27] = { 0, 0, 0, 0, 0, 0, 0, 0, 
+				 -1,-1,-1,-1,-1,-1,-1,-1,-1, 
+				  1, 1, 1, 1, 1, 1, 1, 1, 1, 0 };
+  int32_t k;
+  for (k = 0; k < 27; k++)
+  {
+    off[0][k] = dx[k] + dy[k] * rs + dz[k] * ps;
+    off[1][k] = dz[k] + dy[k] * rs + dx[k] * ps;  /* (x,y,z) -> (z,y,x) */
+    off[2][k] = dx[k] - dz[k] * rs - dy[k] * ps;  /* (x,y,z) -> (x,-z,-y) */
+  }
+} /* decalages_vois() */
+
+#define V(k) p[o[k]]
+
 /* ==================================== */
-{
-#undef F_NAME
-#define F_NAME "insert_vois"
-  register uint8_t * ptr = img+p;
-  if ((p%rs==rs-1) || (p%ps<rs) || (p%rs==0) || (p%ps>=ps-rs) || 
-      (p < ps) || (p >= N-ps)) /* point de bord */
-  {
-    printf("%s: ERREUR: point de bord\n", F_NAME);
-    exit(0);
-  }
-  *(ptr+1) = vois[ 0];
-  *(ptr+1-rs) = vois[ 1];
-  *(ptr-rs) = vois[ 2];
-  *(ptr-rs-1) = vois[ 3];
-  *(ptr-1) = vois[ 4];
-  *(ptr-1+rs) = vois[ 5];
-  *(ptr+rs) = vois[ 6];
-  *(ptr+rs+1) = vois[ 7];
-
-  *(ptr-ps) = vois[ 8];
-  *(ptr-ps+1) = vois[ 9];
-  *(ptr-ps+1-rs) = vois[10];
-  *(ptr-ps-rs) = vois[11];
-  *(ptr-ps-rs-1) = vois[12];
-  *(ptr-ps-1) = vois[13];
-  *(ptr-ps-1+rs) = vois[14];
-  *(ptr-ps+rs) = vois[15];
-  *(ptr-ps+rs+1) = vois[16];
-
-  *(ptr+ps) = vois[17];
-  *(ptr+ps+1) = vois[18];
-  *(ptr+ps+1-rs) = vois[19];
-  *(ptr+ps-rs) = vois[20];
-  *(ptr+ps-rs-1) = vois[21];
-  *(ptr+ps-1) = vois[22];
-  *(ptr+ps-1+rs) = vois[23];
-  *(ptr+ps+rs) = vois[24];
-  *(ptr+ps+rs+1) = vois[25];
-
-  *(ptr) = vois[26];
-} /* insert_vois() */
-
-/* ==================================== */
-static void print_vois(uint8_t *vois)    
+static void print_vois(uint8_t *p, const int32_t *o)
 /* 
-   affiche vois (debug)
+   affiche le voisinage de p (debug)
 */
 /* ==================================== */
 {
   printf("%2d %2d %2d     %2d %2d %2d     %2d %2d %2d\n", 
-	 vois[12],vois[11],vois[10],vois[3],vois[2],vois[1],vois[21],vois[20],vois[19]);
+	 V(12),V(11),V(10),V(3),V(2),V(1),V(21),V(20),V(19));
   printf("%2d %2d %2d     %2d %2d %2d     %2d %2d %2d\n", 
-	 vois[13],vois[8],vois[9],vois[4],vois[26],vois[0],vois[22],vois[17],vois[18]);
+	 V(13),V(8),V(9),V(4),V(26),V(0),V(22),V(17),V(18));
   printf("%2d %2d %2d     %2d %2d %2d     %2d %2d %2d\n\n", 
-	 vois[14],vois[15],vois[16],vois[5],vois[6],vois[7],vois[23],vois[24],vois[25]);
+	 V(14),V(15),V(16),V(5),V(6),V(7),V(23),V(24),V(25));
 } /* print_vois() */
 
-/* ==================================== */
-static void isometrieXZ_vois(uint8_t *vois) 
-// effectue une isomtrie du voisinage "vois" par change des axes X et Z (+ symtries)
-// cette isomtrie est de plus une involution
-/* ==================================== */
-{
-  uint8_t v[26];
-  int32_t i;
-  v[ 0] = vois[17];  v[ 1] = vois[20];  v[ 2] = vois[ 2];  v[ 3] = vois[11];
-  v[ 4] = vois[ 8];  v[ 5] = vois[15];  v[ 6] = vois[ 6];  v[ 7] = vois[24];
-  v[ 8] = vois[ 4];  v[ 9] = vois[22];  v[10] = vois[21];  v[11] = vois[ 3];
-  v[12] = vois[12];  v[13] = vois[13];  v[14] = vois[14];  v[15] = vois[ 5];
-  v[16] = vois[23];  v[17] = vois[ 0];  v[18] = vois[18];  v[19] = vois[19];
-  v[20] = vois[ 1];  v[21] = vois[10];  v[22] = vois[ 9];  v[23] = vois[16];
-  v[24] = vois[ 7];  v[25] = vois[25];
-  for (i = 0; i < 26; i++) vois[i] = v[i];
-} /* isometrieXZ_vois() */
-
-/* ==================================== */
-static void isometrieYZ_vois(uint8_t *vois)
-// effectue une isomtrie du voisinage "vois" par change des axes Y et Z (+ symtries)  
-// cette isomtrie est de plus une involution
-/* ==================================== */
-{
-  uint8_t v[26];
-  int32_t i;
-  v[ 0] = vois[ 0];  v[ 1] = vois[18];  v[ 2] = vois[17];  v[ 3] = vois[22];
-  v[ 4] = vois[ 4];  v[ 5] = vois[13];  v[ 6] = vois[ 8];  v[ 7] = vois[ 9];
-  v[ 8] = vois[ 6];  v[ 9] = vois[ 7];  v[10] = vois[25];  v[11] = vois[24];
-  v[12] = vois[23];  v[13] = vois[ 5];  v[14] = vois[14];  v[15] = vois[15];
-  v[16] = vois[16];  v[17] = vois[ 2];  v[18] = vois[ 1];  v[19] = vois[19];
-  v[20] = vois[20];  v[21] = vois[21];  v[22] = vois[ 3];  v[23] = vois[12];
-  v[24] = vois[11];  v[25] = vois[10];
-  for (i = 0; i < 26; i++) vois[i] = v[i];
-} /* isometrieYZ_vois() */
-
 /* ==================================== */
 int32_t match_end(uint8_t *v)
 /* ==================================== */
@@ -289,8 +190,10 @@ Teste si au moins un des points 12, 11, 13, 8, 3, 2, 4 est objet et tous les aut
 #ifdef DEBUG
   if (trace)
   {  
+    static const int32_t id[27] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,
+      13,14,15,16,17,18,19,20,21,22,23,24,25,26 };
     printf("match_end\n");
-    print_vois(v);
+    print_vois(v, id);
   }
 #endif
 
@@ -346,7 +249,104 @@ Teste si au moins un des points 12, 11, 13, 8, 3, 2, 4 est objet et tous les aut
 } // match_end()
 
 /* ==================================== */
-int32_t match_vois2(uint8_t *v)
+/* ==================================== */
+/*    TABLE DES CONFIGURATIONS 3x3x3    */
+/* ==================================== */
+/* ==================================== */
+
+/*
+  Les predicats topologiques d'un point objet ne dependent que de ses 26 
+  voisins : ils sont ranges dans une table de 2^26 octets indexee par le 
+  masque du voisinage (mask27, bit central retire), remplie a la demande 
+  comme celle du moteur 2D (lskeltab) : un octet nul n'est pas encore 
+  calcule. La table est allouee (par calloc, les pages non touchees ne 
+  coutent rien) au premier appel de topo_alloue, ou projetee depuis le 
+  cache partage entre processus si MC_TABLES est defini (voir mctable.c).
+  Si elle ne peut etre allouee, les predicats sont calcules sans table.
+*/
+
+#define TOPO_CALCULE    1
+#define TOPO_SIMPLE     2   /* T = 1 et Tb = 1 */
+#define TOPO_EXTREMITE  4   /* match_end */
+#define TOPO_COURBE     8   /* T > 1 */
+#define TOPO_SURFACE   16   /* Tb > 1 */
+
+static uint8_t *tab_topo = NULL;
+static int32_t topo_echec = 0;     /* allocation impossible : pas de table */
+
+/* position dans le masque 27 bits de chaque voisin de decalages_vois */
+static const uint8_t bit_vois[27] = {
+  14, 11, 10,  9, 12, 15, 16, 17,
+   4,  5,  2,  1,  0,  3,  6,  7,  8,
+  22, 23, 20, 19, 18, 21, 24, 25, 26,
+  13
+};
+
+/* ==================================== */
+static uint8_t topo_calcule(uint32_t m)
+/* ==================================== */
+// predicats du point objet de masque m ; utilise les cubes de mctopo3d
+{
+  uint8_t v[27], r = TOPO_CALCULE;
+  int32_t k, t, tb;
+
+  for (k = 0; k < 27; k++) v[k] = (m >> bit_vois[k]) & 1;
+  if (match_end(v)) r |= TOPO_EXTREMITE;
+  top26_mask(m, &t, &tb);
+  if ((t == 1) && (tb == 1)) r |= TOPO_SIMPLE;
+  if (t > 1) r |= TOPO_COURBE;
+  if (tb > 1) r |= TOPO_SURFACE;
+  return r;
+} /* topo_calcule() */
+
+/* ==================================== */
+static void topo_alloue()
+/* ==================================== */
+{
+  uint8_t sig[TABLE_NREF];
+  int32_t k;
+#ifdef _OPENMP
+#pragma omp critical (tab_topo)
+#endif
+  if ((tab_topo == NULL) && !topo_echec)
+  {
+    for (k = 0; k < TABLE_NREF; k++) sig[k] = topo_calcule(table_ref27[k]);
+    tab_topo = (uint8_t *)table_projette("topo3d.tab", 1 << 26, sig, TABLE_NREF);
+    if (tab_topo == NULL) tab_topo = (uint8_t *)calloc(1 << 26, 1);
+    if (tab_topo == NULL)
+    {
+      fprintf(stderr, "topo_alloue: malloc failed, no table\n");
+      topo_echec = 1;
+    }
+  }
+} /* topo_alloue() */
+
+/* ==================================== */
+static uint8_t topo_mask(uint32_t m)
+/* ==================================== */
+// predicats du point objet de masque m (topo_alloue doit avoir ete appele).
+// La table est remplie en parallele (lskelmulti3d, etc.) : ses entrees sont
+// lues et ecrites atomiquement.
+{
+  uint32_t k = ((m >> 14) << 13) | (m & 0x1fff);
+  uint8_t r;
+  if (tab_topo == NULL) return topo_calcule(m | MASK27_CENTRE);
+  r = LitAtomique(tab_topo[k]);
+  if (!r)
+  {
+    r = topo_calcule(m | MASK27_CENTRE);
+    EcritAtomique(tab_topo[k], r);
+  }
+  return r;
+} /* topo_mask() */
+
+#define is_simple_point(m)  (topo_mask(m) & TOPO_SIMPLE)
+#define is_end_point(m)     (topo_mask(m) & TOPO_EXTREMITE)
+#define is_curve_point(m)   (topo_mask(m) & TOPO_COURBE)
+#define is_surface_point(m) (topo_mask(m) & TOPO_SURFACE)
+
+/* ==================================== */
+static int32_t match_vois2(uint8_t *p, const int32_t *o)
 /* ==================================== */
 /*
                12      11      10       
@@ -367,21 +367,21 @@ Si le test r
   if (trace)
   {  
     printf("match_vois2\n");
-    print_vois(v);
+    print_vois(p, o);
   }
 #endif
-  if (!IS_SIMPLE(v[8]) || !IS_SIMPLE(v[26])) return 0;
-  if (v[0] || v[9]) t = 1; else t = 0;
-  if (v[1] || v[10]) t |= 2;
-  if (v[2] || v[11]) t |= 4;
-  if (v[3] || v[12]) t |= 8;
-  if (v[4] || v[13]) t |= 16;
-  if (v[5] || v[14]) t |= 32;
-  if (v[6] || v[15]) t |= 64;
-  if (v[7] || v[16]) t |= 128;
+  if (!IS_SIMPLE(V(8)) || !IS_SIMPLE(V(26))) return 0;
+  if (V(0) || V(9)) t = 1; else t = 0;
+  if (V(1) || V(10)) t |= 2;
+  if (V(2) || V(11)) t |= 4;
+  if (V(3) || V(12)) t |= 8;
+  if (V(4) || V(13)) t |= 16;
+  if (V(5) || V(14)) t |= 32;
+  if (V(6) || V(15)) t |= 64;
+  if (V(7) || V(16)) t |= 128;
   if ((t4b(t) == 1) && (t8(t) == 1)) return 0; // simple 2D
-  SET_2M_CRUCIAL(v[8]);
-  SET_2M_CRUCIAL(v[26]);
+  SET_2M_CRUCIAL(V(8));
+  SET_2M_CRUCIAL(V(26));
 #ifdef DEBUG
   if (trace)
     printf("match !\n");
@@ -390,7 +390,7 @@ Si le test r
 } // match_vois2()
 
 /* ==================================== */
-int32_t match_vois2s(uint8_t *v)
+static int32_t match_vois2s(uint8_t *p, const int32_t *o)
 /* ==================================== */
 /*
                12      11      10       
@@ -414,26 +414,26 @@ Si le test r
   if (trace)
   {  
     printf("match_vois2s\n");
-    print_vois(v);
+    print_vois(p, o);
   }
 #endif
-  if (!IS_SIMPLE(v[8]) || !IS_SIMPLE(v[26])) return 0;
-  if (v[0] || v[9]) t = 1; else t = 0;
-  if (v[1] || v[10]) t |= 2;
-  if (v[2] || v[11]) t |= 4;
-  if (v[3] || v[12]) t |= 8;
-  if (v[4] || v[13]) t |= 16;
-  if (v[5] || v[14]) t |= 32;
-  if (v[6] || v[15]) t |= 64;
-  if (v[7] || v[16]) t |= 128;
+  if (!IS_SIMPLE(V(8)) || !IS_SIMPLE(V(26))) return 0;
+  if (V(0) || V(9)) t = 1; else t = 0;
+  if (V(1) || V(10)) t |= 2;
+  if (V(2) || V(11)) t |= 4;
+  if (V(3) || V(12)) t |= 8;
+  if (V(4) || V(13)) t |= 16;
+  if (V(5) || V(14)) t |= 32;
+  if (V(6) || V(15)) t |= 64;
+  if (V(7) || V(16)) t |= 128;
   if ((t4b(t) == 1) && (t8(t) == 1)) return 0; // simple 2D
-  SET_2M_CRUCIAL(v[8]);
-  SET_2M_CRUCIAL(v[26]);
-  if (t4b(t) == 0) { SET_SURF(v[8]); SET_SURF(v[26]); }
+  SET_2M_CRUCIAL(V(8));
+  SET_2M_CRUCIAL(V(26));
+  if (t4b(t) == 0) { SET_SURF(V(8)); SET_SURF(V(26)); }
   else if (t8(t) > 1) 
   { 
-    SET_CURVE(v[8]); 
-    SET_CURVE(v[26]); 
+    SET_CURVE(V(8)); 
+    SET_CURVE(V(26)); 
   }
 #ifdef DEBUG
   if (trace)
@@ -443,7 +443,7 @@ Si le test r
 } // match_vois2s()
 
 /* ==================================== */
-int32_t match_vois1(uint8_t *v)
+static int32_t match_vois1(uint8_t *p, const int32_t *o)
 /* ==================================== */
 // A A  P1 P2  B B
 // A A  P3 P4  B B
@@ -465,35 +465,35 @@ int32_t match_vois1(uint8_t *v)
   if (trace)
   {  
     printf("match_vois1\n");
-    print_vois(v);
+    print_vois(p, o);
   }
 #endif
-  if (!((v[2] && v[4]) || (v[3] && v[26]))) goto next1;
-  if ((IS_OBJECT(v[2])  && (!IS_SIMPLE(v[2])  || IS_2M_CRUCIAL(v[2]))) ||
-      (IS_OBJECT(v[3])  && (!IS_SIMPLE(v[3])  || IS_2M_CRUCIAL(v[3]))) ||
-      (IS_OBJECT(v[4])  && (!IS_SIMPLE(v[4])  || IS_2M_CRUCIAL(v[4]))) ||
-      (IS_OBJECT(v[26]) && (!IS_SIMPLE(v[26]) || IS_2M_CRUCIAL(v[26])))) goto next1;
-  if ((v[12] || v[11] || v[13] || v[8] || v[21] || v[20] || v[22] || v[17]) &&
-      ((!v[12] && !v[11] && !v[13] && !v[8]) || 
-       (!v[21] && !v[20] && !v[22] && !v[17]))) goto next1;
-  if (v[2])  SET_1M_CRUCIAL(v[2]);
-  if (v[3])  SET_1M_CRUCIAL(v[3]);
-  if (v[4])  SET_1M_CRUCIAL(v[4]);
-  if (v[26]) SET_1M_CRUCIAL(v[26]);
+  if (!((V(2) && V(4)) || (V(3) && V(26)))) goto next1;
+  if ((IS_OBJECT(V(2))  && (!IS_SIMPLE(V(2))  || IS_2M_CRUCIAL(V(2)))) ||
+      (IS_OBJECT(V(3))  && (!IS_SIMPLE(V(3))  || IS_2M_CRUCIAL(V(3)))) ||
+      (IS_OBJECT(V(4))  && (!IS_SIMPLE(V(4))  || IS_2M_CRUCIAL(V(4)))) ||
+      (IS_OBJECT(V(26)) && (!IS_SIMPLE(V(26)) || IS_2M_CRUCIAL(V(26))))) goto next1;
+  if ((V(12) || V(11) || V(13) || V(8) || V(21) || V(20) || V(22) || V(17)) &&
+      ((!V(12) && !V(11) && !V(13) && !V(8)) || 
+       (!V(21) && !V(20) && !V(22) && !V(17)))) goto next1;
+  if (V(2))  SET_1M_CRUCIAL(V(2));
+  if (V(3))  SET_1M_CRUCIAL(V(3));
+  if (V(4))  SET_1M_CRUCIAL(V(4));
+  if (V(26)) SET_1M_CRUCIAL(V(26));
   ret = 1;
  next1:
-  if (!((v[2] && v[0]) || (v[1] && v[26]))) goto next2;
-  if ((IS_OBJECT(v[2])  && (!IS_SIMPLE(v[2])  || IS_2M_CRUCIAL(v[2]))) ||
-      (IS_OBJECT(v[1])  && (!IS_SIMPLE(v[1])  || IS_2M_CRUCIAL(v[1]))) ||
-      (IS_OBJECT(v[0])  && (!IS_SIMPLE(v[0])  || IS_2M_CRUCIAL(v[0]))) ||
-      (IS_OBJECT(v[26]) && (!IS_SIMPLE(v[26]) || IS_2M_CRUCIAL(v[26])))) goto next2;
-  if ((v[10] || v[11] || v[9] || v[8] || v[19] || v[20] || v[18] || v[17]) &&
-      ((!v[10] && !v[11] && !v[9] && !v[8]) || 
-       (!v[19] && !v[20] && !v[18] && !v[17]))) goto next2;
-  if (v[2])  SET_1M_CRUCIAL(v[2]);
-  if (v[1])  SET_1M_CRUCIAL(v[1]);
-  if (v[0])  SET_1M_CRUCIAL(v[0]);
-  if (v[26]) SET_1M_CRUCIAL(v[26]);
+  if (!((V(2) && V(0)) || (V(1) && V(26)))) goto next2;
+  if ((IS_OBJECT(V(2))  && (!IS_SIMPLE(V(2))  || IS_2M_CRUCIAL(V(2)))) ||
+      (IS_OBJECT(V(1))  && (!IS_SIMPLE(V(1))  || IS_2M_CRUCIAL(V(1)))) ||
+      (IS_OBJECT(V(0))  && (!IS_SIMPLE(V(0))  || IS_2M_CRUCIAL(V(0)))) ||
+      (IS_OBJECT(V(26)) && (!IS_SIMPLE(V(26)) || IS_2M_CRUCIAL(V(26))))) goto next2;
+  if ((V(10) || V(11) || V(9) || V(8) || V(19) || V(20) || V(18) || V(17)) &&
+      ((!V(10) && !V(11) && !V(9) && !V(8)) || 
+       (!V(19) && !V(20) && !V(18) && !V(17)))) goto next2;
+  if (V(2))  SET_1M_CRUCIAL(V(2));
+  if (V(1))  SET_1M_CRUCIAL(V(1));
+  if (V(0))  SET_1M_CRUCIAL(V(0));
+  if (V(26)) SET_1M_CRUCIAL(V(26));
   ret = 1;
  next2:
 #ifdef DEBUG
@@ -504,7 +504,7 @@ int32_t match_vois1(uint8_t *v)
 } // match_vois1()
 
 /* ==================================== */
-int32_t match_vois1s(uint8_t *v)
+static int32_t match_vois1s(uint8_t *p, const int32_t *o)
 /* ==================================== */
 // A A  P1 P2  B B
 // A A  P3 P4  B B
@@ -527,33 +527,33 @@ int32_t match_vois1s(uint8_t *v)
   if (trace)
   {  
     printf("match_vois1\n");
-    print_vois(v);
+    print_vois(p, o);
   }
 #endif
-  if (!((v[2] && v[4]) || (v[3] && v[26]))) goto next1;
-  if ((IS_OBJECT(v[2])  && (!IS_SIMPLE(v[2]) || IS_2M_CRUCIAL(v[2]))) ||
-      (IS_OBJECT(v[3])  && (!IS_SIMPLE(v[3]) || IS_2M_CRUCIAL(v[3]))) ||
-      (IS_OBJECT(v[4])  && (!IS_SIMPLE(v[4]) || IS_2M_CRUCIAL(v[4]))) ||
-      (IS_OBJECT(v[26]) && (!IS_SIMPLE(v[26]) || IS_2M_CRUCIAL(v[26])))) goto next1;
-  if ((!v[12] && !v[11] && !v[13] && !v[8]) || 
-      (!v[21] && !v[20] && !v[22] && !v[17])) goto next1;
-  if (v[2])  SET_CURVE(v[2]);
-  if (v[3])  SET_CURVE(v[3]);
-  if (v[4])  SET_CURVE(v[4]);
-  if (v[26]) SET_CURVE(v[26]);
+  if (!((V(2) && V(4)) || (V(3) && V(26)))) goto next1;
+  if ((IS_OBJECT(V(2))  && (!IS_SIMPLE(V(2)) || IS_2M_CRUCIAL(V(2)))) ||
+      (IS_OBJECT(V(3))  && (!IS_SIMPLE(V(3)) || IS_2M_CRUCIAL(V(3)))) ||
+      (IS_OBJECT(V(4))  && (!IS_SIMPLE(V(4)) || IS_2M_CRUCIAL(V(4)))) ||
+      (IS_OBJECT(V(26)) && (!IS_SIMPLE(V(26)) || IS_2M_CRUCIAL(V(26))))) goto next1;
+  if ((!V(12) && !V(11) && !V(13) && !V(8)) || 
+      (!V(21) && !V(20) && !V(22) && !V(17))) goto next1;
+  if (V(2))  SET_CURVE(V(2));
+  if (V(3))  SET_CURVE(V(3));
+  if (V(4))  SET_CURVE(V(4));
+  if (V(26)) SET_CURVE(V(26));
   ret = 1;
  next1:
-  if (!((v[2] && v[0]) || (v[1] && v[26]))) goto next2;
-  if ((IS_OBJECT(v[2])  && (!IS_SIMPLE(v[2]) || IS_2M_CRUCIAL(v[2]))) ||
-      (IS_OBJECT(v[1])  && (!IS_SIMPLE(v[1]) || IS_2M_CRUCIAL(v[1]))) ||
-      (IS_OBJECT(v[0])  && (!IS_SIMPLE(v[0]) || IS_2M_CRUCIAL(v[0]))) ||
-      (IS_OBJECT(v[26]) && (!IS_SIMPLE(v[26]) || IS_2M_CRUCIAL(v[26])))) goto next2;
-  if ((!v[10] && !v[11] && !v[9] && !v[8]) || 
-      (!v[19] && !v[20] && !v[18] && !v[17])) goto next2;
-  if (v[2])  SET_CURVE(v[2]);
-  if (v[1])  SET_CURVE(v[1]);
-  if (v[0])  SET_CURVE(v[0]);
-  if (v[26]) SET_CURVE(v[26]);
+  if (!((V(2) && V(0)) || (V(1) && V(26)))) goto next2;
+  if ((IS_OBJECT(V(2))  && (!IS_SIMPLE(V(2)) || IS_2M_CRUCIAL(V(2)))) ||
+      (IS_OBJECT(V(1))  && (!IS_SIMPLE(V(1)) || IS_2M_CRUCIAL(V(1)))) ||
+      (IS_OBJECT(V(0))  && (!IS_SIMPLE(V(0)) || IS_2M_CRUCIAL(V(0)))) ||
+      (IS_OBJECT(V(26)) && (!IS_SIMPLE(V(26)) || IS_2M_CRUCIAL(V(26))))) goto next2;
+  if ((!V(10) && !V(11) && !V(9) && !V(8)) || 
+      (!V(19) && !V(20) && !V(18) && !V(17))) goto next2;
+  if (V(2))  SET_CURVE(V(2));
+  if (V(1))  SET_CURVE(V(1));
+  if (V(0))  SET_CURVE(V(0));
+  if (V(26)) SET_CURVE(V(26));
   ret = 1;
  next2:
 #ifdef DEBUG
@@ -564,7 +564,7 @@ int32_t match_vois1s(uint8_t *v)
 } // match_vois1s()
 
 /* ==================================== */
-int32_t match_vois0(uint8_t *v)
+static int32_t match_vois0(uint8_t *p, const int32_t *o)
 /* ==================================== */
 /*
                12      11
@@ -584,28 +584,28 @@ Si le test r
   if (trace)
   {  
     printf("match_vois0\n");
-    print_vois(v);
+    print_vois(p, o);
   }
 #endif
-  if (!((v[12]&&v[26]) || (v[11]&&v[4]) || (v[13]&&v[2]) || (v[8]&&v[3]) )) return 0;
-
-  if (v[12] && (!IS_SIMPLE(v[12]) || IS_2M_CRUCIAL(v[12]) || IS_1M_CRUCIAL(v[12]))) return 0;
-  if (v[26] && (!IS_SIMPLE(v[26]) || IS_2M_CRUCIAL(v[26]) || IS_1M_CRUCIAL(v[26]))) return 0;
-  if (v[11] && (!IS_SIMPLE(v[11]) || IS_2M_CRUCIAL(v[11]) || IS_1M_CRUCIAL(v[11]))) return 0;
-  if (v[ 4] && (!IS_SIMPLE(v[ 4]) || IS_2M_CRUCIAL(v[ 4]) || IS_1M_CRUCIAL(v[ 4]))) return 0;
-  if (v[13] && (!IS_SIMPLE(v[13]) || IS_2M_CRUCIAL(v[13]) || IS_1M_CRUCIAL(v[13]))) return 0;
-  if (v[ 2] && (!IS_SIMPLE(v[ 2]) || IS_2M_CRUCIAL(v[ 2]) || IS_1M_CRUCIAL(v[ 2]))) return 0;
-  if (v[ 8] && (!IS_SIMPLE(v[ 8]) || IS_2M_CRUCIAL(v[ 8]) || IS_1M_CRUCIAL(v[ 8]))) return 0;
-  if (v[ 3] && (!IS_SIMPLE(v[ 3]) || IS_2M_CRUCIAL(v[ 3]) || IS_1M_CRUCIAL(v[ 3]))) return 0;
-
-  if (v[12]) SET_0M_CRUCIAL(v[12]);
-  if (v[26]) SET_0M_CRUCIAL(v[26]);
-  if (v[11]) SET_0M_CRUCIAL(v[11]);
-  if (v[ 4]) SET_0M_CRUCIAL(v[ 4]);
-  if (v[13]) SET_0M_CRUCIAL(v[13]);
-  if (v[ 2]) SET_0M_CRUCIAL(v[ 2]);
-  if (v[ 8]) SET_0M_CRUCIAL(v[ 8]);
-  if (v[ 3]) SET_0M_CRUCIAL(v[ 3]);
+  if (!((V(12)&&V(26)) || (V(11)&&V(4)) || (V(13)&&V(2)) || (V(8)&&V(3)) )) return 0;
+
+  if (V(12) && (!IS_SIMPLE(V(12)) || IS_2M_CRUCIAL(V(12)) || IS_1M_CRUCIAL(V(12)))) return 0;
+  if (V(26) && (!IS_SIMPLE(V(26)) || IS_2M_CRUCIAL(V(26)) || IS_1M_CRUCIAL(V(26)))) return 0;
+  if (V(11) && (!IS_SIMPLE(V(11)) || IS_2M_CRUCIAL(V(11)) || IS_1M_CRUCIAL(V(11)))) return 0;
+  if (V(4) && (!IS_SIMPLE(V(4)) || IS_2M_CRUCIAL(V(4)) || IS_1M_CRUCIAL(V(4)))) return 0;
+  if (V(13) && (!IS_SIMPLE(V(13)) || IS_2M_CRUCIAL(V(13)) || IS_1M_CRUCIAL(V(13)))) return 0;
+  if (V(2) && (!IS_SIMPLE(V(2)) || IS_2M_CRUCIAL(V(2)) || IS_1M_CRUCIAL(V(2)))) return 0;
+  if (V(8) && (!IS_SIMPLE(V(8)) || IS_2M_CRUCIAL(V(8)) || IS_1M_CRUCIAL(V(8)))) return 0;
+  if (V(3) && (!IS_SIMPLE(V(3)) || IS_2M_CRUCIAL(V(3)) || IS_1M_CRUCIAL(V(3)))) return 0;
+
+  if (V(12)) SET_0M_CRUCIAL(V(12));
+  if (V(26)) SET_0M_CRUCIAL(V(26));
+  if (V(11)) SET_0M_CRUCIAL(V(11));
+  if (V(4)) SET_0M_CRUCIAL(V(4));
+  if (V(13)) SET_0M_CRUCIAL(V(13));
+  if (V(2)) SET_0M_CRUCIAL(V(2));
+  if (V(8)) SET_0M_CRUCIAL(V(8));
+  if (V(3)) SET_0M_CRUCIAL(V(3));
 #ifdef DEBUG
   if (trace)
     printf("match !\n");
@@ -614,76 +614,408 @@ Si le test r
 } // match_vois0()
 
 /* ==================================== */
-int32_t match2(uint8_t *v)
+static int32_t match2(uint8_t *p, const int32_t o[3][27])
 /* ==================================== */
 {
-  int32_t i, ret = 0;
-  if (match_vois2(v)) ret = 1;
-  isometrieXZ_vois(v);
-  if (match_vois2(v)) ret = 1;
-  isometrieXZ_vois(v);
-  isometrieYZ_vois(v);
-  if (match_vois2(v)) ret = 1;
-  isometrieYZ_vois(v);
+  int32_t ret = 0;
+  if (match_vois2(p, o[0])) ret = 1;
+  if (match_vois2(p, o[1])) ret = 1;
+  if (match_vois2(p, o[2])) ret = 1;
   return ret;
 } /* match2() */
 
 /* ==================================== */
-int32_t match2s(uint8_t *v)
+static int32_t match2s(uint8_t *p, const int32_t o[3][27])
 /* ==================================== */
 {
-  int32_t i, ret = 0;
-  if (match_vois2s(v)) ret = 1;
-  isometrieXZ_vois(v);
-  if (match_vois2s(v)) ret = 1;
-  isometrieXZ_vois(v);
-  isometrieYZ_vois(v);
-  if (match_vois2s(v)) ret = 1;
-  isometrieYZ_vois(v);
+  int32_t ret = 0;
+  if (match_vois2s(p, o[0])) ret = 1;
+  if (match_vois2s(p, o[1])) ret = 1;
+  if (match_vois2s(p, o[2])) ret = 1;
   return ret;
 } /* match2s() */
 
 /* ==================================== */
-int32_t match1(uint8_t *v)
+static int32_t match1(uint8_t *p, const int32_t o[3][27])
 /* ==================================== */
 {
-  int32_t i, ret = 0;
-  if (match_vois1(v)) ret = 1;
-  isometrieXZ_vois(v);
-  if (match_vois1(v)) ret = 1;
-  isometrieXZ_vois(v);
-  isometrieYZ_vois(v);
-  if (match_vois1(v)) ret = 1;
-  isometrieYZ_vois(v);
+  int32_t ret = 0;
+  if (match_vois1(p, o[0])) ret = 1;
+  if (match_vois1(p, o[1])) ret = 1;
+  if (match_vois1(p, o[2])) ret = 1;
   return ret;
 } /* match1() */
 
 /* ==================================== */
-int32_t match1s(uint8_t *v)
+static int32_t match1s(uint8_t *p, const int32_t o[3][27])
 /* ==================================== */
 {
-  int32_t i, ret = 0;
-  if (match_vois1s(v)) ret = 1;
-  isometrieXZ_vois(v);
-  if (match_vois1s(v)) ret = 1;
-  isometrieXZ_vois(v);
-  isometrieYZ_vois(v);
-  if (match_vois1s(v)) ret = 1;
-  isometrieYZ_vois(v);
+  int32_t ret = 0;
+  if (match_vois1s(p, o[0])) ret = 1;
+  if (match_vois1s(p, o[1])) ret = 1;
+  if (match_vois1s(p, o[2])) ret = 1;
   return ret;
 } /* match1s() */
 
 /* ==================================== */
-int32_t match0(uint8_t *v)
+static int32_t match0(uint8_t *p, const int32_t o[3][27])
 /* ==================================== */
 {
-  int32_t i, ret = 0;
-  if (match_vois0(v)) ret = 1;
+  int32_t ret = 0;
+  if (match_vois0(p, o[0])) ret = 1;
   return ret;
 } /* match0() */
 
+#undef V
+
+/* ==================================== */
+/* ==================================== */
+/*        SOUS-ITERATIONS COMMUNES      */
+/* ==================================== */
+/* ==================================== */
+
+/* ==================================== */
+static void marque_match(uint8_t *S, int32_t (*match)(uint8_t *, const int32_t [3][27]), 
+			 int32_t i0, int32_t i1, int32_t rs, int32_t ps, int32_t N)
+/* ==================================== */
+/*
+  Pour chaque point simple i de [i0,i1[, marque dans S les points de son
+  voisinage selon match. Lit et ecrit les plans voisins de ceux de [i0,i1[.
+  L'appel de match est indirect ; son cout est negligeable devant celui 
+  du predicat, qui lit et marque l'image en place par les decalages 
+  calcules une fois par passe (decalages_vois).
+*/
+{
+  int32_t i, j, b, off[3][27];
+  uint64_t w;
+
+  decalages_vois(rs, ps, off);
+  for (i = i0; i < i1; i = b)
+  {
+    b = min(i + 8, i1);
+    if (b - i == 8)
+    { // les points simples sont rares : saute les mots de 8 points sans point simple
+      memcpy(&w, S + i, 8);
+      if (!(w & (S_SIMPLE * 0x0101010101010101ULL))) continue;
+    }
+    for (j = i; j < b; j++)
+      if (IS_SIMPLE(S[j]))
+	match(S + j, (const int32_t (*)[27])off);
+  }
+} /* marque_match() */
+
+/* ==================================== */
+static void marque_extremites(uint8_t *S, uint8_t *I, int32_t rs, int32_t ps, int32_t N)
+/* ==================================== */
+// ajoute les points extremites de S dans I
+{
+  int32_t j, b, k;
+  uint64_t o, L[9];
+
+  topo_alloue();
+  for (j = 0; j < N; j = b)
+  {
+    b = min(j - (j % rs) + rs, j + LIGNES27_MAX);
+    if ((o = lignes27(S, j, b - j, rs, ps, L)) == 0) continue;
+    for (o &= ~INTERIEURS27(L); o; o &= o - 1)
+    {
+      k = RANG64(o);
+      if (is_end_point(MASK27_LIGNES(L, k))) I[j + k] = 1;
+    }
+  }
+} /* marque_extremites() */
+
+/* ==================================== */
+static void marque_simples(uint8_t *S, uint8_t *I, uint8_t *P, int32_t i0, int32_t i1, int32_t rs, int32_t ps)
+/* ==================================== */
+/*
+  Marque les points simples de S d'indice dans [i0,i1[ qui ne sont pas 
+  dans I (I peut etre NULL). Sans P, S est parcouru par lots de points 
+  d'une rangee (lignes27) : seuls les points objet ayant un 6-voisin dans
+  le fond sont examines.
+  Si P n'est pas NULL, il contient une classification precalculee 
+  (voir lskelmulti3d) : 0 = non simple, 1 = simple, 2 = a calculer.
+*/
+{
+  int32_t i, k, b;
+  uint64_t o, L[9];
+
+  if (P == NULL)
+  {
+    topo_alloue();
+    for (; i0 < i1; i0 = b)
+    {
+      b = min(min(i0 - (i0 % rs) + rs, i1), i0 + LIGNES27_MAX);
+      if ((o = lignes27(S, i0, b - i0, rs, ps, L)) == 0) continue;
+      for (o &= ~INTERIEURS27(L); o; o &= o - 1)
+      {
+	k = RANG64(o);
+	if ((!I || !I[i0 + k]) && is_simple_point(MASK27_LIGNES(L, k)))
+	  SET_SIMPLE(S[i0 + k]);
+      }
+    }
+    return;
+  }
+  for (i = i0; i < i1; i++) 
+    if (P[i] && (!I || !I[i]))
+    {
+      if (P[i] == 1) SET_SIMPLE(S[i]);
+      else if (IS_OBJECT(S[i]) && simple26_nb(S, i, rs, ps)) SET_SIMPLE(S[i]);
+    }
+} /* marque_simples() */
+
+/* ==================================== */
+static void marque_courbes(uint8_t *S, int32_t rs, int32_t ps, int32_t N)
+/* ==================================== */
+// marque les points objet non simples de S qui sont des points de courbe (T > 1)
+// (un point sans 6-voisin dans le fond a T = 1 : il n'est pas examine)
+{
+  int32_t j, b, k;
+  uint64_t o, L[9];
+
+  topo_alloue();
+  for (j = 0; j < N; j = b)
+  {
+    b = min(j - (j % rs) + rs, j + LIGNES27_MAX);
+    if ((o = lignes27(S, j, b - j, rs, ps, L)) == 0) continue;
+    for (o &= ~INTERIEURS27(L); o; o &= o - 1)
+    {
+      k = RANG64(o);
+      if (!IS_SIMPLE(S[j + k]) && is_curve_point(MASK27_LIGNES(L, k)))
+	SET_CURVE(S[j + k]);
+    }
+  }
+} /* marque_courbes() */
+
+/* ==================================== */
+static void dilat26_bits(uint64_t *T, uint64_t *B, uint64_t *X, int32_t W, int32_t cs, int32_t ds)
+/* ==================================== */
+/*
+  Dilatation d'un plan de bits T (un bit par voxel, rangees de W mots)
+  par le 26-voisinage sans son centre : le bit i de X vaut 1 ssi l'un
+  des 26 voisins de i est a 1 dans T. La dilatation est separable et
+  calculee 64 voxels a la fois :
+    B = T dilate en x, X = idem sans le centre,
+    A = B dilate en y (dans T), X = B(y-1) | X | B(y+1),
+    X = A(z-1) | X | A(z+1).
+  T et B sont detruits.
+*/
+{
+  int32_t w, y, z, n, pw = W * cs, Nw = pw * ds;
+  uint64_t t, g, d, u;
+
+  // DILATATION EN x (les bits 0 et 63 passent d'un mot a l'autre)
+  for (n = 0; n < Nw; n += W)
+    for (w = 0; w < W; w++)
+    {
+      t = T[n + w];
+      g = (t << 1) | ((w > 0) ? T[n + w - 1] >> 63 : 0);
+      d = (t >> 1) | ((w < W - 1) ? T[n + w + 1] << 63 : 0);
+      X[n + w] = g | d;
+      B[n + w] = g | d | t;
+    }
+
+  // DILATATION EN y
+  for (z = 0, n = 0; z < ds; z++)
+    for (y = 0; y < cs; y++)
+      for (w = 0; w < W; w++, n++)
+      {
+	u = ((y > 0) ? B[n - W] : 0) | ((y < cs - 1) ? B[n + W] : 0);
+	T[n] = u | B[n];
+	X[n] |= u;
+      }
+
+  // DILATATION EN z
+  for (n = 0; n < Nw; n++)
+    X[n] |= ((n >= pw) ? T[n - pw] : 0) | ((n < Nw - pw) ? T[n + pw] : 0);
+} /* dilat26_bits() */
+
+/* ==================================== */
+static int32_t marque_surfaces(uint8_t *S, int32_t rs, int32_t ps, int32_t N)
+/* ==================================== */
+/*
+  Propre a CK3 : rend non simples les points simples qui ne sont voisins 
+  ni d'un point interieur ni d'un point de surface.
+  Retourne 0 (S inchange) si les tampons ne peuvent etre alloues.
+*/
+{
+  int32_t i, j, k, r, b;
+  int32_t W = (rs + 63) >> 6, nr = N / rs, Nw = W * nr;
+  uint8_t *R;
+  uint64_t *T, o, pi, L[9];
+
+  // T : plan de bits des points marques (SELECTED ou SURF)
+  // R : rangees ayant un point objet dans leur 26-voisinage
+  T = (uint64_t *)calloc(3 * Nw, sizeof(uint64_t));
+  R = (uint8_t *)malloc(nr);
+  if ((T == NULL) || (R == NULL))
+  {
+    fprintf(stderr, "marque_surfaces: malloc failed\n");
+    if (T) free(T);
+    if (R) free(R);
+    return 0;
+  }
+  topo_alloue();
+  // MARQUE LES POINTS DE SURFACE (2)
+  marque_match(S, match2s, 0, N, rs, ps, N);
+  // MARQUE LES POINTS DE SURFACE (3) ET LES POINTS INTERIEURS
+  // (sans 6-voisin dans le fond : topb = 0)
+  for (i = 0, r = 0; i < N; i += rs, r++)
+    for (R[r] = 0, j = i; j < i + rs; j = b)
+    {
+      b = min(j + LIGNES27_MAX, i + rs);
+      if ((o = lignes27(S, j, b - j, rs, ps, L)) == 0) continue;
+      R[r] = 1;
+      for (pi = INTERIEURS27(L); o; o &= o - 1)
+      {
+	k = RANG64(o);
+	if (!IS_SIMPLE(S[j + k]))
+	{
+	  if ((pi >> k) & 1) SET_SELECTED(S[j + k]);
+	  else if (is_surface_point(MASK27_LIGNES(L, k))) SET_SURF(S[j + k]);
+	}
+	if (S[j + k] & (S_SELECTED|S_SURF)) 
+	  T[r * W + ((j + k - i) >> 6)] |= 1ULL << ((j + k - i) & 63);
+      }
+    }
+
+  // DEMARQUE PTS ET REND "NON-SIMPLES" LES CANDIDATS
+  // (voxels objet sans 26-voisin interieur ni de surface : residuels)
+  dilat26_bits(T, T + Nw, T + 2 * Nw, W, ps / rs, N / ps);
+  for (i = 0, r = 0; i < N; i += rs, r++)
+    if (R[r])
+      for (j = 0, k = 2 * Nw + r * W; j < rs; j++)
+      {
+	UNSET_2M_CRUCIAL(S[i + j]);
+	if (IS_OBJECT(S[i + j]) && !((T[k + (j >> 6)] >> (j & 63)) & 1))
+	  UNSET_SIMPLE(S[i + j]);
+      }
+  free(T);
+  free(R);
+  return 1;
+} /* marque_surfaces() */
+
+/* ==================================== */
+static void marque_cruciaux(uint8_t *S, int32_t rs, int32_t ps, int32_t N)
+/* ==================================== */
+// marque les points 2M-, 1M- puis 0M-cruciaux parmi les points simples
+{
+  marque_match(S, match2, 0, N, rs, ps, N);
+  marque_match(S, match1, 0, N, rs, ps, N);
+  marque_match(S, match0, 0, N, rs, ps, N);
+} /* marque_cruciaux() */
+
+/* ==================================== */
+static int32_t retire_simples(uint8_t *S, int32_t i0, int32_t i1, uint32_t *M, int32_t step)
+/* ==================================== */
+/*
+  Sur [i0,i1[ : S := [S \ P] \cup M, o M reprsente les pts marqus 
+  cruciaux, et remet les points restants a S_OBJECT. 
+  Si M n'est pas NULL, M[i] := step pour chaque point i retir.
+  Retourne 1 si au moins un point a ete retire, 0 sinon.
+*/
+{
+  int32_t i, nonstab = 0;
+
+  if (M == NULL)
+    return mc_retire(S + i0, i1 - i0, S_SIMPLE|S_2M_CRUCIAL|S_1M_CRUCIAL|S_0M_CRUCIAL, S_SIMPLE, S_OBJECT);
+  for (i = i0; i < i1; i++)
+    if (S[i])
+    {
+      if (IS_SIMPLE(S[i]) && 
+	  !IS_2M_CRUCIAL(S[i]) && !IS_1M_CRUCIAL(S[i]) && !IS_0M_CRUCIAL(S[i]))
+      {
+	S[i] = 0; 
+	if (M) M[i] = step;
+	nonstab = 1; 
+      }
+      else S[i] = S_OBJECT;
+    }
+  return nonstab;
+} /* retire_simples() */
+
+/* ==================================== */
+/* ==================================== */
+/*        POINTS DE REPRISE             */
+/* ==================================== */
+/* ==================================== */
+
+/*
+  Les boucles des algorithmes lskel*3 peuvent sauvegarder leur etat 
+  (voir mcckpt.c) toutes les ckpt_pas etapes et/ou toutes les 
+  ckpt_secondes secondes, et reprendre a partir d'une sauvegarde.
+  L'etat comprend S et, selon l'algorithme, l'image d'inhibition I 
+  (completee par EK3, CK3a, CK3b) et les images K et T de AK3.
+*/
+static char * ckpt_fichier = NULL;  /* fichier de sauvegarde (NULL : pas de sauvegarde) */
+static int32_t ckpt_pas = 0;        /* periode en etapes (0 : non utilisee) */
+static int32_t ckpt_secondes = 0;   /* periode en secondes (0 : non utilisee) */
+static time_t ckpt_date;            /* date de la derniere sauvegarde */
+static char * ckpt_reprise = NULL;  /* fichier de reprise (NULL : depart de zero) */
+
+/* ==================================== */
+void lskel3d_checkpoint(char *filename, int32_t nsteps, int32_t nsecs)
+/* ==================================== */
+// sauvegarde dans filename toutes les nsteps etapes et/ou toutes les nsecs secondes
+{
+  ckpt_fichier = filename;
+  ckpt_pas = nsteps;
+  ckpt_secondes = nsecs;
+} /* lskel3d_checkpoint() */
+
+/* ==================================== */
+void lskel3d_resume(char *filename)
+/* ==================================== */
+// le prochain appel d'un algorithme lskel*3 reprend a partir de filename
+{
+  ckpt_reprise = filename;
+} /* lskel3d_resume() */
+
+/* ==================================== */
+static int32_t reprise(char *algo, int32_t *step, struct xvimage *s, 
+		       struct xvimage *i, struct xvimage *k, struct xvimage *t)
+/* ==================================== */
+// les images absentes de l'algorithme sont passees a NULL
+{
+  struct xvimage *img[4];
+  int32_t ret;
+
+  ckpt_date = time(NULL);
+  if (ckpt_reprise == NULL) return 1;
+  img[0] = s; img[1] = i; img[2] = k; img[3] = t;
+  ret = ckpt_read(ckpt_reprise, algo, step, 4, img);
+  ckpt_reprise = NULL;
+  return ret;
+} /* reprise() */
+
+/* ==================================== */
+static int32_t echeance(int32_t step)
+/* ==================================== */
+// une sauvegarde est-elle due a l'etape step ?
+{
+  if (ckpt_fichier == NULL) return 0;
+  return ((ckpt_pas > 0) && ((step % ckpt_pas) == 0)) ||
+         ((ckpt_secondes > 0) && (time(NULL) - ckpt_date >= ckpt_secondes));
+} /* echeance() */
+
+/* ==================================== */
+static void sauvegarde(char *algo, int32_t step, struct xvimage *s, 
+		       struct xvimage *i, struct xvimage *k, struct xvimage *t)
+/* ==================================== */
+// un echec de sauvegarde est signale mais n'interrompt pas l'algorithme
+{
+  struct xvimage *img[4];
+
+  if (echeance(step))
+  {
+    img[0] = s; img[1] = i; img[2] = k; img[3] = t;
+    ckpt_write(ckpt_fichier, algo, step, 4, img);
+    ckpt_date = time(NULL);
+  }
+} /* sauvegarde() */
+
 /* ==================================== */
-int32_t lskelMK3a(struct xvimage *image, 
+static int32_t lskelMK3a_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -706,16 +1038,17 @@ R
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
+  struct xvimage *t = copyscratch(image); 
   uint8_t *T = UCHARDATA(t);
-  struct xvimage *r = copyimage(image); 
+  struct xvimage *r = copyscratch(image); 
   uint8_t *R = UCHARDATA(r);
   int32_t step, nonstab;
-  uint8_t v[27];
 
   if (inhibit != NULL)
   {
     fprintf(stderr, "%s: inhibit image not implemented\n", F_NAME);
+    freescratch(t);
+    freescratch(r);
     return 0;
   }
 
@@ -731,6 +1064,13 @@ R
 
   step = 0;
   nonstab = 1;
+  if (!reprise("MK3a", &step, image, NULL, NULL, NULL))
+  {
+    freescratch(t);
+    freescratch(r);
+    termine_topo3d();
+    return 0;
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -740,20 +1080,12 @@ R
 #endif
 
     // PREMIERE SOUS-ITERATION : MARQUE LES POINTS SIMPLES
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]) && simple26(S, i, rs, ps, N))
-	SET_SIMPLE(S[i]);
+    marque_simples(S, NULL, NULL, 0, N, rs, ps);
 #ifdef DEBUG
 writeimage(image,"_S");
 #endif
     // DEUXIEME SOUS-ITERATION : MARQUE LES CLIQUES CRUCIALES CORRESPONDANT AUX 2-FACES
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match2, 0, N, rs, ps, N);
 #ifdef DEBUG
 memset(R, 0, N);
 for (i = 0; i < N; i++) if (IS_2M_CRUCIAL(S[i])) R[i] = 255;
@@ -761,16 +1093,7 @@ writeimage(r,"_M2");
 #endif
 
     // TROISIEME SOUS-ITERATION : MARQUE LES CLIQUES CRUCIALES CORRESPONDANT AUX 1-FACES
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-#ifdef DEBUG
-printf("%d %d %d\n", i % rs, (i % ps) / rs, i / ps);
-#endif
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match1, 0, N, rs, ps, N);
 #ifdef DEBUG
 memset(R, 0, N);
 for (i = 0; i < N; i++) if (IS_1M_CRUCIAL(S[i])) R[i] = 255;
@@ -785,9 +1108,14 @@ writeimage(r,"_M1");
 writeimage(t,"_T");
 #endif
 
-    memset(R, 0, N);
-    for (i = 0; i < N; i++)
-      if (nbvoiso26(T, i, rs, ps, N) >= 1) R[i] = 1; // calcule R = Dilat(T)
+    if (!morpho_dil26(T, R, rs, cs, ds)) // calcule R = Dilat(T) (R = T \oplus \Gamma_26* hors de T)
+    {
+      fprintf(stderr, "%s: malloc failed\n", F_NAME);
+      freescratch(t);
+      freescratch(r);
+      termine_topo3d();
+      return 0;
+    }
     for (i = 0; i < N; i++)
       if (T[i] || (S[i] && !R[i])) T[i] = 1; else T[i] = 0; // T := T \cup [S \ R]
 
@@ -798,6 +1126,7 @@ writeimage(t,"_T");
 	nonstab = 1; 
       }
     for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+    sauvegarde("MK3a", step, image, NULL, NULL, NULL);
   }
 
 #ifdef VERBOSE1
@@ -806,14 +1135,14 @@ writeimage(t,"_T");
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
-  freeimage(r);
+  freescratch(t);
+  freescratch(r);
   termine_topo3d();
   return(1);
-} /* lskelMK3a() */
+} /* lskelMK3a_nb() */
 
 /* ==================================== */
-int32_t lskelEK3(struct xvimage *image, 
+static int32_t lskelEK3_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -832,23 +1161,20 @@ R
 #undef F_NAME
 #define F_NAME "lskelEK3"
 { 
-  int32_t i, j, x, y, z;
+  int32_t i;
   int32_t rs = rowsize(image);     /* taille ligne */
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t ds = depth(image);       /* nb plans */
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
-  uint8_t *T = UCHARDATA(t);
   uint8_t *I;
+  struct xvimage *inhibloc = NULL; /* copie locale de inhibit */
   int32_t step, nonstab;
-  int32_t top, topb;
-  uint8_t v[27];
 
   if (inhibit == NULL) 
   {
-    inhibit = copyimage(image); 
+    inhibit = inhibloc = copyimage(image); 
     razimage(inhibit);
   }
   I = UCHARDATA(inhibit);
@@ -865,6 +1191,12 @@ R
 
   step = 0;
   nonstab = 1;
+  if (!reprise("EK3", &step, image, inhibit, NULL, NULL))
+  {
+    if (inhibloc != NULL) freeimage(inhibloc);
+    termine_topo3d();
+    return 0;
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -873,59 +1205,11 @@ R
     printf("step %d\n", step);
 #endif
 
-    // AJOUTE LES EXTREMITES DANS I
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match_end(v)) I[i] = 1;
-      }
-
-    // MARQUE LES POINTS SIMPLES NON DANS I
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]) && !I[i] && simple26(S, i, rs, ps, N))
-	SET_SIMPLE(S[i]);
-
-    // MARQUE LES POINTS 2M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-    // MARQUE LES POINTS 1M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-    // MARQUE LES POINTS 0M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match0(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-
-    memset(T, 0, N);
-    for (i = 0; i < N; i++) // T := [S \ P] \cup M, o M reprsente les pts marqus
-      if ((S[i] && !IS_SIMPLE(S[i])) || IS_2M_CRUCIAL(S[i]) || IS_1M_CRUCIAL(S[i]) || IS_0M_CRUCIAL(S[i]))
-	T[i] = 1;
-#ifdef DEBUG
-writeimage(t,"_T");
-#endif
-
-    for (i = 0; i < N; i++)
-      if (S[i] && !T[i]) 
-      {
-	S[i] = 0; 
-	nonstab = 1; 
-      }
-    for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+    marque_extremites(S, I, rs, ps, N);
+    marque_simples(S, I, NULL, 0, N, rs, ps);
+    marque_cruciaux(S, rs, ps, N);
+    nonstab = retire_simples(S, 0, N, NULL, 0);
+    sauvegarde("EK3", step, image, inhibit, NULL, NULL);
   }
 
 #ifdef VERBOSE1
@@ -934,13 +1218,13 @@ writeimage(t,"_T");
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
+  if (inhibloc != NULL) freeimage(inhibloc);
   termine_topo3d();
   return(1);
-} /* lskelEK3() */
+} /* lskelEK3_nb() */
 
 /* ==================================== */
-int32_t lskelCK3a(struct xvimage *image, 
+static int32_t lskelCK3a_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -967,16 +1251,16 @@ R
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
+  struct xvimage *t = copyscratch(image); 
   uint8_t *T = UCHARDATA(t);
   uint8_t *I;
+  struct xvimage *inhibloc = NULL; /* copie locale de inhibit */
   int32_t step, nonstab;
   int32_t top, topb;
-  uint8_t v[27];
 
   if (inhibit == NULL) 
   {
-    inhibit = copyimage(image); 
+    inhibit = inhibloc = copyimage(image); 
     razimage(inhibit);
   }
   I = UCHARDATA(inhibit);
@@ -993,6 +1277,13 @@ R
 
   step = 0;
   nonstab = 1;
+  if (!reprise("CK3a", &step, image, inhibit, NULL, NULL))
+  {
+    freescratch(t);
+    if (inhibloc != NULL) freeimage(inhibloc);
+    termine_topo3d();
+    return 0;
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -1002,34 +1293,13 @@ R
 #endif
 
     // MARQUE LES POINTS SIMPLES NON DANS I
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]) && !I[i] && simple26(S, i, rs, ps, N))
-	SET_SIMPLE(S[i]);
+    marque_simples(S, I, NULL, 0, N, rs, ps);
     // DEUXIEME SOUS-ITERATION : MARQUE LES POINTS DE COURBE (2)
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2s(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match2s, 0, N, rs, ps, N);
     // TROISIEME SOUS-ITERATION : MARQUE LES POINTS DE COURBE (1)
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1s(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match1s, 0, N, rs, ps, N);
     // MARQUE LES POINTS DE COURBE (3)
-    for (i = 0; i < N; i++)
-    {
-      if (IS_OBJECT(S[i]) && !IS_SIMPLE(S[i]))
-      {    
-	top26(S, i, rs, ps, N, &top, &topb);
-	if (top > 1) SET_CURVE(S[i]);
-      }
-    }
+    marque_courbes(S, rs, ps, N);
     // DEMARQUE PTS DE COURBE ET LES MEMORISE DANS I
     for (i = 0; i < N; i++)
     { 
@@ -1037,29 +1307,11 @@ R
       if (IS_CURVE(S[i])) { UNSET_SIMPLE(S[i]); I[i] = 1; }
     }
     // MARQUE LES POINTS 2M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match2, 0, N, rs, ps, N);
     // MARQUE LES POINTS 1M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match1, 0, N, rs, ps, N);
     // MARQUE LES POINTS 0M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match0(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match0, 0, N, rs, ps, N);
 
     memset(T, 0, N);
     for (i = 0; i < N; i++) // T := [S \ P] \cup M, o M reprsente les pts marqus
@@ -1076,6 +1328,7 @@ writeimage(t,"_T");
 	nonstab = 1; 
       }
     for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+    sauvegarde("CK3a", step, image, inhibit, NULL, NULL);
   }
 
 #ifdef VERBOSE1
@@ -1084,13 +1337,14 @@ writeimage(t,"_T");
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
+  freescratch(t);
+  if (inhibloc != NULL) freeimage(inhibloc);
   termine_topo3d();
   return(1);
-} /* lskelCK3a() */
+} /* lskelCK3a_nb() */
 
 /* ==================================== */
-int32_t lskelCK3b(struct xvimage *image, 
+static int32_t lskelCK3b_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -1113,25 +1367,26 @@ R
 #undef F_NAME
 #define F_NAME "lskelCK3b"
 { 
-  int32_t i, j, k, x, y, z;
+  int32_t i, x, y, z;
   int32_t rs = rowsize(image);     /* taille ligne */
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t ds = depth(image);       /* nb plans */
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
+  struct xvimage *t = copyscratch(image); 
   uint8_t *T = UCHARDATA(t);
-  struct xvimage *e = copyimage(image); 
+  struct xvimage *e = copyscratch(image); 
   uint8_t *E = UCHARDATA(e);
+  struct xvimage *d = allocscratch(rs, cs, ds, VFF_TYP_1_BYTE); 
+  uint8_t *D = UCHARDATA(d);
   uint8_t *I;
+  struct xvimage *inhibloc = NULL; /* copie locale de inhibit */
   int32_t step, nonstab;
-  int32_t top, topb;
-  uint8_t v[27];
 
   if (inhibit == NULL) 
   {
-    inhibit = copyimage(image); 
+    inhibit = inhibloc = copyimage(image); 
     razimage(inhibit);
   }
   I = UCHARDATA(inhibit);
@@ -1148,6 +1403,15 @@ R
 
   step = 0;
   nonstab = 1;
+  if (!reprise("CK3b", &step, image, inhibit, NULL, NULL))
+  {
+    freescratch(t);
+    freescratch(e);
+    freescratch(d);
+    if (inhibloc != NULL) freeimage(inhibloc);
+    termine_topo3d();
+    return 0;
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -1158,86 +1422,45 @@ R
 
     // AJOUTE LES EXTREMITES DANS E
     memset(E, 0, N);
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match_end(v)) E[i] = 1;
-      }
+    marque_extremites(S, E, rs, ps, N);
     // MARQUE LES POINTS SIMPLES NON DANS I
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]) && !I[i] && simple26(S, i, rs, ps, N))
-	SET_SIMPLE(S[i]);
+    marque_simples(S, I, NULL, 0, N, rs, ps);
     // DEUXIEME SOUS-ITERATION : MARQUE LES POINTS DE COURBE (2)
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2s(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match2s, 0, N, rs, ps, N);
     // TROISIEME SOUS-ITERATION : MARQUE LES POINTS DE COURBE (1)
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1s(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match1s, 0, N, rs, ps, N);
     // MARQUE LES POINTS DE COURBE (3)
-    for (i = 0; i < N; i++)
-    {
-      if (IS_OBJECT(S[i]) && !IS_SIMPLE(S[i]))
-      {    
-	top26(S, i, rs, ps, N, &top, &topb);
-	if (top > 1) SET_CURVE(S[i]);
-      }
-    }
+    marque_courbes(S, rs, ps, N);
 
     // DEMARQUE PTS DE COURBE ET LES MEMORISE DANS I
-    // AJOUTE AUX POINTS DE COURBE LEURS VOISINS QUI SONT DANS E
+    // AJOUTE AUX POINTS DE COURBE LEURS VOISINS QUI SONT DANS E :
+    // I := I \cup C \cup [E \cap dil26(C)], avec C dans T et dil26(C) dans D
+    for (i = 0; i < N; i++) T[i] = (IS_CURVE(S[i]) != 0);
+    if (!morpho_dil26(T, D, rs, cs, ds))
+    {
+      fprintf(stderr, "%s: malloc failed\n", F_NAME);
+      freescratch(t);
+      freescratch(e);
+      freescratch(d);
+      if (inhibloc != NULL) freeimage(inhibloc);
+      termine_topo3d();
+      return 0;
+    }
     for (i = 0; i < N; i++)
     { 
       UNSET_2M_CRUCIAL(S[i]);
-      if (IS_CURVE(S[i])) 
+      if (T[i] || (E[i] && D[i]))
       {
-        for (k = 0; k < 26; k += 1)        /* parcourt les voisins en 26-connexite */
-        {
-          j = voisin26(i, k, rs, ps, N);
-          if ((j != -1) && E[j])
-	  {
-	    UNSET_SIMPLE(S[j]); 
-	    I[j] = 1; 
-	  }
-	}
 	UNSET_SIMPLE(S[i]); 
 	I[i] = 1; 
       }
     }
     // MARQUE LES POINTS 2M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match2, 0, N, rs, ps, N);
     // MARQUE LES POINTS 1M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match1, 0, N, rs, ps, N);
     // MARQUE LES POINTS 0M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match0(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match0, 0, N, rs, ps, N);
 
     memset(T, 0, N);
     for (i = 0; i < N; i++) // T := [S \ P] \cup M, o M reprsente les pts marqus
@@ -1254,6 +1477,7 @@ writeimage(t,"_T");
 	nonstab = 1; 
       }
     for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+    sauvegarde("CK3b", step, image, inhibit, NULL, NULL);
   }
 
 #ifdef VERBOSE1
@@ -1262,16 +1486,19 @@ writeimage(t,"_T");
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
-  freeimage(e);
+  freescratch(t);
+  freescratch(e);
+  freescratch(d);
+  if (inhibloc != NULL) freeimage(inhibloc);
   termine_topo3d();
   return(1);
-} /* lskelCK3b() */
+} /* lskelCK3b_nb() */
 
 /* ==================================== */
-int32_t lskelCK3(struct xvimage *image, 
+static int32_t lskelCK3map_nb(struct xvimage *image, 
 	     int32_t nsteps,
-	     struct xvimage *inhibit)
+	     struct xvimage *inhibit,
+	     uint32_t *M)
 /* ==================================== */
 /*
 Squelette symtrique curviligne, variante
@@ -1286,30 +1513,23 @@ R
   C0 := voxels 0M-cruciaux (match0)
   P := P  \  [C2 \cup C1 \cup C0]
   S := S \ P
+Si M n'est pas NULL, M[i] reoit l'tape  laquelle le point i est retir
+(carte des tapes, voir lskelCK3inc).
 */
 #undef F_NAME
 #define F_NAME "lskelCK3"
 { 
-  int32_t i, j, k, x, y, z;
+  int32_t i;
   int32_t rs = rowsize(image);     /* taille ligne */
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t ds = depth(image);       /* nb plans */
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
-  uint8_t *T = UCHARDATA(t);
-  uint8_t *I;
+  uint8_t *I = NULL;
   int32_t step, nonstab;
-  int32_t top, topb;
-  uint8_t v[27];
 
-  if (inhibit == NULL) 
-  {
-    inhibit = copyimage(image); 
-    razimage(inhibit);
-  }
-  I = UCHARDATA(inhibit);
+  if (inhibit != NULL) I = UCHARDATA(inhibit);
 
   if (nsteps == -1) nsteps = 1000000000;
 
@@ -1323,6 +1543,11 @@ R
 
   step = 0;
   nonstab = 1;
+  if ((M == NULL) && !reprise("CK3", &step, image, inhibit, NULL, NULL))
+  {
+    termine_topo3d();
+    return 0;
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -1331,99 +1556,15 @@ R
     printf("step %d\n", step);
 #endif
 
-    // MARQUE LES POINTS SIMPLES NON DANS I
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]) && !I[i] && simple26(S, i, rs, ps, N))
-	SET_SIMPLE(S[i]);
-    // MARQUE LES POINTS DE SURFACE (2)
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2s(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-    // MARQUE LES POINTS DE SURFACE (3) ET LES POINTS INTERIEURS
-    for (i = 0; i < N; i++)
+    marque_simples(S, I, NULL, 0, N, rs, ps);
+    if (!marque_surfaces(S, rs, ps, N))
     {
-      if (IS_OBJECT(S[i]) && !IS_SIMPLE(S[i]))
-      {    
-	top26(S, i, rs, ps, N, &top, &topb);
-	if (topb > 1) SET_SURF(S[i]);
-	if (topb == 0) SET_SELECTED(S[i]);
-      }
-    }
-
-    // DEMARQUE PTS ET REND "NON-SIMPLES" LES CANDIDATS
-    for (i = 0; i < N; i++)
-    { 
-      UNSET_2M_CRUCIAL(S[i]);
-      if (IS_OBJECT(S[i])) 
-      {
-#ifdef SAUVE
-        for (k = 0; k < 12; k += 2)        /* parcourt les voisins en 6-connexite */
-        {
-          j = voisin6(i, k, rs, ps, N);
-#endif
-	for (k = 0; k < 26; k += 1)        /* parcourt les voisins en 26-connexite */
-        {
-	  j = voisin26(i, k, rs, ps, N);
-          if ((j != -1) && IS_SELECTED(S[j])) break;
-	}
-#ifdef SAUVE
-	if (k == 12) // le voxel est rsiduel
-#endif
-	if (k == 26) // le voxel est rsiduel
-	{
-	  for (k = 0; k < 26; k += 1)        /* parcourt les voisins en 26-connexite */
-          {
-	    j = voisin26(i, k, rs, ps, N);
-	    if ((j != -1) && IS_SURF(S[j]))break;
-	  }
-	  if (k == 26) UNSET_SIMPLE(S[i]);
-	}
-      }
+      termine_topo3d();
+      return 0;
     }
-    // MARQUE LES POINTS 2M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-    // MARQUE LES POINTS 1M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-    // MARQUE LES POINTS 0M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match0(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-
-    memset(T, 0, N);
-    for (i = 0; i < N; i++) // T := [S \ P] \cup M, o M reprsente les pts marqus
-      if ((S[i] && !IS_SIMPLE(S[i])) || IS_2M_CRUCIAL(S[i]) || IS_1M_CRUCIAL(S[i]) || IS_0M_CRUCIAL(S[i]))
-	T[i] = 1;
-#ifdef DEBUG
-writeimage(t,"_T");
-#endif
-
-    for (i = 0; i < N; i++)
-      if (S[i] && !T[i]) 
-      {
-	S[i] = 0; 
-	nonstab = 1; 
-      }
-    for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+    marque_cruciaux(S, rs, ps, N);
+    nonstab = retire_simples(S, 0, N, M, step);
+    if (M == NULL) sauvegarde("CK3", step, image, inhibit, NULL, NULL);
   }
 
 #ifdef VERBOSE1
@@ -1432,13 +1573,21 @@ writeimage(t,"_T");
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
   termine_topo3d();
   return(1);
-} /* lskelCK3() */
+} /* lskelCK3map_nb() */
+
+/* ==================================== */
+static int32_t lskelCK3_nb(struct xvimage *image, 
+	     int32_t nsteps,
+	     struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelCK3map_nb(image, nsteps, inhibit, NULL);
+} /* lskelCK3_nb() */
 
 /* ==================================== */
-int32_t lskelAK3(struct xvimage *image, 
+static int32_t lskelAK3_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit,
 	     int32_t filter)
@@ -1461,6 +1610,16 @@ R
   P := voxels de S \ K simples pour S
   R := voxels de P qui s'apparient avec le masque C (bertrand_match3)
   S := [S  \  P]  \cup  R
+
+Aprs n tapes, T est l'ensemble des voxels de distance d6 au fond 
+suprieure  n, et K l'ensemble des centres de boules d6 maximales de rayon 
+au plus n. La distance B et les maxima locaux M sont donc calculs une fois
+pour toutes (mcdist), et K = {x, M[x] et B[x] <= step}, T = {x, B[x] > step}.
+Aprs une reprise  l'tape n, B et M sont calculs sur T (la distance  S
+vaut n plus la distance  T) ; les voxels de K hors de T reoivent B = n.
+K et T ne sont construits qu'aux tapes de sauvegarde.
+Si l'image inhibit est fournie, elle remplace l'ensemble K (M := inhibit,
+B := 0).
 */
 #undef F_NAME
 #define F_NAME "lskelAK3"
@@ -1472,29 +1631,32 @@ R
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
+  struct xvimage *t = copyscratch(image); 
   uint8_t *T = UCHARDATA(t);
-  struct xvimage *r = copyimage(image); 
-  uint8_t *R = UCHARDATA(r);
-  struct xvimage *e = copyimage(image); 
-  uint8_t *E = UCHARDATA(e);
-  struct xvimage *d = copyimage(image); 
+  struct xvimage *m = copyscratch(image); 
+  uint8_t *M = UCHARDATA(m);
+  struct xvimage *d = copyscratch(image); 
   uint8_t *D = UCHARDATA(d);
-  struct xvimage *k = copyimage(image); 
+  struct xvimage *k = copyscratch(image); 
   uint8_t *K = UCHARDATA(k);
+  int32_t *B;
   int32_t step, nonstab;
-  uint8_t v[27];
-
-  if (inhibit != NULL)
-  {
-    fprintf(stderr, "%s: inhibit image not implemented\n", F_NAME);
-    return 0;
-  }
 
   if (nsteps == -1) nsteps = 1000000000;
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 1; // normalize values
 
+  B = (int32_t *)malloc(N * sizeof(int32_t));
+  if (B == NULL)
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    freescratch(t);
+    freescratch(m);
+    freescratch(d);
+    freescratch(k);
+    return 0;
+  }
+
   init_topo3d();
 
   /* ================================================ */
@@ -1506,6 +1668,40 @@ R
   // K := \emptyset ; T := S
   memset(K, 0, N);
   memcpy(T, S, N);
+  if (!reprise("AK3", &step, image, inhibit, k, t))
+  {
+    freescratch(t);
+    freescratch(m);
+    freescratch(d);
+    freescratch(k);
+    free(B);
+    termine_topo3d();
+    return 0;
+  }
+  if (inhibit != NULL)
+  {
+    uint8_t *I = UCHARDATA(inhibit);
+    for (i = 0; i < N; i++) M[i] = (I[i] != 0);
+    memset(B, 0, N * sizeof(int32_t));
+  }
+  else
+  {
+    if (!dist_bloc(T, B, rs, cs, ds))
+    {
+      fprintf(stderr, "%s: malloc failed\n", F_NAME);
+      freescratch(t);
+      freescratch(m);
+      freescratch(d);
+      freescratch(k);
+      free(B);
+      termine_topo3d();
+      return 0;
+    }
+    dist_axebloc(B, M, rs, cs, ds);
+    for (i = 0; i < N; i++)
+      if (T[i]) B[i] += step;
+      else if (K[i]) { M[i] = 1; B[i] = step; }
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -1514,59 +1710,18 @@ R
     printf("step %d\n", step);
 #endif
 
-    //  E := T \ominus \Gamma_6 
-    memset(E, 0, N);
-    for (i = 0; i < N; i++) 
-      if (T[i] && (nbvoiso6(T, i, rs, ps, N) == 6)) E[i] = 1;
-
-    //  D := E \oplus \Gamma_6
-    memset(D, 0, N);
-    for (i = 0; i < N; i++)
-      if (E[i] || (nbvoiso6(E, i, rs, ps, N) >= 1)) D[i] = 1;
-
-    //  D := T \ D
-    for (i = 0; i < N; i++)
-      if (T[i] && !D[i]) D[i] = 1; else D[i] = 0;
-
-    //  T := E
-    memcpy(T, E, N);
-
-    //  K := K \cup D
-    for (i = 0; i < N; i++)
-      if (D[i]) K[i] = 1;
-
     // PREMIERE SOUS-ITERATION : MARQUE LES POINTS SIMPLES qui ne sont pas dans K
+    marque_simples(S, NULL, NULL, 0, N, rs, ps);
     if (step > filter)
-    {
-      for (i = 0; i < N; i++) 
-	if (S[i] && !K[i] && simple26(S, i, rs, ps, N))
-	  SET_SIMPLE(S[i]);
-    }
-    else
-    {
       for (i = 0; i < N; i++) 
-	if (S[i] && simple26(S, i, rs, ps, N))
-	  SET_SIMPLE(S[i]);
-    }
+	if (IS_SIMPLE(S[i]) && M[i] && (B[i] <= step))
+	  UNSET_SIMPLE(S[i]);
 
     // DEUXIEME SOUS-ITERATION : MARQUE LES CLIQUES CRUCIALES CORRESPONDANT AUX 2-FACES
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match2, 0, N, rs, ps, N);
 
     // TROISIEME SOUS-ITERATION : MARQUE LES CLIQUES CRUCIALES CORRESPONDANT AUX 1-FACES
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  //if (match1s(v))  // VARIANTE POUR EVITER LES "ECHANCRURES" ( voir)
-	  insert_vois(v, S, i, rs, ps, N);
-      }
+    marque_match(S, match1, 0, N, rs, ps, N);  //match1s : VARIANTE POUR EVITER LES "ECHANCRURES" ( voir)
 
     // D := [S \ P] \cup  R, o R reprsente les pts marqus
     memset(D, 0, N);
@@ -1581,6 +1736,13 @@ R
 	nonstab = 1; 
       }
     for (i = 0; i < N; i++) if (S[i]) S[i] = 1;
+    if ((inhibit == NULL) && echeance(step))
+      for (i = 0; i < N; i++)
+      {
+	K[i] = M[i] && (B[i] <= step);
+	T[i] = (B[i] > step);
+      }
+    sauvegarde("AK3", step, image, inhibit, k, t);
   }
 
 #ifdef VERBOSE1
@@ -1589,17 +1751,17 @@ R
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
-  freeimage(r);
-  freeimage(e);
-  freeimage(d);
-  freeimage(k);
+  freescratch(t);
+  freescratch(m);
+  freescratch(d);
+  freescratch(k);
+  free(B);
   termine_topo3d();
   return(1);
-} /* lskelAK3() */
+} /* lskelAK3_nb() */
 
 /* ==================================== */
-int32_t lskelMK3(struct xvimage *image, 
+static int32_t lskelMK3_nb(struct xvimage *image, 
 	     int32_t nsteps,
 	     struct xvimage *inhibit)
 /* ==================================== */
@@ -1618,18 +1780,15 @@ R
 #undef F_NAME
 #define F_NAME "lskelMK3"
 { 
-  int32_t i, j, x, y, z;
+  int32_t i;
   int32_t rs = rowsize(image);     /* taille ligne */
   int32_t cs = colsize(image);     /* taille colonne */
   int32_t ds = depth(image);       /* nb plans */
   int32_t ps = rs * cs;            /* taille plan */
   int32_t N = ps * ds;             /* taille image */
   uint8_t *S = UCHARDATA(image);      /* l'image de depart */
-  struct xvimage *t = copyimage(image); 
-  uint8_t *T = UCHARDATA(t);
   uint8_t *I = NULL;
   int32_t step, nonstab;
-  uint8_t v[27];
 
   if (nsteps == -1) nsteps = 1000000000;
 
@@ -1645,6 +1804,11 @@ R
 
   step = 0;
   nonstab = 1;
+  if (!reprise("MK3", &step, image, inhibit, NULL, NULL))
+  {
+    termine_topo3d();
+    return 0;
+  }
   while (nonstab && (step < nsteps))
   {
     nonstab = 0;
@@ -1653,76 +1817,96 @@ R
     printf("MK3b step %d\n", step);
 #endif
 
-    // PREMIERE SOUS-ITERATION : MARQUE LES POINTS SIMPLES ET PAS DANS I
-    for (i = 0; i < N; i++) 
-      if (IS_OBJECT(S[i]) && simple26(S, i, rs, ps, N) && (!I || !I[i]))
-	SET_SIMPLE(S[i]);
-#ifdef DEBUG
-writeimage(image,"_S");
-#endif
-    // DEUXIEME SOUS-ITERATION : MARQUE LES POINTS 2M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-	extract_vois(S, i, rs, ps, N, v);
-	if (match2(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-#ifdef DEBUG
-memset(R, 0, N);
-for (i = 0; i < N; i++) if (IS_2M_CRUCIAL(S[i])) R[i] = 255;
-writeimage(r,"_C2");
-#endif
+    marque_simples(S, I, NULL, 0, N, rs, ps);
+    marque_cruciaux(S, rs, ps, N);
+    nonstab = retire_simples(S, 0, N, NULL, 0);
+    sauvegarde("MK3", step, image, inhibit, NULL, NULL);
+  }
 
-    // TROISIEME SOUS-ITERATION : MARQUE LES POINTS 1M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-#ifdef DEBUG
-printf("%d %d %d\n", i % rs, (i % ps) / rs, i / ps);
-#endif
-	extract_vois(S, i, rs, ps, N, v);
-	if (match1(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-#ifdef DEBUG
-memset(R, 0, N);
-for (i = 0; i < N; i++) if (IS_1M_CRUCIAL(S[i])) R[i] = 255;
-writeimage(r,"_C1");
+#ifdef VERBOSE1
+    printf("number of steps: %d\n", step);
 #endif
 
-    // QUATRIEME SOUS-ITERATION : MARQUE LES POINTS 0M-CRUCIAUX
-    for (i = 0; i < N; i++) 
-      if (IS_SIMPLE(S[i]))
-      { 
-#ifdef DEBUG
-printf("%d %d %d\n", i % rs, (i % ps) / rs, i / ps);
-#endif
-	extract_vois(S, i, rs, ps, N, v);
-	if (match0(v))
-	  insert_vois(v, S, i, rs, ps, N);
-      }
-#ifdef DEBUG
-memset(R, 0, N);
-for (i = 0; i < N; i++) if (IS_0M_CRUCIAL(S[i])) R[i] = 255;
-writeimage(r,"_C0");
-#endif
+  for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-    memset(T, 0, N);
-    for (i = 0; i < N; i++) // T := [S \ P] \cup  R, o R reprsente les pts marqus
-      if ((S[i] && !IS_SIMPLE(S[i])) || IS_2M_CRUCIAL(S[i]) || IS_1M_CRUCIAL(S[i]) || IS_0M_CRUCIAL(S[i]))
-	T[i] = 1;
-#ifdef DEBUG
-writeimage(t,"_T");
+  termine_topo3d();
+  return(1);
+} /* lskelMK3_nb() */
+
+/* ==================================== */
+static int32_t lskelMK3f_nb(struct xvimage *image, 
+	     int32_t nsteps,
+	     struct xvimage *inhibit)
+/* ==================================== */
+/*
+Mme rsultat que MK3, mais les sous-itrations d'une tape sont 
+enchanes plan par plan (front d'onde) au lieu de parcourir chacune 
+tout le volume : une sous-itration ne lit et n'crit que les plans 
+z-1..z+1 du plan z trait, elle est donc applique au plan z ds que 
+la prcdente a termin les plans ncessaires. 
+Retards (en plans) par rapport au marquage des points simples :
+  match2 : 1 (les points simples des plans z-1..z+1 doivent tre marqus)
+  match1 : 3, match0 : 5 (le plan z+1 ne doit plus etre modifi par la 
+    sous-itration prcdente, qui crit dans les plans voisins)
+  retrait : 6 (le plan z ne doit plus tre lu par match0)
+Seuls une dizaine de plans sont actifs  un instant donn.
+*/
+#undef F_NAME
+#define F_NAME "lskelMK3f"
+{ 
+  int32_t i, w, z, k;
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  int32_t ds = depth(image);       /* nb plans */
+  int32_t ps = rs * cs;            /* taille plan */
+  int32_t N = ps * ds;             /* taille image */
+  uint8_t *S = UCHARDATA(image);      /* l'image de depart */
+  uint8_t *I = NULL;
+  int32_t step, nonstab;
+  static int32_t retard[5] = {0, 1, 3, 5, 6};
+
+  if (nsteps == -1) nsteps = 1000000000;
+
+  for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+
+  if (inhibit != NULL) I = UCHARDATA(inhibit);
+
+  init_topo3d();
+
+  /* ================================================ */
+  /*               DEBUT ALGO                         */
+  /* ================================================ */
+
+  step = 0;
+  nonstab = 1;
+  if (!reprise("MK3", &step, image, inhibit, NULL, NULL))
+  {
+    termine_topo3d();
+    return 0;
+  }
+  while (nonstab && (step < nsteps))
+  {
+    nonstab = 0;
+    step++;
+#ifdef VERBOSE
+    printf("MK3f step %d\n", step);
 #endif
 
-    for (i = 0; i < N; i++)
-      if (S[i] && !T[i]) 
+    for (w = 0; w < ds + retard[4]; w++)
+      for (k = 0; k < 5; k++)
       {
-	S[i] = 0; 
-	nonstab = 1; 
+	z = w - retard[k];
+	if ((z < 0) || (z >= ds)) continue;
+	switch (k)
+	{
+	  case 0: marque_simples(S, I, NULL, z * ps, (z + 1) * ps, rs, ps); break;
+	  case 1: marque_match(S, match2, z * ps, (z + 1) * ps, rs, ps, N); break;
+	  case 2: marque_match(S, match1, z * ps, (z + 1) * ps, rs, ps, N); break;
+	  case 3: marque_match(S, match0, z * ps, (z + 1) * ps, rs, ps, N); break;
+	  case 4: if (retire_simples(S, z * ps, (z + 1) * ps, NULL, 0)) nonstab = 1; break;
+	}
       }
-    for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+    sauvegarde("MK3", step, image, inhibit, NULL, NULL);
   }
 
 #ifdef VERBOSE1
@@ -1731,7 +1915,911 @@ writeimage(t,"_T");
 
   for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
 
-  freeimage(t);
   termine_topo3d();
   return(1);
-} /* lskelMK3() */
+} /* lskelMK3f_nb() */
+
+/* ==================================== */
+/* ==================================== */
+/*        AMINCISSEMENT SEQUENTIEL      */
+/* ==================================== */
+/* ==================================== */
+
+/* ==================================== */
+static int32_t lskelseq3_nb(struct xvimage *image, 
+	     int32_t nsteps,
+	     struct xvimage *inhibit,
+	     int32_t algo)
+/* ==================================== */
+/*
+Amincissement squentiel guid par la distance euclidienne
+Donnes: S, I (contrainte), algo (LSKEL_MK3, LSKEL_CK3 ou LSKEL_EK3)
+  D := carr de la distance euclidienne au fond (dist_quad)
+  F := points de bord de S \ I (D = 1), rangs par valeur de D
+  Tant que F non vide
+    x := point de F de plus petite distance (premier arriv)
+    si x simple pour S
+      si algo = EK3 et x point extrmit alors I := I \cup {x}
+      sinon S := S \ {x} ; F := F \cup (voisins de x dans S \ I)
+    sinon si algo = CK3 et T(x) > 1 (point de courbe) alors I := I \cup {x}
+
+La file F est une file  niveaux (Seaux, indexe par D) dont les points 
+sont marqus dans Q : chaque point y entre au plus une fois au dpart et 
+une fois par voisin retir, le cot total est en O(N + max D). Le rsultat n'a pas la 
+symtrie des algorithmes parallles, qui restent la rfrence, mais il est
+obtenu en une seule passe sur les points de bord successifs, ce qui est 
+beaucoup plus rapide pour les objets pais. Les contraintes sont celles 
+de lskelEK3 (extrmits) et lskelCK3a (points de courbe).
+Si nsteps >= 0, seuls les points de distance au plus nsteps sont traits.
+*/
+#undef F_NAME
+#define F_NAME "lskelseq3"
+{ 
+  int32_t i, j, n;
+  int32_t rs = rowsize(image);     /* taille ligne */
+  int32_t cs = colsize(image);     /* taille colonne */
+  int32_t ds = depth(image);       /* nb plans */
+  int32_t ps = rs * cs;            /* taille plan */
+  int32_t N = ps * ds;             /* taille image */
+  uint8_t *S = UCHARDATA(image);      /* l'image de depart */
+  uint8_t *I;
+  int32_t *D;
+  uint8_t *Q;
+  Seaux *F;
+  int32_t dmax, nret = 0;
+  uint32_t m;
+  int32_t off[26];
+  struct xvimage *inh = NULL;
+
+  if (inhibit == NULL) 
+  {
+    inh = inhibit = allocscratch(rs, cs, ds, VFF_TYP_1_BYTE);
+    if (inh == NULL)
+    {
+      fprintf(stderr, "%s: allocscratch failed\n", F_NAME);
+      return 0;
+    }
+  }
+  I = UCHARDATA(inhibit);
+
+  for (i = 0; i < N; i++) if (S[i]) S[i] = S_OBJECT;
+
+  D = (int32_t *)malloc(N * sizeof(int32_t));
+  Q = (uint8_t *)calloc(N, 1);
+  if ((D == NULL) || (Q == NULL))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    if (D) free(D);
+    if (Q) free(Q);
+    if (inh) freescratch(inh);
+    return 0;
+  }
+  if (!dist_quad(S, D, rs, cs, ds))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    free(D); free(Q);
+    if (inh) freescratch(inh);
+    return 0;
+  }
+  dmax = 0;
+  for (i = 0; i < N; i++) if (D[i] > dmax) dmax = D[i];
+  if ((nsteps >= 0) && (nsteps < 46341) && (nsteps * nsteps < dmax)) dmax = nsteps * nsteps;
+  if ((F = CreeSeaux(dmax + 1)) == NULL)
+  {
+    fprintf(stderr, "%s: CreeSeaux failed\n", F_NAME);
+    free(D); free(Q);
+    if (inh) freescratch(inh);
+    return 0;
+  }
+
+  offsetvois26(rs, ps, off);
+  init_topo3d();
+  topo_alloue();
+
+  /* ================================================ */
+  /*               DEBUT ALGO                         */
+  /* ================================================ */
+
+  for (i = 0; i < N; i++)
+    if (S[i] && !I[i] && (D[i] == 1) && (dmax >= 1)) { SeauxPush(F, 1, i); Q[i] = 1; }
+
+  while (!SeauxVide(F))
+  {
+    i = (int32_t)SeauxPop(F, NULL); 
+    Q[i] = 0;
+    if (!S[i] || I[i]) continue;
+    m = mask27(S, i, rs, ps);
+    if (is_simple_point(m))
+    {
+      if ((algo == LSKEL_EK3) && is_end_point(m)) { I[i] = 1; continue; }
+      S[i] = 0;
+      nret++;
+      for (n = 0; n < 26; n++)
+      {
+	j = i + off[n];
+	if (S[j] && !I[j] && !Q[j] && (D[j] <= dmax))
+	{
+	  SeauxPush(F, D[j], j);
+	  Q[j] = 1;
+	}
+      }
+    }
+    else if ((algo == LSKEL_CK3) && is_curve_point(m)) I[i] = 1;
+  }
+
+#ifdef VERBOSE1
+    printf("number of deleted points: %d\n", nret);
+#endif
+
+  for (i = 0; i < N; i++) if (S[i]) S[i] = 255; // normalize values
+
+  free(D); free(Q);
+  SeauxTermine(F);
+  if (inh) freescratch(inh);
+  termine_topo3d();
+  return(1);
+} /* lskelseq3_nb() */
+
+/* ==================================== */
+/* ==================================== */
+/*               POINTS D'ENTREE        */
+/* ==================================== */
+/* ==================================== */
+
+/* ==================================== */
+static int32_t lskelframe(
+  int32_t (*skel)(struct xvimage *, int32_t, struct xvimage *),
+  struct xvimage *image,
+  int32_t nsteps,
+  struct xvimage *inhibit)
+/* ==================================== */
+/*
+  Les fonctions *_nb supposent qu'aucun point objet n'est sur le bord de
+  l'image, ce qui dispense de tout test de bord (simple26_nb, decalages_vois, 
+  offsetvois26). Si l'objet touche le bord, l'algorithme 
+  travaille sur une copie entoure d'un cadre nul (addframe), retir 
+   la fin (delframe). Il en est de mme pour l'image d'inhibition, que
+  certains algorithmes modifient.
+*/
+#undef F_NAME
+#define F_NAME "lskelframe"
+{
+  struct xvimage *fimage, *finhibit = NULL;
+  int32_t ret;
+
+  if (depth(image) < 2)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rowsize(image)) || (colsize(inhibit) != colsize(image)) ||
+       (depth(inhibit) != depth(image))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  if (!touchframe(image)) return skel(image, nsteps, inhibit);
+
+  if (!addframes(image, inhibit, &fimage, &finhibit)) return 0;
+  ret = skel(fimage, nsteps, finhibit);
+  delframe(image, fimage);
+  freeimage(fimage);
+  if (finhibit != NULL)
+  {
+    delframe(inhibit, finhibit);
+    freeimage(finhibit);
+  }
+  return ret;
+} /* lskelframe() */
+
+/* ==================================== */
+int32_t lskelMK3a(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelMK3a_nb, image, nsteps, inhibit);
+} /* lskelMK3a() */
+
+/* ==================================== */
+int32_t lskelEK3(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelEK3_nb, image, nsteps, inhibit);
+} /* lskelEK3() */
+
+/* ==================================== */
+int32_t lskelCK3a(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelCK3a_nb, image, nsteps, inhibit);
+} /* lskelCK3a() */
+
+/* ==================================== */
+int32_t lskelCK3b(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelCK3b_nb, image, nsteps, inhibit);
+} /* lskelCK3b() */
+
+/* ==================================== */
+int32_t lskelCK3(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelCK3_nb, image, nsteps, inhibit);
+} /* lskelCK3() */
+
+/* ==================================== */
+int32_t lskelAK3(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit, int32_t filter)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "lskelAK3"
+{
+  struct xvimage *fimage, *finhibit = NULL;
+  int32_t ret;
+
+  if (depth(image) < 2)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rowsize(image)) || (colsize(inhibit) != colsize(image)) ||
+       (depth(inhibit) != depth(image))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  if (!touchframe(image)) return lskelAK3_nb(image, nsteps, inhibit, filter);
+
+  if (!addframes(image, inhibit, &fimage, &finhibit)) return 0;
+  ret = lskelAK3_nb(fimage, nsteps, finhibit, filter);
+  delframe(image, fimage);
+  freeimage(fimage);
+  if (finhibit != NULL) freeimage(finhibit);
+  return ret;
+} /* lskelAK3() */
+
+/* ==================================== */
+int32_t lskelseq3(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit, int32_t algo)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "lskelseq3"
+{
+  struct xvimage *fimage, *finhibit = NULL;
+  int32_t ret;
+
+  if (depth(image) < 2)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((algo != LSKEL_MK3) && (algo != LSKEL_CK3) && (algo != LSKEL_EK3))
+  {
+    fprintf(stderr, "%s: bad algorithm code: %d\n", F_NAME, algo);
+    return 0;
+  }
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rowsize(image)) || (colsize(inhibit) != colsize(image)) ||
+       (depth(inhibit) != depth(image))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  if (!touchframe(image)) return lskelseq3_nb(image, nsteps, inhibit, algo);
+
+  if (!addframes(image, inhibit, &fimage, &finhibit)) return 0;
+  ret = lskelseq3_nb(fimage, nsteps, finhibit, algo);
+  delframe(image, fimage);
+  freeimage(fimage);
+  if (finhibit != NULL)
+  {
+    delframe(inhibit, finhibit);
+    freeimage(finhibit);
+  }
+  return ret;
+} /* lskelseq3() */
+
+/* ==================================== */
+int32_t lskelMK3(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelMK3_nb, image, nsteps, inhibit);
+} /* lskelMK3() */
+
+/* ==================================== */
+int32_t lskelMK3f(struct xvimage *image, int32_t nsteps, struct xvimage *inhibit)
+/* ==================================== */
+{
+  return lskelframe(lskelMK3f_nb, image, nsteps, inhibit);
+} /* lskelMK3f() */
+
+/* ==================================== */
+int32_t lskelmulti3d(struct xvimage *image, 
+		     int32_t nsteps,
+		     struct xvimage *inhibit,
+		     int32_t nalgo,
+		     int32_t *algo,
+		     struct xvimage **result)
+/* ==================================== */
+/*
+  Applique les algorithmes algo[0..nalgo-1] (LSKEL_MK3, LSKEL_CK3, LSKEL_EK3)
+  a la meme image et range le resultat de algo[a] dans result[a] (alloue
+  ici). Les images image et inhibit ne sont pas modifiees. Le resultat est
+  celui de nalgo appels independants, mais :
+  - les donnees sont lues et encadrees (addframe) une seule fois, 
+    l'image d'inhibition est partagee sauf pour EK3 qui la modifie ;
+  - a chaque etape, la classification des points simples est calculee une 
+    seule fois pour les voxels dont le 26-voisinage est le meme dans toutes 
+    les variantes ; seuls les voxels proches d'une divergence sont 
+    reclasses par chaque variante ;
+  - les variantes dont les marques coincident apres le marquage des points 
+    simples partagent le marquage des points cruciaux ;
+  - avec OpenMP, la classification est repartie par plans entre les 
+    threads et les variantes sont traitees en parallele.
+*/
+#undef F_NAME
+#define F_NAME "lskelmulti3d"
+{
+  struct xvimage *fimage, *finhibit;
+  struct xvimage **work, **winhibit;
+  uint8_t **S, **I, *S0, *P, *D;
+  int32_t *nonstab, *actif, *lead;
+  int32_t off[26];
+  int32_t rs, cs, ds, ps, N;
+  int32_t a, b, i, k, z, step, nactif, frame, echec = 0, ret = 0;
+
+  if (depth(image) < 2)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((inhibit != NULL) && 
+      ((rowsize(inhibit) != rowsize(image)) || (colsize(inhibit) != colsize(image)) ||
+       (depth(inhibit) != depth(image))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  for (a = 0; a < nalgo; a++)
+    if ((algo[a] != LSKEL_MK3) && (algo[a] != LSKEL_CK3) && (algo[a] != LSKEL_EK3))
+    {
+      fprintf(stderr, "%s: bad algorithm code: %d\n", F_NAME, algo[a]);
+      return 0;
+    }
+  if (nalgo < 1) return 1;
+
+  frame = touchframe(image);
+  fimage = image; finhibit = inhibit;
+  if (frame)
+  {
+    if (!addframes(image, inhibit, &fimage, &finhibit)) return 0;
+  }
+  rs = rowsize(fimage);
+  cs = colsize(fimage);
+  ds = depth(fimage);
+  ps = rs * cs;
+  N = ps * ds;
+
+  work = (struct xvimage **)calloc(nalgo, sizeof(struct xvimage *));
+  winhibit = (struct xvimage **)calloc(nalgo, sizeof(struct xvimage *));
+  S = (uint8_t **)calloc(nalgo, sizeof(uint8_t *));
+  I = (uint8_t **)calloc(nalgo, sizeof(uint8_t *));
+  nonstab = (int32_t *)calloc(nalgo, sizeof(int32_t));
+  actif = (int32_t *)calloc(nalgo, sizeof(int32_t));
+  lead = (int32_t *)calloc(nalgo, sizeof(int32_t));
+  P = (uint8_t *)malloc(N);
+  D = (uint8_t *)malloc(N);
+  if (!work || !winhibit || !S || !I || !nonstab || !actif || !lead || !P || !D)
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    goto fin;
+  }
+
+  for (a = 0; a < nalgo; a++)
+  {
+    if ((work[a] = copyimage(fimage)) == NULL)
+    {
+      fprintf(stderr, "%s: copyimage failed\n", F_NAME);
+      goto fin;
+    }
+    S[a] = UCHARDATA(work[a]);
+    for (i = 0; i < N; i++) if (S[a][i]) S[a][i] = S_OBJECT;
+    if (algo[a] == LSKEL_EK3) // EK3 ajoute les extremites dans I
+    {
+      winhibit[a] = copyimage(finhibit ? finhibit : fimage);
+      if (winhibit[a] == NULL)
+      {
+	fprintf(stderr, "%s: copyimage failed\n", F_NAME);
+	goto fin;
+      }
+      if (finhibit == NULL) razimage(winhibit[a]);
+      I[a] = UCHARDATA(winhibit[a]);
+    }
+    else if (finhibit != NULL) I[a] = UCHARDATA(finhibit);
+    nonstab[a] = 1;
+  }
+
+  offsetvois26(rs, ps, off);
+  if (nsteps == -1) nsteps = 1000000000;
+
+  /* ================================================ */
+  /*               DEBUT ALGO                         */
+  /* ================================================ */
+
+  step = 0;
+  while (step < nsteps)
+  {
+    nactif = 0; b = -1;
+    for (a = 0; a < nalgo; a++) 
+    {
+      actif[a] = nonstab[a];
+      if (actif[a]) { nactif++; if (b < 0) b = a; }
+    }
+    if (nactif == 0) break;
+    step++;
+#ifdef VERBOSE
+    printf("step %d: %d active\n", step, nactif);
+#endif
+    S0 = S[b];
+
+    // D : voxels dont l'etat differe entre les variantes actives
+    if (nactif > 1)
+    {
+      memset(D, 0, N);
+      for (a = b + 1; a < nalgo; a++)
+	if (actif[a])
+	  for (i = 0; i < N; i++) if (S[a][i] != S0[i]) D[i] = 1;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel private(a, b, i, k, z)
+#endif
+    {
+      init_topo3d();
+
+      // CLASSIFICATION PARTAGEE DES POINTS SIMPLES
+      if (nactif > 1)
+      {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+	for (z = 0; z < ds; z++)
+	  for (i = z * ps; i < (z + 1) * ps; i++)
+	  {
+	    if (D[i]) { P[i] = 2; continue; }
+	    if (!S0[i]) { P[i] = 0; continue; }
+	    for (k = 0; k < 26; k++) if (D[i + off[k]]) break;
+	    if (k < 26) P[i] = 2;
+	    else P[i] = simple26_nb(S0, i, rs, ps) ? 1 : 0;
+	  }
+      }
+
+      // MARQUE LES POINTS SIMPLES (ET LES EXTREMITES, LES SURFACES)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1) reduction(|:echec)
+#endif
+      for (a = 0; a < nalgo; a++)
+	if (actif[a])
+	{
+	  if (algo[a] == LSKEL_EK3) marque_extremites(S[a], I[a], rs, ps, N);
+	  marque_simples(S[a], I[a], (nactif > 1) ? P : NULL, 0, N, rs, ps);
+	  if ((algo[a] == LSKEL_CK3) && !marque_surfaces(S[a], rs, ps, N)) echec = 1;
+	}
+
+      // REGROUPE LES VARIANTES DONT LES MARQUES COINCIDENT
+#ifdef _OPENMP
+#pragma omp single
+#endif
+      for (a = 0; a < nalgo; a++)
+	if (actif[a])
+	{
+	  lead[a] = a;
+	  for (b = 0; b < a; b++)
+	    if (actif[b] && (lead[b] == b) && !memcmp(S[a], S[b], N))
+	    {
+	      lead[a] = b;
+	      break;
+	    }
+	}
+
+      // MARQUE LES POINTS CRUCIAUX
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (a = 0; a < nalgo; a++)
+	if (actif[a] && (lead[a] == a)) marque_cruciaux(S[a], rs, ps, N);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (a = 0; a < nalgo; a++)
+	if (actif[a] && (lead[a] != a)) memcpy(S[a], S[lead[a]], N);
+
+      // RETIRE LES POINTS SIMPLES NON CRUCIAUX
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+      for (a = 0; a < nalgo; a++)
+	if (actif[a]) nonstab[a] = retire_simples(S[a], 0, N, NULL, 0);
+
+      termine_topo3d();
+    }
+    if (echec) goto fin;
+  }
+
+#ifdef VERBOSE1
+    printf("number of steps: %d\n", step);
+#endif
+
+  for (a = 0; a < nalgo; a++)
+  {
+    for (i = 0; i < N; i++) if (S[a][i]) S[a][i] = 255; // normalize values
+    if (frame)
+    {
+      if ((result[a] = copyimage(image)) == NULL)
+      {
+	fprintf(stderr, "%s: copyimage failed\n", F_NAME);
+	for (b = 0; b < a; b++) freeimage(result[b]);
+	goto fin;
+      }
+      delframe(result[a], work[a]);
+    }
+    else
+    {
+      result[a] = work[a];
+      work[a] = NULL;
+    }
+  }
+  ret = 1;
+
+ fin:
+  for (a = 0; a < nalgo; a++)
+  {
+    if (work && work[a]) freeimage(work[a]);
+    if (winhibit && winhibit[a]) freeimage(winhibit[a]);
+  }
+  if (frame)
+  {
+    freeimage(fimage);
+    if (finhibit != NULL) freeimage(finhibit);
+  }
+  free(work); free(winhibit); free(S); free(I);
+  free(nonstab); free(actif); free(lead);
+  free(P); free(D);
+  return ret;
+} /* lskelmulti3d() */
+
+/* ==================================== */
+/* ==================================== */
+/*   RE-SQUELETTISATION INCREMENTALE    */
+/* ==================================== */
+/* ==================================== */
+
+/*
+  Rayon d'influence d'une tape de CK3 : l'tat d'un point aprs une 
+  tape ne dpend que de l'tat, avant l'tape, des points situs  une 
+  distance (norme infinie) au plus CK3_RAYON. Chaque sous-itration qui 
+  lit des marques tend ce rayon : le marquage des points simples lit le
+  26-voisinage (1), un marquage de cliques (marque_match) lit le 
+  26-voisinage de chaque point simple et marque ses voisins (2), le 
+  dmarquage de marque_surfaces lit les marques du 26-voisinage (1) :
+  1 (simples) + 2 (match2s) + 1 (dmarquage) + 2 + 2 + 2 (match2, 
+  match1, match0) = 10. Les tests de surface (top26) et de point 
+  intrieur ne lisent que l'objet, inchang pendant l'tape, et aucun 
+  marquage ne lit les marques qu'il pose (match1 lit les marques 2M, 
+  match0 les marques 2M et 1M).
+*/
+#define CK3_RAYON 10
+
+typedef struct {
+  int32_t xmin, ymin, zmin, xmax, ymax, zmax;
+} boite3d;
+
+/* ==================================== */
+static void dilateboite(boite3d *b, boite3d *res, int32_t r, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+// res := b dilate de r et restreinte au domaine de l'image
+{
+  res->xmin = max(b->xmin - r, 0); res->xmax = min(b->xmax + r, rs - 1);
+  res->ymin = max(b->ymin - r, 0); res->ymax = min(b->ymax + r, cs - 1);
+  res->zmin = max(b->zmin - r, 0); res->zmax = min(b->zmax + r, ds - 1);
+} /* dilateboite() */
+
+/* ==================================== */
+static void etendboite(boite3d *b, int32_t *vide, int32_t x, int32_t y, int32_t z)
+/* ==================================== */
+// tend b (vide si *vide) au point (x,y,z)
+{
+  if (*vide) 
+  { 
+    b->xmin = b->xmax = x; b->ymin = b->ymax = y; b->zmin = b->zmax = z; 
+    *vide = 0; 
+    return;
+  }
+  b->xmin = min(b->xmin, x); b->xmax = max(b->xmax, x);
+  b->ymin = min(b->ymin, y); b->ymax = max(b->ymax, y);
+  b->zmin = min(b->zmin, z); b->zmax = max(b->zmax, z);
+} /* etendboite() */
+
+#define BX(b) ((b)->xmax - (b)->xmin + 1)
+#define BY(b) ((b)->ymax - (b)->ymin + 1)
+#define BZ(b) ((b)->zmax - (b)->zmin + 1)
+#define DANSBOITE(b,x,y,z) (((x) >= (b)->xmin) && ((x) <= (b)->xmax) && \
+                            ((y) >= (b)->ymin) && ((y) <= (b)->ymax) && \
+                            ((z) >= (b)->zmin) && ((z) <= (b)->zmax))
+#define INDBOITE(b,x,y,z) ((((z) - (b)->zmin) * BY(b) + ((y) - (b)->ymin)) * BX(b) + ((x) - (b)->xmin))
+
+/* ==================================== */
+int32_t lskelCK3map(struct xvimage *image, 
+		    struct xvimage *inhibit,
+		    struct xvimage *map)
+/* ==================================== */
+/*
+  Squelette CK3 (jusqu' stabilit) de image, et carte des tapes :
+  map (VFF_TYP_4_BYTE, mme taille que image) reoit pour chaque point 
+  de image l'tape  laquelle il est retir, et 0 pour les points du 
+  squelette et du fond. 
+*/
+#undef F_NAME
+#define F_NAME "lskelCK3map"
+{
+  struct xvimage *fimage, *finhibit = NULL;
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image);
+  int32_t x, y, z, ret;
+  uint32_t *M, *FM;
+
+  if (ds < 2)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((datatype(map) != VFF_TYP_4_BYTE) || 
+      (rowsize(map) != rs) || (colsize(map) != cs) || (depth(map) != ds) ||
+      ((inhibit != NULL) && 
+       ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs) || (depth(inhibit) != ds))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes or types\n", F_NAME);
+    return 0;
+  }
+  M = ULONGDATA(map);
+  memset(M, 0, rs * cs * ds * sizeof(uint32_t));
+  if (!touchframe(image)) return lskelCK3map_nb(image, -1, inhibit, M);
+
+  if (!addframes(image, inhibit, &fimage, &finhibit)) return 0;
+  FM = (uint32_t *)calloc((rs + 2) * (cs + 2) * (ds + 2), sizeof(uint32_t));
+  if (FM == NULL)
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    freeimage(fimage);
+    if (finhibit != NULL) freeimage(finhibit);
+    return 0;
+  }
+  ret = lskelCK3map_nb(fimage, -1, finhibit, FM);
+  delframe(image, fimage);
+  for (z = 0; z < ds; z++)
+    for (y = 0; y < cs; y++)
+      for (x = 0; x < rs; x++)
+	M[(z * cs + y) * rs + x] = FM[((z + 1) * (cs + 2) + y + 1) * (rs + 2) + x + 1];
+  free(FM);
+  freeimage(fimage);
+  if (finhibit != NULL) freeimage(finhibit);
+  return ret;
+} /* lskelCK3map() */
+
+/* ==================================== */
+int32_t lskelCK3inc(struct xvimage *image, 
+		    struct xvimage *inhibit,
+		    struct xvimage *previous,
+		    struct xvimage *map,
+		    int32_t *dirty)
+/* ==================================== */
+/*
+  Re-squelettisation incrmentale (CK3, jusqu' stabilit).
+  image    : (entre) nouvelle image X1, (sortie) squelette CK3 de X1
+  inhibit  : image d'inhibition, la mme que pour le calcul prcdent, ou NULL
+  previous : image X0 dont map est la carte des tapes
+  map      : (entre) carte des tapes de X0 (lskelCK3map ou lskelCK3inc),
+             (sortie) carte des tapes de X1
+  dirty    : bote (xmin, ymin, zmin, xmax, ymax, zmax) contenant les points
+             o X0 et X1 diffrent, ou NULL pour la calculer
+
+  Notons S0_t et S1_t les ensembles obtenus aprs t tapes  partir de 
+  X0 et X1. S0_t se dduit de X0 et de map (points non retirs avant 
+  l'tape t+1). Si D_t est la bote englobant les points o S0_t et S1_t 
+  diffrent, S1_{t+1} et S0_{t+1} concident hors de W = D_t dilate de 
+  CK3_RAYON : seuls les points de W sont recalculs,  partir de S1_t 
+  sur E = W dilate de CK3_RAYON. Le calcul s'arrte ds que les deux 
+  suites concident, ou que S1 est stable. Si E dpasse la moiti de 
+  l'image, le calcul complet (lskelCK3map) est effectu.
+*/
+#undef F_NAME
+#define F_NAME "lskelCK3inc"
+{
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image);
+  int32_t ps = rs * cs, N = ps * ds;
+  uint8_t *X1 = UCHARDATA(image);
+  uint8_t *X0 = UCHARDATA(previous);
+  uint8_t *I = NULL;
+  uint32_t *M = ULONGDATA(map);
+  boite3d D, W, E, C, U, V;  /* differences, fenetre, lecture, etat courant, union */
+  uint8_t *cur = NULL, *ncur;        /* etat S1 sur C */
+  uint32_t *Mold = NULL, *nMold;     /* valeurs initiales de map sur U */
+  uint8_t *Sb = NULL, *Ib = NULL;    /* tampons sur E, entoures d'un cadre */
+  int32_t rsb, psb, Nb;
+  int32_t x, y, z, i, q, step, told, vide, retrait, avant, apres, ancien;
+  uint32_t m;
+
+  if (ds < 2)
+  {
+    fprintf(stderr, "%s: 3D image expected\n", F_NAME);
+    return 0;
+  }
+  if ((datatype(map) != VFF_TYP_4_BYTE) || (datatype(previous) != VFF_TYP_1_BYTE) ||
+      (rowsize(map) != rs) || (colsize(map) != cs) || (depth(map) != ds) ||
+      (rowsize(previous) != rs) || (colsize(previous) != cs) || (depth(previous) != ds) ||
+      ((inhibit != NULL) && 
+       ((rowsize(inhibit) != rs) || (colsize(inhibit) != cs) || (depth(inhibit) != ds))))
+  {
+    fprintf(stderr, "%s: incompatible image sizes or types\n", F_NAME);
+    return 0;
+  }
+  if (inhibit != NULL) I = UCHARDATA(inhibit);
+
+  // D_0 : boite des differences entre X0 et X1
+  if (dirty != NULL)
+  {
+    V.xmin = dirty[0]; V.ymin = dirty[1]; V.zmin = dirty[2];
+    V.xmax = dirty[3]; V.ymax = dirty[4]; V.zmax = dirty[5];
+    dilateboite(&V, &V, 0, rs, cs, ds);
+  }
+  else
+  {
+    V.xmin = V.ymin = V.zmin = 0;
+    V.xmax = rs - 1; V.ymax = cs - 1; V.zmax = ds - 1;
+  }
+  vide = 1;
+  for (z = V.zmin; z <= V.zmax; z++)
+    for (y = V.ymin; y <= V.ymax; y++)
+      for (x = V.xmin; x <= V.xmax; x++)
+      {
+	i = z * ps + y * rs + x;
+	if ((X0[i] != 0) != (X1[i] != 0)) etendboite(&D, &vide, x, y, z);
+      }
+
+  // derniere etape du calcul precedent
+  told = 0;
+  for (i = 0; i < N; i++) if (X0[i] && (M[i] > told)) told = M[i];
+
+#define ANCIEN(i,m,t) (X0[i] && (((m) == 0) || ((m) > (uint32_t)(t))))
+
+  if (!vide)
+  {
+    // etat courant : S1_0 = X1 sur C = D_0
+    C = D;
+    cur = (uint8_t *)malloc(BX(&C) * BY(&C) * BZ(&C));
+    if (cur == NULL) goto echec;
+    for (z = C.zmin; z <= C.zmax; z++)
+      for (y = C.ymin; y <= C.ymax; y++)
+	for (x = C.xmin; x <= C.xmax; x++)
+	  cur[INDBOITE(&C,x,y,z)] = X1[z * ps + y * rs + x] ? S_OBJECT : 0;
+    init_topo3d();
+  }
+
+  step = 0;
+  U.xmin = U.ymin = U.zmin = 0; // U vide tant que Mold est NULL
+  U.xmax = U.ymax = U.zmax = -1;
+  while (!vide)
+  {
+    step++;
+    dilateboite(&D, &W, CK3_RAYON, rs, cs, ds);
+    dilateboite(&W, &E, CK3_RAYON, rs, cs, ds);
+#ifdef VERBOSE
+    printf("%s: step %d, window %d x %d x %d\n", F_NAME, step, BX(&W), BY(&W), BZ(&W));
+#endif
+    if (BX(&E) * BY(&E) * BZ(&E) > N / 2) 
+    { // region non bornee : calcul complet
+      termine_topo3d();
+      free(cur); if (Mold) free(Mold);
+      return lskelCK3map(image, inhibit, map);
+    }
+
+    // U := U \cup W, en conservant les valeurs initiales de map sur U
+    if (Mold == NULL) V = W;
+    else
+    {
+      V.xmin = min(U.xmin, W.xmin); V.xmax = max(U.xmax, W.xmax);
+      V.ymin = min(U.ymin, W.ymin); V.ymax = max(U.ymax, W.ymax);
+      V.zmin = min(U.zmin, W.zmin); V.zmax = max(U.zmax, W.zmax);
+    }
+    if ((Mold == NULL) || (BX(&V) * BY(&V) * BZ(&V) != BX(&U) * BY(&U) * BZ(&U)))
+    {
+      nMold = (uint32_t *)malloc(BX(&V) * BY(&V) * BZ(&V) * sizeof(uint32_t));
+      if (nMold == NULL) goto echec;
+      for (z = V.zmin; z <= V.zmax; z++)
+	for (y = V.ymin; y <= V.ymax; y++)
+	  for (x = V.xmin; x <= V.xmax; x++)
+	    nMold[INDBOITE(&V,x,y,z)] = 
+	      ((Mold != NULL) && DANSBOITE(&U,x,y,z)) ? Mold[INDBOITE(&U,x,y,z)] : M[z * ps + y * rs + x];
+      if (Mold) free(Mold);
+      Mold = nMold; U = V;
+    }
+
+    // tampon : S1_{t-1} sur E, avec un cadre nul
+    rsb = BX(&E) + 2; psb = rsb * (BY(&E) + 2); Nb = psb * (BZ(&E) + 2);
+    Sb = (uint8_t *)calloc(Nb, 1);
+    if (I) Ib = (uint8_t *)calloc(Nb, 1);
+    if ((Sb == NULL) || (I && (Ib == NULL))) goto echec;
+    for (z = E.zmin; z <= E.zmax; z++)
+      for (y = E.ymin; y <= E.ymax; y++)
+	for (x = E.xmin; x <= E.xmax; x++)
+	{
+	  i = z * ps + y * rs + x;
+	  q = (z - E.zmin + 1) * psb + (y - E.ymin + 1) * rsb + (x - E.xmin + 1);
+	  if (DANSBOITE(&C,x,y,z)) Sb[q] = cur[INDBOITE(&C,x,y,z)];
+	  else 
+	  {
+	    m = DANSBOITE(&U,x,y,z) ? Mold[INDBOITE(&U,x,y,z)] : M[i];
+	    Sb[q] = ANCIEN(i, m, step - 1) ? S_OBJECT : 0;
+	  }
+	  if (I) Ib[q] = I[i];
+	}
+
+    // une etape de CK3 sur le tampon
+    marque_simples(Sb, Ib, NULL, 0, Nb, rsb, psb);
+    if (!marque_surfaces(Sb, rsb, psb, Nb)) goto echec;
+    marque_cruciaux(Sb, rsb, psb, Nb);
+    retire_simples(Sb, 0, Nb, NULL, 0);
+
+    // S1_t sur W, mise a jour de map, nouvelle boite des differences
+    ncur = (uint8_t *)malloc(BX(&W) * BY(&W) * BZ(&W));
+    if (ncur == NULL) goto echec;
+    vide = 1; retrait = 0;
+    for (z = W.zmin; z <= W.zmax; z++)
+      for (y = W.ymin; y <= W.ymax; y++)
+	for (x = W.xmin; x <= W.xmax; x++)
+	{
+	  i = z * ps + y * rs + x;
+	  q = (z - E.zmin + 1) * psb + (y - E.ymin + 1) * rsb + (x - E.xmin + 1);
+	  m = Mold[INDBOITE(&U,x,y,z)];
+	  if (DANSBOITE(&C,x,y,z)) avant = (cur[INDBOITE(&C,x,y,z)] != 0);
+	  else avant = ANCIEN(i, m, step - 1);
+	  apres = (Sb[q] != 0);
+	  ancien = ANCIEN(i, m, step);
+	  ncur[INDBOITE(&W,x,y,z)] = apres ? S_OBJECT : 0;
+	  if (avant && !apres) { M[i] = step; retrait = 1; }
+	  else if (apres) M[i] = ancien ? m : 0;
+	  if (apres != ancien) etendboite(&D, &vide, x, y, z);
+	}
+    free(Sb); Sb = NULL;
+    if (Ib) { free(Ib); Ib = NULL; }
+    free(cur); cur = ncur; C = W;
+
+    // S1 stable : hors de W, S1 suit S0, qui est stable apres told
+    if (!vide && !retrait && (step > told)) break;
+  }
+
+  if (cur != NULL)
+  {
+    free(cur);
+    termine_topo3d();
+  }
+  if (Mold) free(Mold);
+
+  for (i = 0; i < N; i++)
+  {
+    if (!X1[i]) M[i] = 0;
+    X1[i] = (X1[i] && (M[i] == 0)) ? 255 : 0;
+  }
+  return 1;
+
+ echec:
+  fprintf(stderr, "%s: malloc failed\n", F_NAME);
+  if (Sb) free(Sb);
+  if (Ib) free(Ib);
+  if (cur != NULL)
+  {
+    free(cur);
+    termine_topo3d();
+  }
+  if (Mold) free(Mold);
+  return 0;
+} /* lskelCK3inc() */
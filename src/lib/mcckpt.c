@@ -0,0 +1,221 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Librairie mcckpt :
+
+   points de reprise (checkpoints) pour les algorithmes iteratifs 
+
+   Un fichier de reprise contient l'etat d'un algorithme a la fin d'une
+   etape : le numero de l'etape et un ensemble d'images binaires (l'ensemble
+   courant S et, selon l'algorithme, l'image d'inhibition I ou d'autres 
+   images de travail). Chaque image est stockee sous forme compacte, un bit
+   par point.
+
+   Format :
+     CKPT <algo> <rs> <cs> <ds> <step> <nimg> <p_0 ... p_nimg-1>\n
+   suivi, pour chaque image presente (p_k = 1), de (rs*cs*ds+7)/8 octets :
+   le point i est code par le bit i%8 de l'octet i/8.
+
+   Le fichier est ecrit sous un nom temporaire puis renomme, de sorte 
+   qu'une interruption pendant l'ecriture laisse intacte la sauvegarde 
+   precedente.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mccodimage.h>
+#include <mcimage.h>
+#include <mcckpt.h>
+
+/* ==================================== */
+int32_t ckpt_write(char *filename, char *algo, int32_t step, int32_t nimg, struct xvimage **img)
+/* ==================================== */
+// retourne 1 si la sauvegarde a reussi, 0 sinon
+#undef F_NAME
+#define F_NAME "ckpt_write"
+{
+  FILE *fd;
+  char *tmpname;
+  uint8_t *buf, *F;
+  int32_t rs = 0, cs = 0, ds = 0, N, nb, i, k;
+
+  for (k = 0; k < nimg; k++)
+    if (img[k] != NULL) 
+    { 
+      rs = rowsize(img[k]); cs = colsize(img[k]); ds = depth(img[k]); 
+      break; 
+    }
+  N = rs * cs * ds;
+  nb = (N + 7) / 8;
+
+  tmpname = (char *)malloc(strlen(filename) + 5);
+  buf = (uint8_t *)malloc(nb);
+  if ((tmpname == NULL) || (buf == NULL))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    return 0;
+  }
+  sprintf(tmpname, "%s.tmp", filename);
+
+#ifdef UNIXIO
+  fd = fopen(tmpname,"w");
+#endif
+#ifdef DOSIO
+  fd = fopen(tmpname,"wb");
+#endif
+  if (!fd)
+  {
+    fprintf(stderr, "%s: cannot open file: %s\n", F_NAME, tmpname);
+    free(tmpname); free(buf);
+    return 0;
+  }
+
+  fprintf(fd, "CKPT %s %d %d %d %d %d", algo, rs, cs, ds, step, nimg);
+  for (k = 0; k < nimg; k++) fprintf(fd, " %d", img[k] != NULL);
+  fprintf(fd, "\n");
+
+  for (k = 0; k < nimg; k++)
+    if (img[k] != NULL)
+    {
+      F = UCHARDATA(img[k]);
+      memset(buf, 0, nb);
+      for (i = 0; i < N; i++) if (F[i]) buf[i >> 3] |= (uint8_t)(1 << (i & 7));
+      if (fwrite(buf, 1, nb, fd) != nb)
+      {
+	fprintf(stderr, "%s: write error: %s\n", F_NAME, tmpname);
+	fclose(fd); free(tmpname); free(buf);
+	return 0;
+      }
+    }
+
+  if (fclose(fd) != 0)
+  {
+    fprintf(stderr, "%s: write error: %s\n", F_NAME, tmpname);
+    free(tmpname); free(buf);
+    return 0;
+  }
+  if (rename(tmpname, filename) != 0)
+  {
+    fprintf(stderr, "%s: cannot rename %s to %s\n", F_NAME, tmpname, filename);
+    free(tmpname); free(buf);
+    return 0;
+  }
+  free(tmpname); free(buf);
+  return 1;
+} /* ckpt_write() */
+
+/* ==================================== */
+int32_t ckpt_read(char *filename, char *algo, int32_t *step, int32_t nimg, struct xvimage **img)
+/* ==================================== */
+/*
+  Relit une sauvegarde faite par ckpt_write pour l'algorithme algo. 
+  Les images img[k] non NULL, deja allouees, recoivent les valeurs 0 ou 1.
+  La sauvegarde doit correspondre a l'algorithme, a la taille des images 
+  et aux images presentes. Retourne 1 si la lecture a reussi, 0 sinon.
+*/
+#undef F_NAME
+#define F_NAME "ckpt_read"
+{
+  FILE *fd;
+  char falgo[64];
+  uint8_t *buf, *F;
+  int32_t rs, cs, ds, fnimg, p, N, nb, i, k;
+
+#ifdef UNIXIO
+  fd = fopen(filename,"r");
+#endif
+#ifdef DOSIO
+  fd = fopen(filename,"rb");
+#endif
+  if (!fd)
+  {
+    fprintf(stderr, "%s: file not found: %s\n", F_NAME, filename);
+    return 0;
+  }
+
+  if ((fscanf(fd, "CKPT %63s %d %d %d %d %d", falgo, &rs, &cs, &ds, step, &fnimg) != 6) ||
+      (strcmp(falgo, algo) != 0) || (fnimg != nimg))
+  {
+    fprintf(stderr, "%s: %s is not a checkpoint for %s\n", F_NAME, filename, algo);
+    fclose(fd);
+    return 0;
+  }
+  for (k = 0; k < nimg; k++)
+  {
+    if ((fscanf(fd, "%d", &p) != 1) || (p != (img[k] != NULL)) ||
+	((p != 0) && 
+	 ((rowsize(img[k]) != rs) || (colsize(img[k]) != cs) || (depth(img[k]) != ds))))
+    {
+      fprintf(stderr, "%s: %s does not match the current images\n", F_NAME, filename);
+      fclose(fd);
+      return 0;
+    }
+  }
+  if (fgetc(fd) != '\n')
+  {
+    fprintf(stderr, "%s: bad header: %s\n", F_NAME, filename);
+    fclose(fd);
+    return 0;
+  }
+
+  N = rs * cs * ds;
+  nb = (N + 7) / 8;
+  buf = (uint8_t *)malloc(nb);
+  if (buf == NULL)
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    fclose(fd);
+    return 0;
+  }
+  for (k = 0; k < nimg; k++)
+    if (img[k] != NULL)
+    {
+      if (fread(buf, 1, nb, fd) != nb)
+      {
+	fprintf(stderr, "%s: truncated file: %s\n", F_NAME, filename);
+	fclose(fd); free(buf);
+	return 0;
+      }
+      F = UCHARDATA(img[k]);
+      for (i = 0; i < N; i++) F[i] = (buf[i >> 3] >> (i & 7)) & 1;
+    }
+
+  fclose(fd);
+  free(buf);
+  return 1;
+} /* ckpt_read() */
@@ -45,7 +45,9 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mccodimage.h>
+#include <mcsimd.h>
 #include <mcutil.h>
 
 /*            
@@ -260,6 +262,38 @@ int32_t voisin26(int32_t i, int32_t k, int32_t rs, int32_t ps, int32_t N)
   }
 }
 
+/* ==================================== */
+void offsetvois26(int32_t rs, int32_t ps, int32_t *off)
+/* rs : taille d'une rangee */
+/* ps : taille d'un plan */
+/* off : tableau de 26 entiers (resultat) */
+/* ==================================== */
+/*
+  retourne dans off les decalages des 26 voisins, dans l'ordre de voisin26 :
+  pour un point i qui n'est pas un point de bord, voisin26(i, k, rs, ps, N)
+  vaut i + off[k]. Permet de parcourir le voisinage sans aucun test
+  (image bordee par addframe par exemple).
+*/
+{
+  int32_t k, dz;
+  for (k = 0; k < 26; k++)
+  {
+    if (k < 9) dz = ps; else if (k < 17) dz = 0; else dz = -ps;
+    switch((k < 9) ? k : ((k < 17) ? k - 9 : k - 17))
+    {
+    case 0: off[k] = dz + 1; break;
+    case 1: off[k] = dz + 1 - rs; break;
+    case 2: off[k] = dz - rs; break;
+    case 3: off[k] = dz - rs - 1; break;
+    case 4: off[k] = dz - 1; break;
+    case 5: off[k] = dz - 1 + rs; break;
+    case 6: off[k] = dz + rs; break;
+    case 7: off[k] = dz + rs + 1; break;
+    case 8: off[k] = dz; break;
+    }
+  }
+} /* offsetvois26() */
+
 /* ==================================== */
 int32_t voisin18(int32_t i, int32_t k, int32_t rs, int32_t ps, int32_t N)
 /* i : index du point dans l'image */
@@ -619,3 +653,199 @@ uint32_t maskvois26(uint8_t *F, uint32_t bitmask, int32_t i, int32_t rs, int32_t
   }
   return mask;
 }
+
+/* ==================================== */
+/* masques 27 bits du voisinage 3x3x3   */
+/* ==================================== */
+
+/*
+  Le bit x + 3y + 9z (x, y, z dans {0,1,2}) du masque d'un point i vaut 1 
+  ssi F[i + (x-1) + (y-1)*rs + (z-1)*ps] est non nul ; c'est la numerotation 
+  de cube_topo3d (mctopo3d), le bit 13 est le point i lui-meme.
+  Pour parcourir une rangee, on calcule d'abord (colonnes27) le code 9 bits 
+  de chaque colonne {x} x {y-1,y,y+1} x {z-1,z,z+1} ; le masque du point 
+  suivant s'obtient alors par un decalage et une lecture de table 
+  (MASK27_SUIVANT), au lieu de 27 lectures de l'image.
+*/
+
+/* etale27[c] : bit j de c place au bit 3j+2 (colonne x = 2 du masque) */
+const uint32_t etale27[512] = {
+  0x0000000, 0x0000004, 0x0000020, 0x0000024, 0x0000100, 0x0000104,
+  0x0000120, 0x0000124, 0x0000800, 0x0000804, 0x0000820, 0x0000824,
+  0x0000900, 0x0000904, 0x0000920, 0x0000924, 0x0004000, 0x0004004,
+  0x0004020, 0x0004024, 0x0004100, 0x0004104, 0x0004120, 0x0004124,
+  0x0004800, 0x0004804, 0x0004820, 0x0004824, 0x0004900, 0x0004904,
+  0x0004920, 0x0004924, 0x0020000, 0x0020004, 0x0020020, 0x0020024,
+  0x0020100, 0x0020104, 0x0020120, 0x0020124, 0x0020800, 0x0020804,
+  0x0020820, 0x0020824, 0x0020900, 0x0020904, 0x0020920, 0x0020924,
+  0x0024000, 0x0024004, 0x0024020, 0x0024024, 0x0024100, 0x0024104,
+  0x0024120, 0x0024124, 0x0024800, 0x0024804, 0x0024820, 0x0024824,
+  0x0024900, 0x0024904, 0x0024920, 0x0024924, 0x0100000, 0x0100004,
+  0x0100020, 0x0100024, 0x0100100, 0x0100104, 0x0100120, 0x0100124,
+  0x0100800, 0x0100804, 0x0100820, 0x0100824, 0x0100900, 0x0100904,
+  0x0100920, 0x0100924, 0x0104000, 0x0104004, 0x0104020, 0x0104024,
+  0x0104100, 0x0104104, 0x0104120, 0x0104124, 0x0104800, 0x0104804,
+  0x0104820, 0x0104824, 0x0104900, 0x0104904, 0x0104920, 0x0104924,
+  0x0120000, 0x0120004, 0x0120020, 0x0120024, 0x0120100, 0x0120104,
+  0x0120120, 0x0120124, 0x0120800, 0x0120804, 0x0120820, 0x0120824,
+  0x0120900, 0x0120904, 0x0120920, 0x0120924, 0x0124000, 0x0124004,
+  0x0124020, 0x0124024, 0x0124100, 0x0124104, 0x0124120, 0x0124124,
+  0x0124800, 0x0124804, 0x0124820, 0x0124824, 0x0124900, 0x0124904,
+  0x0124920, 0x0124924, 0x0800000, 0x0800004, 0x0800020, 0x0800024,
+  0x0800100, 0x0800104, 0x0800120, 0x0800124, 0x0800800, 0x0800804,
+  0x0800820, 0x0800824, 0x0800900, 0x0800904, 0x0800920, 0x0800924,
+  0x0804000, 0x0804004, 0x0804020, 0x0804024, 0x0804100, 0x0804104,
+  0x0804120, 0x0804124, 0x0804800, 0x0804804, 0x0804820, 0x0804824,
+  0x0804900, 0x0804904, 0x0804920, 0x0804924, 0x0820000, 0x0820004,
+  0x0820020, 0x0820024, 0x0820100, 0x0820104, 0x0820120, 0x0820124,
+  0x0820800, 0x0820804, 0x0820820, 0x0820824, 0x0820900, 0x0820904,
+  0x0820920, 0x0820924, 0x0824000, 0x0824004, 0x0824020, 0x0824024,
+  0x0824100, 0x0824104, 0x0824120, 0x0824124, 0x0824800, 0x0824804,
+  0x0824820, 0x0824824, 0x0824900, 0x0824904, 0x0824920, 0x0824924,
+  0x0900000, 0x0900004, 0x0900020, 0x0900024, 0x0900100, 0x0900104,
+  0x0900120, 0x0900124, 0x0900800, 0x0900804, 0x0900820, 0x0900824,
+  0x0900900, 0x0900904, 0x0900920, 0x0900924, 0x0904000, 0x0904004,
+  0x0904020, 0x0904024, 0x0904100, 0x0904104, 0x0904120, 0x0904124,
+  0x0904800, 0x0904804, 0x0904820, 0x0904824, 0x0904900, 0x0904904,
+  0x0904920, 0x0904924, 0x0920000, 0x0920004, 0x0920020, 0x0920024,
+  0x0920100, 0x0920104, 0x0920120, 0x0920124, 0x0920800, 0x0920804,
+  0x0920820, 0x0920824, 0x0920900, 0x0920904, 0x0920920, 0x0920924,
+  0x0924000, 0x0924004, 0x0924020, 0x0924024, 0x0924100, 0x0924104,
+  0x0924120, 0x0924124, 0x0924800, 0x0924804, 0x0924820, 0x0924824,
+  0x0924900, 0x0924904, 0x0924920, 0x0924924, 0x4000000, 0x4000004,
+  0x4000020, 0x4000024, 0x4000100, 0x4000104, 0x4000120, 0x4000124,
+  0x4000800, 0x4000804, 0x4000820, 0x4000824, 0x4000900, 0x4000904,
+  0x4000920, 0x4000924, 0x4004000, 0x4004004, 0x4004020, 0x4004024,
+  0x4004100, 0x4004104, 0x4004120, 0x4004124, 0x4004800, 0x4004804,
+  0x4004820, 0x4004824, 0x4004900, 0x4004904, 0x4004920, 0x4004924,
+  0x4020000, 0x4020004, 0x4020020, 0x4020024, 0x4020100, 0x4020104,
+  0x4020120, 0x4020124, 0x4020800, 0x4020804, 0x4020820, 0x4020824,
+  0x4020900, 0x4020904, 0x4020920, 0x4020924, 0x4024000, 0x4024004,
+  0x4024020, 0x4024024, 0x4024100, 0x4024104, 0x4024120, 0x4024124,
+  0x4024800, 0x4024804, 0x4024820, 0x4024824, 0x4024900, 0x4024904,
+  0x4024920, 0x4024924, 0x4100000, 0x4100004, 0x4100020, 0x4100024,
+  0x4100100, 0x4100104, 0x4100120, 0x4100124, 0x4100800, 0x4100804,
+  0x4100820, 0x4100824, 0x4100900, 0x4100904, 0x4100920, 0x4100924,
+  0x4104000, 0x4104004, 0x4104020, 0x4104024, 0x4104100, 0x4104104,
+  0x4104120, 0x4104124, 0x4104800, 0x4104804, 0x4104820, 0x4104824,
+  0x4104900, 0x4104904, 0x4104920, 0x4104924, 0x4120000, 0x4120004,
+  0x4120020, 0x4120024, 0x4120100, 0x4120104, 0x4120120, 0x4120124,
+  0x4120800, 0x4120804, 0x4120820, 0x4120824, 0x4120900, 0x4120904,
+  0x4120920, 0x4120924, 0x4124000, 0x4124004, 0x4124020, 0x4124024,
+  0x4124100, 0x4124104, 0x4124120, 0x4124124, 0x4124800, 0x4124804,
+  0x4124820, 0x4124824, 0x4124900, 0x4124904, 0x4124920, 0x4124924,
+  0x4800000, 0x4800004, 0x4800020, 0x4800024, 0x4800100, 0x4800104,
+  0x4800120, 0x4800124, 0x4800800, 0x4800804, 0x4800820, 0x4800824,
+  0x4800900, 0x4800904, 0x4800920, 0x4800924, 0x4804000, 0x4804004,
+  0x4804020, 0x4804024, 0x4804100, 0x4804104, 0x4804120, 0x4804124,
+  0x4804800, 0x4804804, 0x4804820, 0x4804824, 0x4804900, 0x4804904,
+  0x4804920, 0x4804924, 0x4820000, 0x4820004, 0x4820020, 0x4820024,
+  0x4820100, 0x4820104, 0x4820120, 0x4820124, 0x4820800, 0x4820804,
+  0x4820820, 0x4820824, 0x4820900, 0x4820904, 0x4820920, 0x4820924,
+  0x4824000, 0x4824004, 0x4824020, 0x4824024, 0x4824100, 0x4824104,
+  0x4824120, 0x4824124, 0x4824800, 0x4824804, 0x4824820, 0x4824824,
+  0x4824900, 0x4824904, 0x4824920, 0x4824924, 0x4900000, 0x4900004,
+  0x4900020, 0x4900024, 0x4900100, 0x4900104, 0x4900120, 0x4900124,
+  0x4900800, 0x4900804, 0x4900820, 0x4900824, 0x4900900, 0x4900904,
+  0x4900920, 0x4900924, 0x4904000, 0x4904004, 0x4904020, 0x4904024,
+  0x4904100, 0x4904104, 0x4904120, 0x4904124, 0x4904800, 0x4904804,
+  0x4904820, 0x4904824, 0x4904900, 0x4904904, 0x4904920, 0x4904924,
+  0x4920000, 0x4920004, 0x4920020, 0x4920024, 0x4920100, 0x4920104,
+  0x4920120, 0x4920124, 0x4920800, 0x4920804, 0x4920820, 0x4920824,
+  0x4920900, 0x4920904, 0x4920920, 0x4920924, 0x4924000, 0x4924004,
+  0x4924020, 0x4924024, 0x4924100, 0x4924104, 0x4924120, 0x4924124,
+  0x4924800, 0x4924804, 0x4924820, 0x4924824, 0x4924900, 0x4924904,
+  0x4924920, 0x4924924
+};
+
+/* ==================================== */
+uint32_t mask27(uint8_t *F, int32_t i, int32_t rs, int32_t ps)
+/* ==================================== */
+// masque 27 bits du point i, qui ne doit pas etre un point de bord
+{
+  uint32_t m = 0;
+  int32_t x, y, z, n = 0;
+  for (z = -ps; z <= ps; z += ps)
+    for (y = -rs; y <= rs; y += rs)
+      for (x = -1; x <= 1; x++, n++)
+        if (F[i + z + y + x]) m |= (1 << n);
+  return m;
+} /* mask27() */
+
+/* ==================================== */
+void colonnes27(uint8_t *F, int32_t i, int32_t n, int32_t rs, int32_t ps, uint16_t *C)
+/* ==================================== */
+/*
+  Codes des colonnes des points i-1 a i+n : C[k] (0 <= k <= n+1) a son bit 
+  (y+1) + 3(z+1) a 1 ssi F[i-1+k + y*rs + z*ps] est non nul (y, z dans 
+  {-1,0,1}). Le masque du point i+k s'obtient par :
+    m = 0; m = MASK27_SUIVANT(m, C[0]); m = MASK27_SUIVANT(m, C[1]);
+    puis pour k = 0, 1, ... : m = MASK27_SUIVANT(m, C[k+2]);
+  Les 9 rangees sont lues 8 octets a la fois ; aucun des points i a i+n-1 
+  ne doit etre un point de bord.
+*/
+{
+  uint8_t *R[9];
+  uint64_t a, b, w;
+  int32_t r, k, l, nc = n + 2;
+  const uint64_t m0f = 0x0f0f0f0f0f0f0f0fULL, m03 = 0x0303030303030303ULL, m01 = 0x0101010101010101ULL;
+
+  for (r = 0; r < 9; r++) R[r] = F + i - 1 + ((r % 3) - 1) * rs + ((r / 3) - 1) * ps;
+  for (k = 0; k + 8 <= nc; k += 8)
+  {
+    a = b = 0;
+    for (r = 0; r < 9; r++)
+    {
+      memcpy(&w, R[r] + k, 8);
+      // chaque octet non nul de w devient 1
+      w = (w & m0f) | ((w >> 4) & m0f);
+      w = (w | (w >> 2)) & m03;
+      w = (w | (w >> 1)) & m01;
+      if (r < 8) a |= w << r; else b = w;
+    }
+    for (l = 0; l < 8; l++) 
+      C[k + l] = (uint16_t)(((a >> (8 * l)) & 0xff) | (((b >> (8 * l)) & 1) << 8));
+  }
+  for (; k < nc; k++)
+    for (C[k] = 0, r = 0; r < 9; r++)
+      if (R[r][k]) C[k] |= (1 << r);
+} /* colonnes27() */
+
+/* ==================================== */
+uint64_t lignes27(uint8_t *F, int32_t i, int32_t n, int32_t rs, int32_t ps, uint64_t *L)
+/* ==================================== */
+/*
+  Traitement par lots des points i a i+n-1 d'une rangee (n <= LIGNES27_MAX).
+  Retourne les points non nuls (bit k : point i+k) ; s'il y en a, L[r] 
+  (r = (y+1) + 3(z+1)) a son bit k a 1 ssi F[i-1+k + y*rs + z*ps] est non 
+  nul (0 <= k <= n+1). Le masque du point i+k est alors MASK27_LIGNES(L, k), 
+  et le bit k de INTERIEURS27(L) indique si ses 6 voisins sont non nuls : 
+  les points a examiner s'enumerent par RANG64 sur des mots de 64 bits, 
+  sans parcourir les colonnes vides. Chaque rangee est comparee a zero par 
+  mc_non_nuls64 (voir mcsimd). Aucun des points i a i+n-1 ne doit etre un 
+  point de bord.
+*/
+{
+  int32_t r;
+  uint64_t o = mc_non_nuls64(F + i, n);
+
+  if (o == 0) return 0;
+  for (r = 0; r < 9; r++)
+    if (r == 4)
+      L[r] = (o << 1) | (F[i - 1] != 0) | ((uint64_t)(F[i + n] != 0) << (n + 1));
+    else
+      L[r] = mc_non_nuls64(F + i - 1 + ((r % 3) - 1) * rs + ((r / 3) - 1) * ps, n + 2);
+  return o;
+} /* lignes27() */
+
+#ifndef __GNUC__
+/* ==================================== */
+int32_t rang64(uint64_t o)
+/* ==================================== */
+// rang du bit de poids faible de o (non nul)
+{
+  int32_t k = 0;
+  while (!((o >> k) & 1)) k++;
+  return k;
+} /* rang64() */
+#endif
@@ -0,0 +1,336 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Librairie mcdist :
+
+   transformees de distance binaires exactes, en temps lineaire
+
+   dist_quad : carre de la distance euclidienne de chaque point objet au
+   point nul le plus proche (algorithme de Meijster, Roerdink et 
+   Hesselink). La distance est d'abord calculee selon x, ligne par ligne,
+   puis chaque colonne (axe y) et chaque pile (axe z) est traitee par le 
+   calcul de l'enveloppe inferieure d'une famille de paraboles. Les lignes,
+   colonnes et piles sont reparties entre les threads (OpenMP).
+
+   dist_bloc : distance d4 (2D) ou d6 (3D), selon le meme schema separable
+   (un balayage aller et un balayage retour selon chaque axe).
+
+   Les points hors de l'image sont consideres comme nuls (comme dans 
+   mcmorpho), sauf selon z pour une image 2D (ds = 1). Ainsi un point i
+   appartient a l'erode de F par k iterations de gamma 4 (ou 6) ssi 
+   dist_bloc(F)[i] > k.
+
+   dist_axemedian : points objet dont la boule euclidienne (de rayon la 
+   distance) n'est incluse dans la boule d'aucun des 8 (2D) ou 26 (3D) 
+   voisins. C'est un sur-ensemble de l'axe median euclidien discret ; le 
+   test est fait en arithmetique entiere, sans erreur d'arrondi.
+
+   dist_axebloc : maxima locaux (au sens large) de la distance d4 ou d6,
+   c'est-a-dire les centres des boules maximales pour cette distance
+   (l'ensemble K des algorithmes AK2 et AK3).
+
+   Reference:
+   A. Meijster, J.B.T.M. Roerdink and W.H. Hesselink,
+   "A general algorithm for computing distance transforms in linear time",
+   Mathematical Morphology and its Applications to Image and Signal 
+   Processing, pp. 331-340, 2000.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mccodimage.h>
+#include <mcdist.h>
+
+#define QUAD(u,i,f) ((int64_t)((u)-(i))*((u)-(i)) + (f)[i])
+
+/* ==================================== */
+static void dist_lignes(uint8_t *F, int32_t *D, int32_t rs, int32_t nl)
+/* ==================================== */
+// distance selon x au point nul le plus proche, pour nl lignes de rs points
+{
+  int32_t y, x, g;
+  uint8_t *f;
+  int32_t *d;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(x, g, f, d)
+#endif
+  for (y = 0; y < nl; y++)
+  {
+    f = F + (size_t)y * rs; d = D + (size_t)y * rs;
+    g = 0;
+    for (x = 0; x < rs; x++) { if (f[x]) g++; else g = 0; d[x] = g; }
+    g = 0;
+    for (x = rs - 1; x >= 0; x--) { if (f[x]) g++; else g = 0; if (g < d[x]) d[x] = g; }
+  }
+} /* dist_lignes() */
+
+/* ==================================== */
+static int64_t separe(int64_t i, int64_t u, int64_t fi, int64_t fu)
+/* ==================================== */
+// plus grand x tel que la parabole de sommet i soit sous celle de sommet u (i < u)
+{
+  int64_t a = u*u - i*i + fu - fi, b = 2 * (u - i);
+  if (a >= 0) return a / b;
+  return -((-a + b - 1) / b);
+} /* separe() */
+
+/* ==================================== */
+static void enveloppe(int32_t *D, int32_t n, int32_t pas, int64_t *f, int32_t *s, int32_t *t)
+/* ==================================== */
+/*
+  D[u*pas] := min_v { (u-v)^2 + D[v*pas] }, pour 0 <= u < n, avec deux
+  points nuls fictifs en -1 et n (decales de 1 dans f, s et t).
+  f, s, t : tampons de n+2 elements.
+*/
+{
+  int32_t u, q, m = n + 2;
+  int64_t w;
+
+  f[0] = f[m-1] = 0;
+  for (u = 1; u <= n; u++) f[u] = D[(size_t)(u-1) * pas];
+  q = 0; s[0] = 0; t[0] = 0;
+  for (u = 1; u < m; u++)
+  {
+    while ((q >= 0) && (QUAD(t[q], s[q], f) > QUAD(t[q], u, f))) q--;
+    if (q < 0) { q = 0; s[0] = u; }
+    else
+    {
+      w = 1 + separe(s[q], u, f[s[q]], f[u]);
+      if (w < m) { q++; s[q] = u; t[q] = (int32_t)w; }
+    }
+  }
+  for (u = m - 1; u >= 0; u--)
+  {
+    if ((u >= 1) && (u <= n)) D[(size_t)(u-1) * pas] = (int32_t)QUAD(u, s[q], f);
+    if (u == t[q]) q--;
+  }
+} /* enveloppe() */
+
+/* ==================================== */
+static void balaye(int32_t *D, int32_t n, int32_t pas)
+/* ==================================== */
+// D[u*pas] := min_v { |u-v| + D[v*pas] }, avec deux points nuls fictifs en -1 et n
+{
+  int32_t u, g;
+  size_t p;
+
+  g = 0;
+  for (u = 0, p = 0; u < n; u++, p += pas) { g++; if (D[p] < g) g = D[p]; else D[p] = g; }
+  g = 0;
+  for (u = n - 1, p = (size_t)(n-1) * pas; u >= 0; u--, p -= pas) { g++; if (D[p] < g) g = D[p]; else D[p] = g; }
+} /* balaye() */
+
+/* ==================================== */
+static int32_t dist_piles(int32_t *D, int32_t rs, int32_t cs, int32_t ds, int32_t axe, int32_t quad)
+/* ==================================== */
+// traite toutes les colonnes (axe = 1) ou toutes les piles (axe = 2) de D ;
+// retourne 0 si un tampon ne peut etre alloue (D est alors incomplet)
+{
+  int32_t ps = rs * cs, n, pas, np, j, ok = 1;
+  int64_t *f;
+  int32_t *s, *t, *d;
+
+  if (axe == 1) { n = cs; pas = rs; np = rs * ds; }
+  else          { n = ds; pas = ps; np = ps; }
+#ifdef _OPENMP
+#pragma omp parallel private(f, s, t, d, j) reduction(&&:ok)
+#endif
+  {
+    f = (int64_t *)malloc((n + 2) * sizeof(int64_t));
+    s = (int32_t *)malloc((n + 2) * sizeof(int32_t));
+    t = (int32_t *)malloc((n + 2) * sizeof(int32_t));
+    if (!f || !s || !t) ok = 0;
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (j = 0; j < np; j++)
+    {
+      if (!ok) continue;
+      if (axe == 1) d = D + (size_t)(j / rs) * ps + (j % rs); else d = D + j;
+      if (quad) enveloppe(d, n, pas, f, s, t); else balaye(d, n, pas);
+    }
+    free(f); free(s); free(t);
+  }
+  return ok;
+} /* dist_piles() */
+
+/* ==================================== */
+int32_t dist_quad(uint8_t *F, int32_t *D, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  size_t i, N = (size_t)rs * cs * ds;
+
+  dist_lignes(F, D, rs, cs * ds);
+  for (i = 0; i < N; i++) D[i] = D[i] * D[i];
+  if (!dist_piles(D, rs, cs, ds, 1, 1)) return 0;
+  if ((ds > 1) && !dist_piles(D, rs, cs, ds, 2, 1)) return 0;
+  return 1;
+} /* dist_quad() */
+
+/* ==================================== */
+int32_t dist_bloc(uint8_t *F, int32_t *D, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  dist_lignes(F, D, rs, cs * ds);
+  if (!dist_piles(D, rs, cs, ds, 1, 0)) return 0;
+  if ((ds > 1) && !dist_piles(D, rs, cs, ds, 2, 0)) return 0;
+  return 1;
+} /* dist_bloc() */
+
+/* ==================================== */
+void dist_axemedian(int32_t *D, uint8_t *M, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+/*
+  M[i] := 1 si D[i] > 0 et si, pour tout voisin j (8 ou 26) de vecteur v,
+  sqrt(D[j]) < sqrt(D[i]) + |v| ; M[i] := 0 sinon.
+  L'inegalite contraire equivaut a : l = D[j] - D[i] - |v|^2 >= 0 et
+  l^2 >= 4 |v|^2 D[i].
+*/
+{
+  int32_t ps = rs * cs, N = ps * ds, i, j, x, y, z, dx, dy, dz, n;
+  int32_t zmin = (ds > 1) ? -1 : 0, zmax = (ds > 1) ? 1 : 0;
+  int64_t di, l;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(j, x, y, z, dx, dy, dz, n, di, l)
+#endif
+  for (i = 0; i < N; i++)
+  {
+    M[i] = 0;
+    if (D[i] == 0) continue;
+    x = i % rs; y = (i % ps) / rs; z = i / ps; di = D[i];
+    for (dz = zmin; dz <= zmax; dz++)
+    for (dy = -1; dy <= 1; dy++)
+    for (dx = -1; dx <= 1; dx++)
+    {
+      if ((x+dx < 0) || (x+dx >= rs) || (y+dy < 0) || (y+dy >= cs) || (z+dz < 0) || (z+dz >= ds))
+        continue;
+      n = dx*dx + dy*dy + dz*dz;
+      if (n == 0) continue;
+      j = i + dz*ps + dy*rs + dx;
+      l = (int64_t)D[j] - di - n;
+      if ((l >= 0) && (l * l >= 4 * n * di)) goto incluse;
+    }
+    M[i] = 1;
+  incluse: ;
+  }
+} /* dist_axemedian() */
+
+/* ==================================== */
+void dist_axebloc(int32_t *D, uint8_t *M, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+// M[i] := 1 si D[i] > 0 et si aucun 4-voisin (2D) ou 6-voisin (3D) j n'a D[j] > D[i]
+{
+  int32_t ps = rs * cs, N = ps * ds, i, x, y, z, d;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(x, y, z, d)
+#endif
+  for (i = 0; i < N; i++)
+  {
+    d = D[i];
+    x = i % rs; y = (i % ps) / rs; z = i / ps;
+    M[i] = (d > 0) &&
+      ((x == 0) || (D[i-1] <= d)) && ((x == rs-1) || (D[i+1] <= d)) &&
+      ((y == 0) || (D[i-rs] <= d)) && ((y == cs-1) || (D[i+rs] <= d)) &&
+      ((z == 0) || (D[i-ps] <= d)) && ((z == ds-1) || (D[i+ps] <= d));
+  }
+} /* dist_axebloc() */
+
+/* ==================================== */
+int32_t ldistquad(struct xvimage *image, struct xvimage *result)
+/* ==================================== */
+// result (entiers 4 octets) := carre de la distance euclidienne au fond de image
+#undef F_NAME
+#define F_NAME "ldistquad"
+{
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image);
+
+  if ((datatype(image) != VFF_TYP_1_BYTE) || (datatype(result) != VFF_TYP_4_BYTE))
+  {
+    fprintf(stderr, "%s: bad image types\n", F_NAME);
+    return 0;
+  }
+  if ((rowsize(result) != rs) || (colsize(result) != cs) || (depth(result) != ds))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  if (!dist_quad(UCHARDATA(image), (int32_t *)ULONGDATA(result), rs, cs, ds))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    return 0;
+  }
+  return 1;
+} /* ldistquad() */
+
+/* ==================================== */
+int32_t lmedialaxis(struct xvimage *image, struct xvimage *result)
+/* ==================================== */
+// result (octets, 0/255) := axe median euclidien de image (cf. dist_axemedian) ; result peut etre image
+#undef F_NAME
+#define F_NAME "lmedialaxis"
+{
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image);
+  int32_t i, N = rs * cs * ds;
+  uint8_t *M = UCHARDATA(result);
+  int32_t *D;
+
+  if ((datatype(image) != VFF_TYP_1_BYTE) || (datatype(result) != VFF_TYP_1_BYTE))
+  {
+    fprintf(stderr, "%s: bad image types\n", F_NAME);
+    return 0;
+  }
+  if ((rowsize(result) != rs) || (colsize(result) != cs) || (depth(result) != ds))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  D = (int32_t *)malloc((size_t)N * sizeof(int32_t));
+  if ((D == NULL) || !dist_quad(UCHARDATA(image), D, rs, cs, ds))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    if (D) free(D);
+    return 0;
+  }
+  dist_axemedian(D, M, rs, cs, ds);
+  for (i = 0; i < N; i++) if (M[i]) M[i] = 255;
+  free(D);
+  return 1;
+} /* lmedialaxis() */
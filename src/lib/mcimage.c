@@ -54,6 +54,9 @@ knowledge of the CeCILL license and that you accept its terms.
    Update janvier 2006 : adoption des nouveaux "magic numbers" pour
                          les formats byte 3d, idem 2d (P2 et P5)
 			 P7 (raw 3d) est conserv pour la compatibilit
+   Update 2026 : donnes alignes, grandes images en pages de 2 Mo (mmap),
+                 rserve d'images de travail (allocscratch, freescratch)
+   Update 2026 : listes de points (PC et PD, writelistimage, readlistimage)
 */
 
 #include <stdio.h>
@@ -61,17 +64,102 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <sys/types.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include <ctype.h>
+#ifdef UNIXIO
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 #include <mcutil.h>
 #include <mcimage.h>
 #include <mccodimage.h>
+#include <mcsimd.h>
 
 #define BUFFERSIZE 10000
 
+#define ALIGNEMENT 64            /* alignement des donnes (ligne de cache) */
+#define SEUIL_MMAP (1 << 22)     /* taille (octets)  partir de laquelle les donnes sont projetes (mmap) */
+#define TAILLE_HUGE (1 << 21)    /* taille d'une grande page */
+#define BLOC_PAR (1 << 20)       /* taille des blocs copis par chaque thread */
+#define NSCRATCH 8               /* nombre d'images de la rserve */
+
 /*
 #define VERBOSE
 */
 
+/* ==================================== */
+static void copiepar(uint8_t *dst, uint8_t *src, size_t n)
+/* ==================================== */
+// copie n octets de src dans dst (mise  zro si src est NULL), par blocs 
+// rpartis statiquement entre les threads : les pages d'une image neuve 
+// sont ainsi touches en premier (et places, sur une machine NUMA) par les
+// threads qui traitent ensuite les mmes plans.
+{
+  int64_t k, nb = (n + BLOC_PAR - 1) / BLOC_PAR;
+  size_t l;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(l) if (nb > 1)
+#endif
+  for (k = 0; k < nb; k++)
+  {
+    l = n - k * (size_t)BLOC_PAR; if (l > BLOC_PAR) l = BLOC_PAR;
+    if (src) memcpy(dst + k * (size_t)BLOC_PAR, src + k * (size_t)BLOC_PAR, l);
+    else memset(dst + k * (size_t)BLOC_PAR, 0, l);
+  }
+} /* copiepar() */
+
+/* ==================================== */
+static struct xvimage *allocbloc(size_t taille, int32_t raz)
+/* ==================================== */
+/*
+  Alloue un en-tte d'image suivi de taille octets de donnes (nuls si raz 
+  vaut 1) et retourne l'en-tte, ou NULL. Les donnes (imagedata) sont 
+  alignes sur ALIGNEMENT octets. Au-del de SEUIL_MMAP octets, elles sont 
+  projetes en mmoire (mmap, pages nulles non encore touches) et alignes
+  sur une grande page, avec le conseil MADV_HUGEPAGE ; si la variable 
+  d'environnement MC_HUGETLB est dfinie, des grandes pages rserves 
+  (MAP_HUGETLB) sont demandes d'abord. Le bloc est libr par freeimage.
+*/
+{
+  size_t entete = offsetof(struct xvimage, imagedata);
+  size_t pad, total;
+  uint8_t *b;
+  struct xvimage *g;
+#ifdef UNIXIO
+  if (taille >= SEUIL_MMAP)
+  {
+    total = ((entete + taille + TAILLE_HUGE - 1) / TAILLE_HUGE + 1) * (size_t)TAILLE_HUGE;
+    b = (uint8_t *)MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (getenv("MC_HUGETLB") != NULL)
+      b = (uint8_t *)mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (b == (uint8_t *)MAP_FAILED)
+      b = (uint8_t *)mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (b != (uint8_t *)MAP_FAILED)
+    {
+      pad = TAILLE_HUGE - ((uintptr_t)(b + entete) % TAILLE_HUGE);
+      if (pad == TAILLE_HUGE) pad = 0;
+#ifdef MADV_HUGEPAGE
+      madvise(b + entete + pad, total - entete - pad, MADV_HUGEPAGE);
+#endif
+      g = (struct xvimage *)(b + pad);
+      g->bloc = b;
+      g->taillebloc = total;
+      return g;
+    }
+  }
+#endif
+  pad = (ALIGNEMENT - entete % ALIGNEMENT) % ALIGNEMENT;
+  if (posix_memalign((void **)&b, ALIGNEMENT, pad + entete + taille) != 0) return NULL;
+  if (raz) memset(b, 0, pad + entete + taille);
+  else memset(b, 0, pad + entete);
+  g = (struct xvimage *)(b + pad);
+  g->bloc = b;
+  g->taillebloc = 0;
+  return g;
+} /* allocbloc() */
+
 /* ==================================== */
 struct xvimage *allocimage(
   char * name,
@@ -101,9 +189,9 @@ struct xvimage *allocimage(
              return NULL;
   } /* switch (t) */
 
-  g = (struct xvimage *)calloc(1,sizeof(struct xvimage) - 1 + (N * ts));
+  g = allocbloc((size_t)N * ts, 1);
   if (g == NULL)
-  {   fprintf(stderr,"%s() : malloc failed (%d bytes)\n", F_NAME, sizeof(struct xvimage) - 1 + (N * ts));
+  {   fprintf(stderr,"%s() : malloc failed (%lld bytes)\n", F_NAME, (long long)N * ts);
       return NULL;
   }
   if (name != NULL)
@@ -153,7 +241,7 @@ void razimage(struct xvimage *f)
     default: fprintf(stderr,"%s() : bad data type %d\n", F_NAME, datatype(f));
              return;
   } /* switch (t) */
-  memset(F, 0, N*ts);
+  copiepar(F, NULL, (size_t)N * ts);
 } /* razimage() */
 
 /* ==================================== */
@@ -174,6 +262,7 @@ struct xvimage *allocheader(
   {   fprintf(stderr,"%s() : malloc failed\n", F_NAME);
       return NULL;
   }
+  g->bloc = g;
   if (name != NULL)
   {
     g->name = (char *)calloc(1,strlen(name)+1);
@@ -239,6 +328,8 @@ int32_t showheader(char * name)
     case '9': printf("type : P%c (raw float - ext. MC)\n", buffer[1]); break;
     case 'A': printf("type : P%c (ascii float - ext. LN)\n", buffer[1]); break;
     case 'B': printf("type : P%c (ascii int32_t - ext. MC)\n", buffer[1]); break;
+    case 'C': printf("type : P%c (ascii point list - ext. MC)\n", buffer[1]); break;
+    case 'D': printf("type : P%c (raw point list - ext. MC)\n", buffer[1]); break;
               break;
     default:
       fprintf(stderr,"%s : invalid image format : P%c\n", F_NAME, buffer[1]);
@@ -274,7 +365,14 @@ int32_t showheader(char * name)
 void freeimage(struct xvimage *image)
 /* ==================================== */
 {
-  free(image);
+#ifdef UNIXIO
+  if (image->taillebloc)
+  {
+    munmap(image->bloc, image->taillebloc);
+    return;
+  }
+#endif
+  free(image->bloc);
 }
 
 /* ==================================== */
@@ -287,51 +385,34 @@ struct xvimage *copyimage(struct xvimage *f)
   int32_t cs = colsize(f);         /* taille colonne */
   int32_t d = depth(f);            /* nb plans */
   int32_t N = rs * cs * d;         /* taille image */
+  int32_t ts;                      /* type size */
   struct xvimage *g;
 
   switch(datatype(f))
   {
-    case VFF_TYP_1_BYTE:
-      g = (struct xvimage *)calloc(1,sizeof(struct xvimage) - 1 + (N*sizeof(char)));
-      if (g == NULL)
-      {
-        fprintf(stderr,"%s() : malloc failed (%d bytes)\n", F_NAME, sizeof(struct xvimage) - 1 + (N*sizeof(char)));
-        return NULL;
-      }
-      memcpy((void *)g, (void *)f, sizeof(struct xvimage) - 1 + (N*sizeof(char)));
-      break;
-    case VFF_TYP_4_BYTE:
-      g = (struct xvimage *)calloc(1,sizeof(struct xvimage) - 1 + (N*sizeof(int32_t)));
-      if (g == NULL)
-      {
-        fprintf(stderr,"%s() : malloc failed (%d bytes)\n", F_NAME, sizeof(struct xvimage) - 1 + (N*sizeof(int32_t)));
-        return NULL;
-      }
-      memcpy((void *)g, (void *)f, sizeof(struct xvimage) - 1 + (N*sizeof(int32_t)));
-      break;
-    case VFF_TYP_FLOAT:
-      g = (struct xvimage *)calloc(1,sizeof(struct xvimage) - 1 + (N*sizeof(float)));
-      if (g == NULL)
-      {
-        fprintf(stderr,"%s() : malloc failed (%d bytes)\n", F_NAME, sizeof(struct xvimage) - 1 + (N*sizeof(float)));
-        return NULL;
-      }
-      memcpy((void *)g, (void *)f, sizeof(struct xvimage) - 1 + (N*sizeof(float)));
-      break;
-    case VFF_TYP_DOUBLE:
-      g = (struct xvimage *)calloc(1,sizeof(struct xvimage) - 1 + (N*sizeof(double)));
-      if (g == NULL)
-      {
-        fprintf(stderr,"%s() : malloc failed (%d bytes)\n", F_NAME, sizeof(struct xvimage) - 1 + (N*sizeof(double)));
-        return NULL;
-      }
-      memcpy((void *)g, (void *)f, sizeof(struct xvimage) - 1 + (N*sizeof(double)));
-      break;
+    case VFF_TYP_1_BYTE: ts = sizeof(char); break;
+    case VFF_TYP_4_BYTE: ts = sizeof(int32_t); break;
+    case VFF_TYP_FLOAT:  ts = sizeof(float); break;
+    case VFF_TYP_DOUBLE: ts = sizeof(double); break;
     default:
       fprintf(stderr,"%s() : bad data type %d\n", F_NAME, datatype(f));
       return NULL;
   } /* switch(f->datatype) */
 
+  g = allocbloc((size_t)N * ts, 0);
+  if (g == NULL)
+  {
+    fprintf(stderr,"%s() : malloc failed (%lld bytes)\n", F_NAME, (long long)N * ts);
+    return NULL;
+  }
+  g->name = NULL;
+  rowsize(g) = rs;
+  colsize(g) = cs;
+  depth(g) = d;
+  datatype(g) = datatype(f);
+  g->xdim = f->xdim; g->ydim = f->ydim; g->zdim = f->zdim;
+  copiepar(UCHARDATA(g), UCHARDATA(f), (size_t)N * ts);
+
   if (f->name != NULL)
   {
     g->name = (char *)calloc(1,strlen(f->name) + 1);
@@ -344,6 +425,139 @@ struct xvimage *copyimage(struct xvimage *f)
   return g;
 } // copyimage()
 
+/* ==================================== */
+/* rserve d'images de travail          */
+/* ==================================== */
+
+/*
+  Les fonctions d'amincissement allouent  chaque appel des images de 
+  travail de la taille de l'image traite, ce qui cote cher pour les grands
+  volumes (fautes de page  chaque nouvelle allocation) et quand elles sont 
+  appeles de nombreuses fois (plans d'une pile, algorithmes multiples). Une 
+  image rendue par freescratch est garde dans une rserve de NSCRATCH 
+  images, et resservie par allocscratch ou copyscratch pour une demande de 
+  mme taille en octets. purgescratch libre la rserve.
+*/
+
+static struct xvimage *scratch[NSCRATCH];
+
+/* ==================================== */
+static int32_t taillescratch(int32_t t)
+/* ==================================== */
+// taille d'un pixel pour les types admis dans la rserve (ceux de copyimage), 0 sinon
+{
+  switch(t)
+  {
+    case VFF_TYP_1_BYTE: return sizeof(char);
+    case VFF_TYP_4_BYTE: return sizeof(int32_t);
+    case VFF_TYP_FLOAT:  return sizeof(float);
+    case VFF_TYP_DOUBLE: return sizeof(double);
+    default:             return 0;
+  }
+} /* taillescratch() */
+
+/* ==================================== */
+static struct xvimage *prendscratch(int32_t rs, int32_t cs, int32_t d, int32_t t)
+/* ==================================== */
+// retire de la rserve une image de mme taille en octets (contenu quelconque),
+// ou retourne NULL
+{
+  struct xvimage *g = NULL, *h;
+  int32_t k;
+  int64_t n = (int64_t)rs * cs * d * taillescratch(t);
+
+  if (n == 0) return NULL;
+#ifdef _OPENMP
+#pragma omp critical (mcimage_scratch)
+#endif
+  for (k = 0; k < NSCRATCH; k++)
+  {
+    h = scratch[k];
+    if ((h != NULL) && ((int64_t)rowsize(h) * colsize(h) * depth(h) * taillescratch(datatype(h)) == n))
+    {
+      g = h;
+      scratch[k] = NULL;
+      break;
+    }
+  }
+  if (g != NULL)
+  {
+    rowsize(g) = rs;
+    colsize(g) = cs;
+    depth(g) = d;
+    datatype(g) = t;
+    g->xdim = g->ydim = g->zdim = 0.0;
+  }
+  return g;
+} /* prendscratch() */
+
+/* ==================================== */
+struct xvimage *allocscratch(int32_t rs, int32_t cs, int32_t d, int32_t t)
+/* ==================================== */
+// comme allocimage (sans nom), en prenant si possible une image de la rserve
+{
+  struct xvimage *g = prendscratch(rs, cs, d, t);
+  if (g == NULL) return allocimage(NULL, rs, cs, d, t);
+  razimage(g);
+  return g;
+} /* allocscratch() */
+
+/* ==================================== */
+struct xvimage *copyscratch(struct xvimage *f)
+/* ==================================== */
+// comme copyimage (sans le nom), en prenant si possible une image de la rserve
+{
+  int32_t ts = taillescratch(datatype(f));
+  struct xvimage *g = prendscratch(rowsize(f), colsize(f), depth(f), datatype(f));
+  if (g == NULL)
+  {
+    g = copyimage(f);
+    if ((g != NULL) && (g->name != NULL)) { free(g->name); g->name = NULL; }
+    return g;
+  }
+  g->xdim = f->xdim; g->ydim = f->ydim; g->zdim = f->zdim;
+  copiepar(UCHARDATA(g), UCHARDATA(f), (size_t)rowsize(f) * colsize(f) * depth(f) * ts);
+  return g;
+} /* copyscratch() */
+
+/* ==================================== */
+void freescratch(struct xvimage *image)
+/* ==================================== */
+// rend  la rserve une image obtenue par allocscratch ou copyscratch ; 
+// si la rserve est pleine, l'image est libre
+{
+  int32_t k;
+  if (image == NULL) return;
+  if (taillescratch(datatype(image)) == 0) { freeimage(image); return; }
+#ifdef _OPENMP
+#pragma omp critical (mcimage_scratch)
+#endif
+  for (k = 0; k < NSCRATCH; k++)
+    if (scratch[k] == NULL) 
+    {
+      scratch[k] = image;
+      image = NULL;
+      break;
+    }
+  if (image != NULL) freeimage(image);
+} /* freescratch() */
+
+/* ==================================== */
+void purgescratch()
+/* ==================================== */
+{
+  int32_t k;
+#ifdef _OPENMP
+#pragma omp critical (mcimage_scratch)
+#endif
+  for (k = 0; k < NSCRATCH; k++)
+    if (scratch[k] != NULL) 
+    {
+      freeimage(scratch[k]);
+      scratch[k] = NULL;
+    }
+} /* purgescratch() */
+
 /* ==================================== */
 int32_t copy2image(struct xvimage *dest, struct xvimage *source)
 /* ==================================== */
@@ -448,6 +662,129 @@ int32_t equalimages(struct xvimage *im1, struct xvimage *im2)
   return 1;
 } // equalimages()
 
+/* ==================================== */
+int32_t touchframe(struct xvimage *f)
+/* ==================================== */
+// returns 1 if the byte image f has a non-null point on its frame
+// (first or last row, column, and plane if f is 3D), 0 otherwise
+#undef F_NAME
+#define F_NAME "touchframe"
+{
+  int32_t rs = rowsize(f);         /* taille ligne */
+  int32_t cs = colsize(f);         /* taille colonne */
+  int32_t ds = depth(f);           /* nb plans */
+  int32_t ps = rs * cs;            /* taille plan */
+  uint8_t *F = UCHARDATA(f);
+  int32_t x, y, z;
+
+  if (ds > 1)
+  {
+    for (x = 0; x < ps; x++) if (F[x] || F[(ds-1)*ps + x]) return 1;
+    for (z = 1; z < ds-1; z++)
+    {
+      for (x = 0; x < rs; x++)
+        if (F[z*ps + x] || F[z*ps + (cs-1)*rs + x]) return 1;
+      for (y = 1; y < cs-1; y++)
+        if (F[z*ps + y*rs] || F[z*ps + y*rs + rs-1]) return 1;
+    }
+  }
+  else
+  {
+    for (x = 0; x < rs; x++) if (F[x] || F[(cs-1)*rs + x]) return 1;
+    for (y = 1; y < cs-1; y++) if (F[y*rs] || F[y*rs + rs-1]) return 1;
+  }
+  return 0;
+} // touchframe()
+
+/* ==================================== */
+struct xvimage *addframe(struct xvimage *f)
+/* ==================================== */
+// returns a copy of the byte image f surrounded by a null frame of width 1
+// (one pixel in 2D, one voxel in 3D). The original image can be retrieved
+// with delframe.
+#undef F_NAME
+#define F_NAME "addframe"
+{
+  int32_t rs = rowsize(f);         /* taille ligne */
+  int32_t cs = colsize(f);         /* taille colonne */
+  int32_t ds = depth(f);           /* nb plans */
+  int32_t ps = rs * cs;            /* taille plan */
+  int32_t rs2 = rs + 2, cs2 = cs + 2, ds2 = (ds > 1) ? ds + 2 : 1;
+  int32_t ps2 = rs2 * cs2, z0 = (ds > 1) ? 1 : 0;
+  uint8_t *F = UCHARDATA(f), *G;
+  struct xvimage *g;
+  int32_t y, z;
+
+  if (datatype(f) != VFF_TYP_1_BYTE)
+  {
+    fprintf(stderr, "%s: only byte images are allowed\n", F_NAME);
+    return NULL;
+  }
+  g = allocimage(NULL, rs2, cs2, ds2, VFF_TYP_1_BYTE);
+  if (g == NULL)
+  {
+    fprintf(stderr, "%s: allocimage failed\n", F_NAME);
+    return NULL;
+  }
+  G = UCHARDATA(g);
+  for (z = 0; z < ds; z++)
+    for (y = 0; y < cs; y++)
+      memcpy(G + (z+z0)*ps2 + (y+1)*rs2 + 1, F + z*ps + y*rs, rs);
+  g->xdim = f->xdim; g->ydim = f->ydim; g->zdim = f->zdim;
+  return g;
+} // addframe()
+
+/* ==================================== */
+int32_t addframes(struct xvimage *f, struct xvimage *i, struct xvimage **ff, struct xvimage **fi)
+/* ==================================== */
+// framed copies (see addframe) of the byte image f in *ff and, if i is not
+// NULL, of the image i in *fi (else *fi = NULL). Returns 0 and allocates 
+// nothing if one of the copies fails.
+{
+  *fi = NULL;
+  if ((*ff = addframe(f)) == NULL) return 0;
+  if ((i != NULL) && ((*fi = addframe(i)) == NULL))
+  {
+    freeimage(*ff);
+    *ff = NULL;
+    return 0;
+  }
+  return 1;
+} // addframes()
+
+/* ==================================== */
+int32_t delframe(struct xvimage *f, struct xvimage *g)
+/* ==================================== */
+// copies into the byte image f the interior of g, which must have been
+// obtained from an image of the size of f by addframe
+#undef F_NAME
+#define F_NAME "delframe"
+{
+  int32_t rs = rowsize(f);         /* taille ligne */
+  int32_t cs = colsize(f);         /* taille colonne */
+  int32_t ds = depth(f);           /* nb plans */
+  int32_t ps = rs * cs;            /* taille plan */
+  int32_t rs2 = rs + 2, cs2 = cs + 2, ds2 = (ds > 1) ? ds + 2 : 1;
+  int32_t ps2 = rs2 * cs2, z0 = (ds > 1) ? 1 : 0;
+  uint8_t *F = UCHARDATA(f), *G = UCHARDATA(g);
+  int32_t y, z;
+
+  if ((rowsize(g) != rs2) || (colsize(g) != cs2) || (depth(g) != ds2))
+  {
+    fprintf(stderr, "%s: incompatible image sizes\n", F_NAME);
+    return 0;
+  }
+  if ((datatype(f) != VFF_TYP_1_BYTE) || (datatype(g) != VFF_TYP_1_BYTE))
+  {
+    fprintf(stderr, "%s: only byte images are allowed\n", F_NAME);
+    return 0;
+  }
+  for (z = 0; z < ds; z++)
+    for (y = 0; y < cs; y++)
+      memcpy(F + z*ps + y*rs, G + (z+z0)*ps2 + (y+1)*rs2 + 1, rs);
+  return 1;
+} // delframe()
+
 /* ==================================== */
 int32_t convertgen(struct xvimage **f1, struct xvimage **f2)
 /* ==================================== */
@@ -1090,6 +1427,157 @@ void writelongimage(struct xvimage * image,  char *filename)
   fclose(fd);
 } /* writelongimage() */
 
+/* ==================================== */
+static int32_t * listepoints(struct xvimage * image, int32_t *n)
+/* ==================================== */
+// index croissants des points non nuls de image (byte ou int32_t), ou NULL
+{
+  int32_t N = rowsize(image) * colsize(image) * depth(image);
+  int32_t i, j, k, m = 0, nmax = 1024;
+  int32_t *I = (int32_t *)malloc(nmax * sizeof(int32_t)), *J;
+  uint64_t o;
+
+  if (I == NULL) return NULL;
+  for (i = 0; i < N; i += 64)
+  {
+    k = min(64, N - i);
+    if (datatype(image) == VFF_TYP_1_BYTE) 
+      o = mc_non_nuls64(UCHARDATA(image) + i, k);
+    else 
+      for (o = 0, j = 0; j < k; j++) 
+	if (ULONGDATA(image)[i + j]) o |= 1ULL << j;
+    for (; o; o &= o - 1)
+    {
+      if (m == nmax)
+      {
+	J = (int32_t *)realloc(I, 2 * nmax * sizeof(int32_t));
+	if (J == NULL) { free(I); return NULL; }
+	I = J; nmax *= 2;
+      }
+      I[m++] = i + RANG64(o);
+    }
+  }
+  *n = m;
+  return I;
+} /* listepoints() */
+
+/* ==================================== */
+static int32_t nbvoisins(struct xvimage * image, int32_t i)
+/* ==================================== */
+// nombre de voisins non nuls du point i (26-voisins en 3D, 8-voisins en 2D)
+{
+  int32_t rs = rowsize(image), cs = colsize(image), ds = depth(image), ps = rs * cs;
+  int32_t x = i % rs, y = (i % ps) / rs, z = i / ps, dx, dy, dz, j, n = 0;
+
+  for (dz = -1; dz <= 1; dz++)
+    for (dy = -1; dy <= 1; dy++)
+      for (dx = -1; dx <= 1; dx++)
+      {
+	if ((dx == 0) && (dy == 0) && (dz == 0)) continue;
+	if ((x + dx < 0) || (x + dx >= rs) || (y + dy < 0) || (y + dy >= cs) ||
+	    (z + dz < 0) || (z + dz >= ds)) continue;
+	j = i + dz * ps + dy * rs + dx;
+	if ((datatype(image) == VFF_TYP_1_BYTE) ? UCHARDATA(image)[j] : ULONGDATA(image)[j]) n++;
+      }
+  return n;
+} /* nbvoisins() */
+
+/* ==================================== */
+void writelistimage(struct xvimage * image, char *filename, int32_t ascii, int32_t attr)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "writelistimage"
+/* 
+   Ecrit la liste des points non nuls de image (byte ou int32_t), par index
+   croissant, au lieu de l'image complete : un squelette ne contient qu'une
+   infime partie des points, le fichier ne fait que quelques kilo-octets et
+   les traitements suivants n'ont pas a parcourir tout le volume. 
+   Formats (extensions MC) : 
+     PD (binaire) : en-tete comme P5 mais la derniere ligne est "n a [t]"
+       (nombre de points, attribut et, pour LISTE_VALEUR, type de l'image :
+       VFF_TYP_1_BYTE ou VFF_TYP_4_BYTE), suivie des n index (int32_t) 
+       puis, si a != 0, des n attributs (int32_t)
+     PC (ascii) : meme en-tete, puis une ligne par point : x y [z] [attribut]
+   attr : LISTE_SANS, LISTE_VALEUR (valeur du point, par exemple pour une
+   carte des etapes de retrait) ou LISTE_VOISINS (nombre de voisins non 
+   nuls du point : 1 pour une extremite, 3 ou plus pour une jonction d'un
+   squelette curviligne).
+   Relue par readimage (image byte, points a NDG_MAX ; pour LISTE_VALEUR,
+   image des valeurs, du type de l'image ecrite) ou par readlistimage.
+*/
+{
+  FILE *fd = NULL;
+  int32_t rs, cs, d, ps, n, k, ret;
+  int32_t *I, *A = NULL;
+
+  rs = rowsize(image);
+  cs = colsize(image);
+  d = depth(image);
+  ps = rs * cs;
+  if ((datatype(image) != VFF_TYP_1_BYTE) && (datatype(image) != VFF_TYP_4_BYTE))
+  {   fprintf(stderr,"%s() : bad datatype : %d\n", F_NAME, datatype(image));
+      exit(0);
+  }
+
+  I = listepoints(image, &n);
+  if ((I != NULL) && (attr != LISTE_SANS)) A = (int32_t *)malloc((n + 1) * sizeof(int32_t));
+  if ((I == NULL) || ((attr != LISTE_SANS) && (A == NULL)))
+  {
+    fprintf(stderr, "%s: malloc failed\n", F_NAME);
+    exit(0);
+  }
+  for (k = 0; (attr != LISTE_SANS) && (k < n); k++)
+    if (attr == LISTE_VOISINS) A[k] = nbvoisins(image, I[k]);
+    else if (datatype(image) == VFF_TYP_1_BYTE) A[k] = UCHARDATA(image)[I[k]];
+    else A[k] = (int32_t)ULONGDATA(image)[I[k]];
+
+#ifdef UNIXIO
+  fd = fopen(filename,"w");
+#endif
+#ifdef DOSIO
+  fd = fopen(filename,"wb");
+#endif
+  if (!fd)
+  {
+    fprintf(stderr, "%s: cannot open file: %s\n", F_NAME, filename);
+    exit(0);
+  }
+
+  fputs(ascii ? "PC\n" : "PD\n", fd);
+  if ((image->xdim != 0.0) && (d > 1))
+    fprintf(fd, "#xdim %g\n#ydim %g\n#zdim %g\n", image->xdim, image->ydim, image->zdim);
+  if ((image->xdim != 0.0) && (d == 1))
+    fprintf(fd, "#xdim %g\n#ydim %g\n", image->xdim, image->ydim);
+  if (d > 1) fprintf(fd, "%d %d %d\n", rs, cs, d); else  fprintf(fd, "%d %d\n", rs, cs);
+  if (attr == LISTE_VALEUR) fprintf(fd, "%d %d %d\n", n, attr, datatype(image));
+  else fprintf(fd, "%d %d\n", n, attr);
+
+  if (ascii)
+  {
+    for (k = 0; k < n; k++)
+    {
+      if (d > 1) fprintf(fd, "%d %d %d", I[k] % rs, (I[k] % ps) / rs, I[k] / ps);
+      else fprintf(fd, "%d %d", I[k] % rs, I[k] / rs);
+      if (A != NULL) fprintf(fd, " %d", A[k]);
+      fputc('\n', fd);
+    }
+  }
+  else
+  {
+    ret = fwrite(I, sizeof(int32_t), n, fd);
+    if ((ret == n) && (A != NULL)) ret = fwrite(A, sizeof(int32_t), n, fd);
+    if (ret != n)
+    {
+      fprintf(stderr, "%s: only %d items written\n", F_NAME, ret);
+      exit(0);
+    }
+  }
+
+  fclose(fd);
+  free(I);
+  if (A != NULL) free(A);
+} /* writelistimage() */
+
 /* ==================================== */
 struct xvimage * readimage(char *filename)
 /* ==================================== */
@@ -1102,7 +1590,7 @@ struct xvimage * readimage(char *filename)
   struct xvimage * image;
   int32_t ascii;  
   int32_t typepixel;
-  int32_t c;
+  int32_t c, pgm5 = 0;
   double xdim=1.0, ydim=1.0, zdim=1.0;
   char *read;
 
@@ -1125,6 +1613,9 @@ struct xvimage * readimage(char *filename)
                                  /* PA: ascii float 2d-3d  ==  extension LN */
                                  /* PB: ascii int32_t 2d-3d  ==  extension MC */
 
+                                 /* PC: ascii point list  ==  extension MC */
+                                 /* PD: raw point list  ==  extension MC */
+
                                  /* P7: raw byte 3d : OBSOLETE - left for compatibility */
   if (!read)
   {
@@ -1136,10 +1627,24 @@ struct xvimage * readimage(char *filename)
   {   fprintf(stderr,"%s : invalid image format\n", F_NAME);
       return NULL;
   }
+  if ((buffer[1] == 'C') || (buffer[1] == 'D'))
+  {
+    struct xvimage * attr;
+    int32_t a;
+    fclose(fd);
+    image = readlistimage(filename, &attr, &a);
+    if ((image != NULL) && (a == LISTE_VALEUR))
+    { // liste des valeurs d'une image : on la restitue, dans son type
+      freeimage(image);
+      return attr;
+    }
+    if (attr != NULL) freeimage(attr);
+    return image;
+  }
   switch (buffer[1])
   {
     case '2': ascii = 1; typepixel = VFF_TYP_1_BYTE; break;
-    case '5':
+    case '5': pgm5 = 1;
     case '7': ascii = 0; typepixel = VFF_TYP_1_BYTE; break;
     case '8': ascii = 0; typepixel = VFF_TYP_4_BYTE; break;
     case '9': ascii = 0; typepixel = VFF_TYP_FLOAT; break;
@@ -1181,6 +1686,16 @@ struct xvimage * readimage(char *filename)
   }
 
   sscanf(buffer, "%d", &ndgmax);
+  if (pgm5 && (ndgmax > 255)) // 2 octets par point (voir writeimage)
+  {
+    if (ndgmax > 65535)
+    {
+      fprintf(stderr,"%s : wrong ndgmax = %d\n", F_NAME, ndgmax);
+      fclose(fd);
+      return(NULL);
+    }
+    typepixel = VFF_TYP_2_BYTE;
+  }
   N = rs * cs * d;
 
   image = allocimage(NULL, rs, cs, d, typepixel);
@@ -1225,6 +1740,16 @@ struct xvimage * readimage(char *filename)
     }
   } /* if (typepixel == VFF_TYP_1_BYTE) */
   else
+  if (typepixel == VFF_TYP_2_BYTE)
+  { // dans l'ordre des octets de la machine, comme writeimage
+    int32_t ret = fread(USHORTDATA(image), sizeof(uint16_t), N, fd);
+    if (ret != N)
+    {
+      fprintf(stderr,"%s : fread failed : %d asked ; %d read\n", F_NAME, N, ret);
+      return(NULL);
+    }
+  } /* if (typepixel == VFF_TYP_2_BYTE) */
+  else
   if (typepixel == VFF_TYP_4_BYTE)
   {
     if (ascii)
@@ -1270,6 +1795,140 @@ struct xvimage * readimage(char *filename)
   return image;
 } /* readimage() */
 
+/* ==================================== */
+struct xvimage * readlistimage(char *filename, struct xvimage **attr, int32_t *a)
+/* ==================================== */
+#undef F_NAME
+#define F_NAME "readlistimage"
+/* 
+   Lit une liste de points (PC ou PD, voir writelistimage) et retourne 
+   l'image byte dont ces points valent NDG_MAX. Si attr n'est pas NULL, 
+   *attr recoit l'image des attributs des points (NULL si la liste n'en a 
+   pas) et *a leur nature (LISTE_SANS, LISTE_VALEUR, LISTE_VOISINS). 
+   L'image des attributs est int32_t, sauf pour LISTE_VALEUR ou elle est 
+   du type de l'image ecrite (int32_t si l'en-tete ne le precise pas).
+*/
+{
+  char buffer[BUFFERSIZE];
+  FILE *fd = NULL;
+  int32_t rs, cs, d, ps, N, n, na, k, x, y, z, c, ascii;
+  int32_t t = VFF_TYP_4_BYTE;
+  int32_t *I, *A;
+  struct xvimage * image, * att = NULL;
+  double xdim=1.0, ydim=1.0, zdim=1.0;
+  char *read;
+
+  if (attr != NULL) *attr = NULL;
+  if (a != NULL) *a = LISTE_SANS;
+#ifdef UNIXIO
+  fd = fopen(filename,"r");
+#endif
+#ifdef DOSIO
+  fd = fopen(filename,"rb");
+#endif
+  if (!fd)
+  {
+    fprintf(stderr, "%s: file not found: %s\n", F_NAME, filename);
+    return NULL;
+  }
+
+  read = fgets(buffer, BUFFERSIZE, fd);
+  if (!read || (buffer[0] != 'P') || ((buffer[1] != 'C') && (buffer[1] != 'D')))
+  {   fprintf(stderr,"%s : invalid point list format\n", F_NAME);
+      fclose(fd);
+      return NULL;
+  }
+  ascii = (buffer[1] == 'C');
+
+  do
+  {
+    read = fgets(buffer, BUFFERSIZE, fd); /* commentaire */
+    if (!read)
+    {
+      fprintf(stderr, "%s: fgets returned without reading\n", F_NAME);
+      fclose(fd);
+      return NULL;
+    }
+    if (strncmp(buffer, "#xdim", 5) == 0)
+      sscanf(buffer+5, "%lf", &xdim);
+    else if (strncmp(buffer, "#ydim", 5) == 0)
+      sscanf(buffer+5, "%lf", &ydim);
+    else if (strncmp(buffer, "#zdim", 5) == 0)
+      sscanf(buffer+5, "%lf", &zdim);
+  } while (!isdigit(buffer[0]));
+
+  c = sscanf(buffer, "%d %d %d", &rs, &cs, &d);
+  if (c == 2) d = 1;
+  read = fgets(buffer, BUFFERSIZE, fd);
+  if (((c != 2) && (c != 3)) || !read || (sscanf(buffer, "%d %d %d", &n, &na, &t) < 2) || (n < 0) ||
+      ((na == LISTE_VALEUR) && (t != VFF_TYP_1_BYTE) && (t != VFF_TYP_4_BYTE)))
+  {   fprintf(stderr,"%s : invalid point list format\n", F_NAME);
+      fclose(fd);
+      return NULL;
+  }
+  ps = rs * cs;
+  N = ps * d;
+
+  image = allocimage(NULL, rs, cs, d, VFF_TYP_1_BYTE);
+  if (na != LISTE_SANS) att = allocimage(NULL, rs, cs, d, (na == LISTE_VALEUR) ? t : VFF_TYP_4_BYTE);
+  I = (int32_t *)malloc((n + 1) * sizeof(int32_t));
+  A = (int32_t *)malloc((n + 1) * sizeof(int32_t));
+  if ((image == NULL) || ((na != LISTE_SANS) && (att == NULL)) || (I == NULL) || (A == NULL))
+  {   fprintf(stderr,"%s : alloc failed\n", F_NAME);
+      fclose(fd);
+      return(NULL);
+  }
+  image->xdim = xdim;
+  image->ydim = ydim;
+  image->zdim = zdim;
+
+  if (ascii)
+  {
+    for (k = 0; k < n; k++)
+    {
+      z = 0;
+      c = (d > 1) ? fscanf(fd, "%d %d %d", &x, &y, &z) - 3 : fscanf(fd, "%d %d", &x, &y) - 2;
+      if ((c == 0) && (na != LISTE_SANS)) c = fscanf(fd, "%d", &(A[k])) - 1;
+      if ((c != 0) || (x < 0) || (x >= rs) || (y < 0) || (y >= cs) || (z < 0) || (z >= d)) break;
+      I[k] = z * ps + y * rs + x;
+    }
+  }
+  else
+  {
+    k = fread(I, sizeof(int32_t), n, fd);
+    if ((k == n) && (na != LISTE_SANS)) k = fread(A, sizeof(int32_t), n, fd);
+    if (k == n) 
+      for (k = 0; (k < n) && (I[k] >= 0) && (I[k] < N); k++) ;
+  }
+  fclose(fd);
+  if (k != n)
+  {
+    fprintf(stderr,"%s : bad point %d of %d\n", F_NAME, k, n);
+    free(I); free(A); freeimage(image);
+    if (att != NULL) freeimage(att);
+    return(NULL);
+  }
+
+  for (k = 0; k < n; k++)
+  {
+    UCHARDATA(image)[I[k]] = NDG_MAX;
+    if (att == NULL) continue;
+    if (datatype(att) == VFF_TYP_1_BYTE) UCHARDATA(att)[I[k]] = (uint8_t)A[k];
+    else ULONGDATA(att)[I[k]] = (uint32_t)A[k];
+  }
+  free(I);
+  free(A);
+  if (att != NULL) 
+  {
+    att->xdim = xdim;
+    att->ydim = ydim;
+    att->zdim = zdim;
+    if (attr != NULL) *attr = att; else freeimage(att);
+  }
+  if (a != NULL) *a = na;
+  return image;
+} /* readlistimage() */
+
 /* ==================================== */
 struct xvimage * readheader(char *filename)
 /* ==================================== */
@@ -1282,7 +1941,7 @@ struct xvimage * readheader(char *filename)
   struct xvimage * image;
   int32_t ascii;  
   int32_t typepixel;
-  int32_t c;
+  int32_t c, liste = 0, na, t = VFF_TYP_4_BYTE, pgm5 = 0;
   double xdim=1.0, ydim=1.0, zdim=1.0;
   char *read;
 
@@ -1312,12 +1971,14 @@ struct xvimage * readheader(char *filename)
   switch (buffer[1])
   {
     case '2': ascii = 1; typepixel = VFF_TYP_1_BYTE; break;
-    case '5':
+    case '5': pgm5 = 1;
     case '7': ascii = 0; typepixel = VFF_TYP_1_BYTE; break;
     case '8': ascii = 0; typepixel = VFF_TYP_4_BYTE; break;
     case '9': ascii = 0; typepixel = VFF_TYP_FLOAT; break;
     case 'A': ascii = 1; typepixel = VFF_TYP_FLOAT; break;
     case 'B': ascii = 1; typepixel = VFF_TYP_4_BYTE; break;
+    case 'C': ascii = 1; liste = 1; typepixel = VFF_TYP_1_BYTE; break;
+    case 'D': ascii = 0; liste = 1; typepixel = VFF_TYP_1_BYTE; break;
     default:
       fprintf(stderr,"%s : invalid image format: %c%c\n", F_NAME, buffer[0], buffer[1]);
       return NULL;
@@ -1354,6 +2015,11 @@ struct xvimage * readheader(char *filename)
   }
 
   sscanf(buffer, "%d", &ndgmax);
+  if (pgm5 && (ndgmax > 255)) typepixel = VFF_TYP_2_BYTE;
+  // liste de valeurs : image du type ecrit (voir writelistimage)
+  if (liste && (sscanf(buffer, "%d %d %d", &ndgmax, &na, &t) >= 2) && (na == LISTE_VALEUR) &&
+      ((t == VFF_TYP_1_BYTE) || (t == VFF_TYP_4_BYTE)))
+    typepixel = t;
 
   image = allocheader(NULL, rs, cs, d, typepixel);
   if (image == NULL)
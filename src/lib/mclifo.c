@@ -39,6 +39,10 @@ knowledge of the CeCILL license and that you accept its terms.
    fonctions pour la gestion d'une liste lifo
 
    Michel Couprie 1996
+
+   listes extensibles (indices sur 64 bits, capacite doublee a la demande) :
+   Pile (lifo), File (fifo, tampon circulaire), Seaux (file de priorite
+   a niveaux entiers) et Piles (une pile par thread)
 */
 
 /* #define TESTLifo */
@@ -46,6 +50,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mclifo.h>
 
 /* ==================================== */
@@ -156,6 +161,361 @@ void LifoTermine(
   free(L);
 }
 
+/* ==================================== */
+/* ==================================== */
+/*        LISTES EXTENSIBLES            */
+/* ==================================== */
+/* ==================================== */
+
+/* ==================================== */
+static int64_t *agrandit(int64_t *T, int64_t taille)
+/* ==================================== */
+{
+  T = (int64_t *)realloc(T, taille * sizeof(int64_t));
+  if (T == NULL)
+  {
+    fprintf(stderr, "mclifo : malloc failed : %lld bytes\n", (long long)(taille * sizeof(int64_t)));
+    exit(1);
+  }
+  return T;
+} /* agrandit() */
+
+/* ==================================== */
+Pile * CreePile(int64_t taille)
+/* ==================================== */
+// taille : capacite initiale (au moins 1)
+{
+  Pile * P = (Pile *)malloc(sizeof(Pile));
+  if (taille < 1) taille = 1;
+  if (P != NULL) P->Pts = (int64_t *)malloc(taille * sizeof(int64_t));
+  if ((P == NULL) || (P->Pts == NULL))
+  {   
+    fprintf(stderr, "CreePile() : malloc failed : %lld bytes\n", (long long)(taille * sizeof(int64_t)));
+    free(P);
+    return NULL;
+  }
+  P->Max = taille;
+  P->Sp = 0;
+  return P;
+} /* CreePile() */
+
+/* ==================================== */
+void PileFlush(Pile * P)
+/* ==================================== */
+{
+  P->Sp = 0;
+}
+
+/* ==================================== */
+int32_t PileVide(Pile * P)
+/* ==================================== */
+{
+  return (P->Sp == 0);
+}
+
+/* ==================================== */
+int64_t PileTaille(Pile * P)
+/* ==================================== */
+{
+  return P->Sp;
+}
+
+/* ==================================== */
+void PilePush(Pile * P, int64_t V)
+/* ==================================== */
+{
+  if (P->Sp == P->Max) P->Pts = agrandit(P->Pts, P->Max = 2 * P->Max);
+  P->Pts[P->Sp++] = V;
+}
+
+/* ==================================== */
+int64_t PilePop(Pile * P)
+/* ==================================== */
+{
+  if (P->Sp == 0)
+  {
+    fprintf(stderr, "erreur Pile vide\n");
+    exit(1);
+  }
+  return P->Pts[--P->Sp];
+}
+
+/* ==================================== */
+void PilePushN(Pile * P, int64_t *V, int64_t n)
+/* ==================================== */
+// empile V[0], ..., V[n-1]
+{
+  int64_t m = P->Max;
+  while (P->Sp + n > m) m = 2 * m;
+  if (m > P->Max) P->Pts = agrandit(P->Pts, P->Max = m);
+  memcpy(P->Pts + P->Sp, V, n * sizeof(int64_t));
+  P->Sp += n;
+}
+
+/* ==================================== */
+int64_t PilePopN(Pile * P, int64_t *V, int64_t n)
+/* ==================================== */
+// depile au plus n elements dans V (dans l'ordre de la pile) ; retourne leur nombre
+{
+  if (n > P->Sp) n = P->Sp;
+  P->Sp -= n;
+  memcpy(V, P->Pts + P->Sp, n * sizeof(int64_t));
+  return n;
+}
+
+/* ==================================== */
+void PileTermine(Pile * P)
+/* ==================================== */
+{
+  free(P->Pts);
+  free(P);
+}
+
+/* ==================================== */
+static void FileAgrandit(File * F, int64_t taille)
+/* ==================================== */
+// porte la capacite de F a taille (puissance de 2), en conservant l'ordre
+{
+  int64_t *T = NULL, k;
+  T = agrandit(T, taille);
+  for (k = F->Out; k < F->In; k++) T[k & (taille-1)] = F->Pts[k & (F->Max-1)];
+  free(F->Pts);
+  F->Pts = T;
+  F->Max = taille;
+} /* FileAgrandit() */
+
+/* ==================================== */
+File * CreeFile(int64_t taille)
+/* ==================================== */
+// taille : capacite initiale, arrondie a la puissance de 2 superieure
+{
+  File * F = (File *)calloc(1, sizeof(File));
+  int64_t m = 1;
+  if (F == NULL)
+  {   
+    fprintf(stderr, "CreeFile() : malloc failed : %d bytes\n", (int32_t)sizeof(File));
+    return NULL;
+  }
+  while (m < taille) m = 2 * m;
+  if ((F->Pts = (int64_t *)malloc(m * sizeof(int64_t))) == NULL)
+  {   
+    fprintf(stderr, "CreeFile() : malloc failed : %lld bytes\n", (long long)(m * sizeof(int64_t)));
+    free(F);
+    return NULL;
+  }
+  F->Max = m;
+  return F;
+} /* CreeFile() */
+
+/* ==================================== */
+void FileFlush(File * F)
+/* ==================================== */
+{
+  F->In = F->Out = 0;
+}
+
+/* ==================================== */
+int32_t FileVide(File * F)
+/* ==================================== */
+{
+  return (F->In == F->Out);
+}
+
+/* ==================================== */
+int64_t FileTaille(File * F)
+/* ==================================== */
+{
+  return F->In - F->Out;
+}
+
+/* ==================================== */
+void FilePush(File * F, int64_t V)
+/* ==================================== */
+{
+  if (F->In - F->Out == F->Max) FileAgrandit(F, F->Max ? 2 * F->Max : 16);
+  F->Pts[F->In++ & (F->Max-1)] = V;
+}
+
+/* ==================================== */
+int64_t FilePop(File * F)
+/* ==================================== */
+{
+  if (F->In == F->Out)
+  {
+    fprintf(stderr, "erreur File vide\n");
+    exit(1);
+  }
+  return F->Pts[F->Out++ & (F->Max-1)];
+}
+
+/* ==================================== */
+void FilePushN(File * F, int64_t *V, int64_t n)
+/* ==================================== */
+// enfile V[0], ..., V[n-1], par au plus deux copies contigues
+{
+  int64_t m = F->Max ? F->Max : 16, i, l;
+  while (F->In - F->Out + n > m) m = 2 * m;
+  if (m > F->Max) FileAgrandit(F, m);
+  while (n > 0)
+  {
+    i = F->In & (F->Max-1);
+    l = F->Max - i; if (l > n) l = n;
+    memcpy(F->Pts + i, V, l * sizeof(int64_t));
+    F->In += l; V += l; n -= l;
+  }
+}
+
+/* ==================================== */
+int64_t FilePopN(File * F, int64_t *V, int64_t n)
+/* ==================================== */
+// defile au plus n elements dans V ; retourne leur nombre
+{
+  int64_t i, l, r;
+  if (n > F->In - F->Out) n = F->In - F->Out;
+  r = n;
+  while (r > 0)
+  {
+    i = F->Out & (F->Max-1);
+    l = F->Max - i; if (l > r) l = r;
+    memcpy(V, F->Pts + i, l * sizeof(int64_t));
+    F->Out += l; V += l; r -= l;
+  }
+  return n;
+}
+
+/* ==================================== */
+void FileTermine(File * F)
+/* ==================================== */
+{
+  free(F->Pts);
+  free(F);
+}
+
+/* ==================================== */
+Seaux * CreeSeaux(int32_t nbniv)
+/* ==================================== */
+/*
+  File de priorite a niveaux entiers 0..nbniv-1 (une file par niveau, 
+  allouee au premier ajout). SeauxPop retourne le premier element entre 
+  du plus petit niveau non vide ; un ajout a un niveau inferieur au niveau
+  courant est permis (le niveau courant recule). Quand les niveaux 
+  extraits ne decroissent pas, le cout total est en O(nombre d'elements 
+  + nbniv).
+*/
+{
+  Seaux * B = (Seaux *)malloc(sizeof(Seaux));
+  if (B != NULL) B->F = (File *)calloc(nbniv, sizeof(File));
+  if ((B == NULL) || (B->F == NULL))
+  {   
+    fprintf(stderr, "CreeSeaux() : malloc failed : %lld bytes\n", (long long)nbniv * sizeof(File));
+    free(B);
+    return NULL;
+  }
+  B->NbNiv = nbniv;
+  B->Niv = nbniv;
+  B->Nb = 0;
+  return B;
+} /* CreeSeaux() */
+
+/* ==================================== */
+int32_t SeauxVide(Seaux * B)
+/* ==================================== */
+{
+  return (B->Nb == 0);
+}
+
+/* ==================================== */
+void SeauxPush(Seaux * B, int32_t niv, int64_t V)
+/* ==================================== */
+{
+  if ((niv < 0) || (niv >= B->NbNiv))
+  {
+    fprintf(stderr, "erreur Seaux : niveau %d hors de [0,%d[\n", niv, B->NbNiv);
+    exit(1);
+  }
+  FilePush(&B->F[niv], V);
+  B->Nb++;
+  if (niv < B->Niv) B->Niv = niv;
+}
+
+/* ==================================== */
+int64_t SeauxPop(Seaux * B, int32_t *niv)
+/* ==================================== */
+// retourne un element de plus petit niveau, et ce niveau dans niv (si non NULL)
+{
+  if (B->Nb == 0)
+  {
+    fprintf(stderr, "erreur Seaux vide\n");
+    exit(1);
+  }
+  while (FileVide(&B->F[B->Niv])) B->Niv++;
+  B->Nb--;
+  if (niv) *niv = B->Niv;
+  return FilePop(&B->F[B->Niv]);
+}
+
+/* ==================================== */
+void SeauxTermine(Seaux * B)
+/* ==================================== */
+{
+  int32_t k;
+  for (k = 0; k < B->NbNiv; k++) free(B->F[k].Pts);
+  free(B->F);
+  free(B);
+}
+
+/* ==================================== */
+Piles * CreePiles(int32_t nb, int64_t taille)
+/* ==================================== */
+/*
+  nb piles independantes, de capacite initiale taille : chaque thread 
+  d'un calcul parallele empile dans la sienne (L->P[numero du thread]) 
+  sans synchronisation ; PilesVerse les regroupe ensuite. Les piles 
+  conservent leur capacite d'un appel a l'autre.
+*/
+{
+  int32_t k;
+  Piles * L = (Piles *)malloc(sizeof(Piles));
+  if (L != NULL) L->P = (Pile **)calloc(nb, sizeof(Pile *));
+  if ((L == NULL) || (L->P == NULL))
+  {   
+    fprintf(stderr, "CreePiles() : malloc failed\n");
+    free(L);
+    return NULL;
+  }
+  L->Nb = nb;
+  for (k = 0; k < nb; k++)
+    if ((L->P[k] = CreePile(taille)) == NULL) 
+    {
+      PilesTermine(L);
+      return NULL;
+    }
+  return L;
+} /* CreePiles() */
+
+/* ==================================== */
+void PilesVerse(Piles * L, Pile * P)
+/* ==================================== */
+// empile dans P le contenu des piles de L (dans l'ordre des piles), qui sont videes
+{
+  int32_t k;
+  for (k = 0; k < L->Nb; k++)
+  {
+    PilePushN(P, L->P[k]->Pts, L->P[k]->Sp);
+    L->P[k]->Sp = 0;
+  }
+}
+
+/* ==================================== */
+void PilesTermine(Piles * L)
+/* ==================================== */
+{
+  int32_t k;
+  for (k = 0; k < L->Nb; k++) if (L->P[k]) PileTermine(L->P[k]);
+  free(L->P);
+  free(L);
+}
+
 #ifdef TESTLifo
 void main()
 {
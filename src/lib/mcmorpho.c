@@ -0,0 +1,388 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Librairie mcmorpho :
+
+   erosions et dilatations binaires par les voisinages elementaires
+   (gamma 4 et 8 en 2D, gamma 6, 18 et 26 en 3D, point central compris)
+
+   Les images en octets contiennent des valeurs 0/1. Les elements
+   structurants 8 et 26 sont decomposes en segments de 3 points selon les
+   axes (x, puis y, puis z) ; 4 et 6 sont l'union (ou l'intersection) du
+   segment en x et des voisins en y et z, 18 l'union des trois carres
+   3x3 xy, xz et yz. Chaque passe traite une ligne de rs octets a la fois
+   (mc_combine, vectorise selon le processeur : voir mcsimd), et les lignes
+   sont reparties entre les threads (OpenMP).
+
+   Les plans de bits sont ceux de lskelMK2b : (cs+2) lignes de ws mots,
+   ws = (rs+63)/64 + 2, le point (x,y) etant le bit x%64 du mot 
+   (y+1)*ws + 1 + x/64 ; les lignes et mots de bord sont nuls. Les volumes
+   de bits empilent ds+2 tels plans, le point (x,y,z) etant le bit x%64 du
+   mot ((z+1)*(cs+2) + y+1)*ws + 1 + x/64 ; les plans de bord sont nuls.
+   En 3D, chaque mot resultat combine les lignes voisines (y+-1, z+-1) 
+   retenues par l'element structurant, decalees d'un bit pour les voisins 
+   en x.
+
+   Les points hors de l'image sont consideres comme nuls, pour les 
+   erosions comme pour les dilatations (comme dans nbvois4, nbvoiso6, ...).
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mcmorpho.h>
+#include <mcsimd.h>
+
+#define MORPHO_E(p,w) (((p)[w] >> 1) | ((p)[(w)+1] << 63))  /* voisin est */
+#define MORPHO_O(p,w) (((p)[w] << 1) | ((p)[(w)-1] >> 63))  /* voisin ouest */
+
+/* ==================================== */
+static void passe_x(uint8_t *F, uint8_t *R, int32_t rs, int32_t nl, int32_t ero)
+/* ==================================== */
+// R := F \oplus (ou \ominus) le segment [x-1, x+1], pour nl lignes de rs points
+{
+  int32_t l;
+  uint8_t *f, *r;
+#ifdef _OPENMP
+#pragma omp parallel for private(f, r)
+#endif
+  for (l = 0; l < nl; l++)
+  {
+    f = F + (size_t)l * rs; r = R + (size_t)l * rs;
+    if (rs < 2) { r[0] = ero ? 0 : f[0]; continue; }
+    mc_combine(f, f+1, f+2, r+1, rs-2, ero);
+    r[0] = ero ? 0 : (f[0] | f[1]);
+    r[rs-1] = ero ? 0 : (f[rs-2] | f[rs-1]);
+  }
+} /* passe_x() */
+
+/* ==================================== */
+static void passe_d(uint8_t *F, uint8_t *R, int32_t rs, int32_t nl, 
+		    int32_t d, int32_t div, int32_t n, int32_t ero, int32_t acc)
+/* ==================================== */
+/*
+  Passe selon la direction de pas d (rs pour y, rs*cs pour z) : la ligne l 
+  a pour coordonnee (l / div) % n dans cette direction.
+  acc = 0 : R := F[-d] op F op F[+d]
+  acc = 1 : R := R op F[-d] op F[+d]
+*/
+{
+  int32_t l, c;
+  uint8_t *f, *r, *p, *s, *m;
+#ifdef _OPENMP
+#pragma omp parallel for private(c, f, r, p, s, m)
+#endif
+  for (l = 0; l < nl; l++)
+  {
+    f = F + (size_t)l * rs; r = R + (size_t)l * rs;
+    c = (l / div) % n;
+    p = (c > 0) ? f - d : NULL;
+    s = (c < n - 1) ? f + d : NULL;
+    m = acc ? r : f;
+    if (ero && ((p == NULL) || (s == NULL))) { memset(r, 0, rs); continue; }
+    if (p == NULL) p = m;
+    if (s == NULL) s = m;
+    mc_combine(p, s, m, r, rs, ero);
+  }
+} /* passe_d() */
+
+/* ==================================== */
+static int32_t morpho_croix(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds, int32_t ero)
+/* ==================================== */
+// gamma 4 (ds = 1) ou gamma 6
+{
+  passe_x(F, R, rs, cs*ds, ero);
+  passe_d(F, R, rs, cs*ds, rs, 1, cs, ero, 1);
+  if (ds > 1) passe_d(F, R, rs, cs*ds, rs*cs, cs, ds, ero, 1);
+  return 1;
+} /* morpho_croix() */
+
+/* ==================================== */
+static int32_t morpho_cube(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds, int32_t ero)
+/* ==================================== */
+// gamma 8 (ds = 1) ou gamma 26
+{
+  uint8_t *T = (uint8_t *)malloc(rs*cs*ds);
+  if (T == NULL) return 0;
+  if (ds > 1)
+  {
+    passe_x(F, R, rs, cs*ds, ero);
+    passe_d(R, T, rs, cs*ds, rs, 1, cs, ero, 0);
+    passe_d(T, R, rs, cs*ds, rs*cs, cs, ds, ero, 0);
+  }
+  else
+  {
+    passe_x(F, T, rs, cs, ero);
+    passe_d(T, R, rs, cs, rs, 1, cs, ero, 0);
+  }
+  free(T);
+  return 1;
+} /* morpho_cube() */
+
+/* ==================================== */
+static int32_t morpho_18(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds, int32_t ero)
+/* ==================================== */
+{
+  int32_t nl = cs*ds, ps = rs*cs;
+  uint8_t *T = (uint8_t *)malloc(ps*ds);
+  if (T == NULL) return 0;
+  passe_x(F, T, rs, nl, ero);                  // T := segment x
+  passe_d(T, R, rs, nl, rs, 1, cs, ero, 0);    // R := carre xy
+  passe_d(T, R, rs, nl, ps, cs, ds, ero, 1);   // R := R op carre xz
+  passe_d(F, T, rs, nl, rs, 1, cs, ero, 0);    // T := segment y
+  passe_d(T, R, rs, nl, ps, cs, ds, ero, 1);   // R := R op carre yz
+  free(T);
+  return 1;
+} /* morpho_18() */
+
+/* ==================================== */
+int32_t morpho_dil4(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  return morpho_croix(F, R, rs, cs, 1, 0);
+} /* morpho_dil4() */
+
+/* ==================================== */
+int32_t morpho_ero4(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  return morpho_croix(F, R, rs, cs, 1, 1);
+} /* morpho_ero4() */
+
+/* ==================================== */
+int32_t morpho_dil8(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  return morpho_cube(F, R, rs, cs, 1, 0);
+} /* morpho_dil8() */
+
+/* ==================================== */
+int32_t morpho_ero8(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  return morpho_cube(F, R, rs, cs, 1, 1);
+} /* morpho_ero8() */
+
+/* ==================================== */
+int32_t morpho_dil6(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  return morpho_croix(F, R, rs, cs, ds, 0);
+} /* morpho_dil6() */
+
+/* ==================================== */
+int32_t morpho_ero6(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  return morpho_croix(F, R, rs, cs, ds, 1);
+} /* morpho_ero6() */
+
+/* ==================================== */
+int32_t morpho_dil18(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  return morpho_18(F, R, rs, cs, ds, 0);
+} /* morpho_dil18() */
+
+/* ==================================== */
+int32_t morpho_ero18(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  return morpho_18(F, R, rs, cs, ds, 1);
+} /* morpho_ero18() */
+
+/* ==================================== */
+int32_t morpho_dil26(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  return morpho_cube(F, R, rs, cs, ds, 0);
+} /* morpho_dil26() */
+
+/* ==================================== */
+int32_t morpho_ero26(uint8_t *F, uint8_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  return morpho_cube(F, R, rs, cs, ds, 1);
+} /* morpho_ero26() */
+
+/* ==================================== */
+static void morpho_bits(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t huit, int32_t ero)
+/* ==================================== */
+// gamma 4 (huit = 0) ou 8 sur un plan de bits
+{
+  int32_t ws = (rs + 63) / 64 + 2, nm = ws - 2;
+  int32_t y, w;
+  uint64_t *c, *n, *s, *r, v;
+  uint64_t fin = (rs % 64) ? ((uint64_t)1 << (rs % 64)) - 1 : ~(uint64_t)0;
+#ifdef _OPENMP
+#pragma omp parallel for private(w, c, n, s, r, v)
+#endif
+  for (y = 0; y < cs; y++)
+  {
+    c = P + (y+1)*ws + 1; n = c - ws; s = c + ws;
+    r = R + (y+1)*ws + 1;
+    for (w = 0; w < nm; w++)
+    {
+      if (ero)
+      {
+	v = c[w] & n[w] & s[w] & MORPHO_E(c,w) & MORPHO_O(c,w);
+	if (huit) v &= MORPHO_E(n,w) & MORPHO_O(n,w) & MORPHO_E(s,w) & MORPHO_O(s,w);
+      }
+      else
+      {
+	v = c[w] | n[w] | s[w] | MORPHO_E(c,w) | MORPHO_O(c,w);
+	if (huit) v |= MORPHO_E(n,w) | MORPHO_O(n,w) | MORPHO_E(s,w) | MORPHO_O(s,w);
+      }
+      r[w] = v;
+    }
+    r[nm-1] &= fin;
+  }
+} /* morpho_bits() */
+
+/* ==================================== */
+void morpho_dil4b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  morpho_bits(P, R, rs, cs, 0, 0);
+} /* morpho_dil4b() */
+
+/* ==================================== */
+void morpho_ero4b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  morpho_bits(P, R, rs, cs, 0, 1);
+} /* morpho_ero4b() */
+
+/* ==================================== */
+void morpho_dil8b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  morpho_bits(P, R, rs, cs, 1, 0);
+} /* morpho_dil8b() */
+
+/* ==================================== */
+void morpho_ero8b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs)
+/* ==================================== */
+{
+  morpho_bits(P, R, rs, cs, 1, 1);
+} /* morpho_ero8b() */
+
+/* ==================================== */
+static void morpho_bits3d(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds, 
+			  int32_t lim, int32_t ero)
+/* ==================================== */
+// gamma 6 (lim = 1), 18 (lim = 2) ou 26 (lim = 3) sur un volume de bits : 
+// le voisin (dx,dy,dz) est retenu s'il a au plus lim coordonnees non nulles
+{
+  int32_t ws = (rs + 63) / 64 + 2, nm = ws - 2, pw = (cs + 2) * ws;
+  int32_t l, w, k, nr = 0, dy, dz, off[9], eo[9];
+  uint64_t *c, *q, *r, u, v;
+  uint64_t fin = (rs % 64) ? ((uint64_t)1 << (rs % 64)) - 1 : ~(uint64_t)0;
+
+  for (dz = -1; dz <= 1; dz++)            // lignes retenues, et leurs voisins en x
+    for (dy = -1; dy <= 1; dy++)
+    {
+      k = (dy != 0) + (dz != 0);
+      if (k > lim) continue;
+      off[nr] = dz * pw + dy * ws;
+      eo[nr] = (k < lim);
+      nr++;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for private(w, k, c, q, r, u, v)
+#endif
+  for (l = 0; l < cs * ds; l++)
+  {
+    c = P + ((l / cs + 1) * (cs + 2) + (l % cs) + 1) * ws + 1;
+    r = R + (c - P);
+    for (w = 0; w < nm; w++)
+    {
+      v = ero ? ~(uint64_t)0 : 0;
+      for (k = 0; k < nr; k++)
+      {
+	q = c + off[k];
+	u = q[w];
+	if (eo[k]) u = ero ? (u & MORPHO_E(q,w) & MORPHO_O(q,w)) : (u | MORPHO_E(q,w) | MORPHO_O(q,w));
+	v = ero ? (v & u) : (v | u);
+      }
+      r[w] = v;
+    }
+    r[nm-1] &= fin;
+  }
+} /* morpho_bits3d() */
+
+/* ==================================== */
+void morpho_dil6b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  morpho_bits3d(P, R, rs, cs, ds, 1, 0);
+} /* morpho_dil6b() */
+
+/* ==================================== */
+void morpho_ero6b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  morpho_bits3d(P, R, rs, cs, ds, 1, 1);
+} /* morpho_ero6b() */
+
+/* ==================================== */
+void morpho_dil18b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  morpho_bits3d(P, R, rs, cs, ds, 2, 0);
+} /* morpho_dil18b() */
+
+/* ==================================== */
+void morpho_ero18b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  morpho_bits3d(P, R, rs, cs, ds, 2, 1);
+} /* morpho_ero18b() */
+
+/* ==================================== */
+void morpho_dil26b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  morpho_bits3d(P, R, rs, cs, ds, 3, 0);
+} /* morpho_dil26b() */
+
+/* ==================================== */
+void morpho_ero26b(uint64_t *P, uint64_t *R, int32_t rs, int32_t cs, int32_t ds)
+/* ==================================== */
+{
+  morpho_bits3d(P, R, rs, cs, ds, 3, 1);
+} /* morpho_ero26b() */
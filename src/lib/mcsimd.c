@@ -0,0 +1,456 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Noyaux vectoriels choisis a l'execution
+
+   Un meme executable tourne sur des machines de jeux d'instructions 
+   differents : chaque noyau est compile en plusieurs versions (attribut 
+   target de gcc, sans option -m a la compilation) et la meilleure version 
+   disponible est choisie au chargement du programme, d'apres CPUID 
+   (__builtin_cpu_supports). Les noyaux sont appeles par des pointeurs 
+   de fonction (mc_non_nuls64, ...), initialises a la version portable.
+
+   Versions : portable (mots de 64 bits, vectorisee par le compilateur 
+   selon la cible, NEON sur ARM64), SSE2, AVX2, AVX-512 (BW).
+   La variable d'environnement MC_ISA (portable, sse2, avx2, avx512) 
+   limite le choix, pour les mesures et les tests.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MC_SIMD_X86
+#include <immintrin.h>
+#endif
+#include <mcsimd.h>
+
+/* ==================================== */
+/* versions portables                   */
+/* ==================================== */
+
+/* ==================================== */
+static uint64_t non_nuls64_port(uint8_t *R, int32_t n)
+/* ==================================== */
+{
+  uint64_t b = 0, w;
+  int32_t k;
+  for (k = 0; k + 8 <= n; k += 8)
+  {
+    memcpy(&w, R + k, 8);
+    w = (w & 0x0f0f0f0f0f0f0f0fULL) | ((w >> 4) & 0x0f0f0f0f0f0f0f0fULL);
+    w = (w | (w >> 2)) & 0x0303030303030303ULL;
+    w = (w | (w >> 1)) & 0x0101010101010101ULL;
+    b |= ((w * 0x0102040810204080ULL) >> 56) << k; // octet l -> bit l
+  }
+  for (; k < n; k++)
+    if (R[k]) b |= 1ULL << k;
+  return b;
+} /* non_nuls64_port() */
+
+/* ==================================== */
+static void combine_port(uint8_t *a, uint8_t *b, uint8_t *c, uint8_t *r, int32_t n, int32_t et)
+/* ==================================== */
+{
+  int32_t x;
+  uint64_t u, v, w;
+  for (x = 0; x + 8 <= n; x += 8)
+  {
+    memcpy(&u, a+x, 8); memcpy(&v, b+x, 8); memcpy(&w, c+x, 8);
+    u = et ? (u & v & w) : (u | v | w); memcpy(r+x, &u, 8);
+  }
+  for (; x < n; x++) r[x] = et ? (a[x] & b[x] & c[x]) : (a[x] | b[x] | c[x]);
+} /* combine_port() */
+
+/* ==================================== */
+static int32_t retire_port(uint8_t *S, int32_t n, uint8_t masque, uint8_t valeur, uint8_t reste)
+/* ==================================== */
+{
+  int32_t i, ret = 0;
+  for (i = 0; i < n; i++)
+    if (S[i])
+    {
+      if ((S[i] & masque) == valeur) { S[i] = 0; ret = 1; }
+      else S[i] = reste;
+    }
+  return ret;
+} /* retire_port() */
+
+/* ==================================== */
+static void echange16_port(uint16_t *T, int32_t n)
+/* ==================================== */
+{
+  int32_t i;
+  for (i = 0; i < n; i++) T[i] = (uint16_t)((T[i] >> 8) | (T[i] << 8));
+} /* echange16_port() */
+
+#ifdef MC_SIMD_X86
+/* ==================================== */
+/* versions SSE2                        */
+/* ==================================== */
+
+/* ==================================== */
+__attribute__((target("sse2")))
+static uint64_t non_nuls64_sse2(uint8_t *R, int32_t n)
+/* ==================================== */
+// la fin est lue par un dernier bloc qui chevauche le precedent
+{
+  uint64_t b = 0;
+  int32_t k;
+  if (n < 16) return non_nuls64_port(R, n);
+  for (k = 0; k + 16 <= n; k += 16)
+    b |= (uint64_t)(~_mm_movemask_epi8(
+           _mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)(R + k)), _mm_setzero_si128())) & 0xffff) << k;
+  if (k < n)
+    b |= (uint64_t)(~_mm_movemask_epi8(
+           _mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)(R + n - 16)), _mm_setzero_si128())) & 0xffff) << (n - 16);
+  return b;
+} /* non_nuls64_sse2() */
+
+/* ==================================== */
+__attribute__((target("sse2")))
+static void combine_sse2(uint8_t *a, uint8_t *b, uint8_t *c, uint8_t *r, int32_t n, int32_t et)
+/* ==================================== */
+{
+  int32_t x;
+  __m128i u, v, w;
+  for (x = 0; x + 16 <= n; x += 16)
+  {
+    u = _mm_loadu_si128((__m128i *)(a + x));
+    v = _mm_loadu_si128((__m128i *)(b + x));
+    w = _mm_loadu_si128((__m128i *)(c + x));
+    u = et ? _mm_and_si128(_mm_and_si128(u, v), w) : _mm_or_si128(_mm_or_si128(u, v), w);
+    _mm_storeu_si128((__m128i *)(r + x), u);
+  }
+  combine_port(a + x, b + x, c + x, r + x, n - x, et);
+} /* combine_sse2() */
+
+/* ==================================== */
+__attribute__((target("sse2")))
+static int32_t retire_sse2(uint8_t *S, int32_t n, uint8_t masque, uint8_t valeur, uint8_t reste)
+/* ==================================== */
+{
+  int32_t i;
+  __m128i s, z, h, t = _mm_setzero_si128();
+  const __m128i m = _mm_set1_epi8((char)masque), v = _mm_set1_epi8((char)valeur);
+  const __m128i r = _mm_set1_epi8((char)reste), zero = _mm_setzero_si128();
+  for (i = 0; i + 16 <= n; i += 16)
+  {
+    s = _mm_loadu_si128((__m128i *)(S + i));
+    z = _mm_cmpeq_epi8(s, zero);
+    h = _mm_andnot_si128(z, _mm_cmpeq_epi8(_mm_and_si128(s, m), v)); // retires
+    t = _mm_or_si128(t, h);
+    _mm_storeu_si128((__m128i *)(S + i), _mm_andnot_si128(_mm_or_si128(z, h), r));
+  }
+  return retire_port(S + i, n - i, masque, valeur, reste) | (_mm_movemask_epi8(t) != 0);
+} /* retire_sse2() */
+
+/* ==================================== */
+__attribute__((target("sse2")))
+static void echange16_sse2(uint16_t *T, int32_t n)
+/* ==================================== */
+{
+  int32_t i;
+  __m128i u;
+  for (i = 0; i + 8 <= n; i += 8)
+  {
+    u = _mm_loadu_si128((__m128i *)(T + i));
+    _mm_storeu_si128((__m128i *)(T + i), _mm_or_si128(_mm_slli_epi16(u, 8), _mm_srli_epi16(u, 8)));
+  }
+  echange16_port(T + i, n - i);
+} /* echange16_sse2() */
+
+/* ==================================== */
+/* versions AVX2                        */
+/* ==================================== */
+/* 
+   les fins de tableau sont traitees sur place : appeler une version SSE2
+   (codage non VEX) avec les registres ymm entames couterait une transition
+   AVX/SSE a chaque appel
+*/
+
+/* ==================================== */
+__attribute__((target("avx2")))
+static uint64_t non_nuls64_avx2(uint8_t *R, int32_t n)
+/* ==================================== */
+// la fin est lue par un dernier bloc qui chevauche le precedent
+{
+  uint64_t b = 0, w;
+  int32_t k;
+  if (n < 16)
+  {
+    for (k = 0; k + 8 <= n; k += 8)
+    {
+      memcpy(&w, R + k, 8);
+      w = (w & 0x0f0f0f0f0f0f0f0fULL) | ((w >> 4) & 0x0f0f0f0f0f0f0f0fULL);
+      w = (w | (w >> 2)) & 0x0303030303030303ULL;
+      w = (w | (w >> 1)) & 0x0101010101010101ULL;
+      b |= ((w * 0x0102040810204080ULL) >> 56) << k;
+    }
+    for (; k < n; k++)
+      if (R[k]) b |= 1ULL << k;
+    return b;
+  }
+  if (n < 32)
+    return (uint64_t)(~_mm_movemask_epi8(
+              _mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)R), _mm_setzero_si128())) & 0xffff) |
+           (uint64_t)(~_mm_movemask_epi8(
+              _mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)(R + n - 16)), _mm_setzero_si128())) & 0xffff) << (n - 16);
+  for (k = 0; k + 32 <= n; k += 32)
+    b |= (uint64_t)(uint32_t)~_mm256_movemask_epi8(
+           _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i *)(R + k)), _mm256_setzero_si256())) << k;
+  if (k < n)
+    b |= (uint64_t)(uint32_t)~_mm256_movemask_epi8(
+           _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i *)(R + n - 32)), _mm256_setzero_si256())) << (n - 32);
+  return b;
+} /* non_nuls64_avx2() */
+
+/* ==================================== */
+__attribute__((target("avx2")))
+static void combine_avx2(uint8_t *a, uint8_t *b, uint8_t *c, uint8_t *r, int32_t n, int32_t et)
+/* ==================================== */
+{
+  int32_t x;
+  __m256i u, v, w;
+  for (x = 0; x + 32 <= n; x += 32)
+  {
+    u = _mm256_loadu_si256((__m256i *)(a + x));
+    v = _mm256_loadu_si256((__m256i *)(b + x));
+    w = _mm256_loadu_si256((__m256i *)(c + x));
+    u = et ? _mm256_and_si256(_mm256_and_si256(u, v), w) : _mm256_or_si256(_mm256_or_si256(u, v), w);
+    _mm256_storeu_si256((__m256i *)(r + x), u);
+  }
+  for (; x < n; x++) r[x] = et ? (a[x] & b[x] & c[x]) : (a[x] | b[x] | c[x]);
+} /* combine_avx2() */
+
+/* ==================================== */
+__attribute__((target("avx2")))
+static int32_t retire_avx2(uint8_t *S, int32_t n, uint8_t masque, uint8_t valeur, uint8_t reste)
+/* ==================================== */
+{
+  int32_t i, ret;
+  __m256i s, z, h, t = _mm256_setzero_si256();
+  const __m256i m = _mm256_set1_epi8((char)masque), v = _mm256_set1_epi8((char)valeur);
+  const __m256i r = _mm256_set1_epi8((char)reste), zero = _mm256_setzero_si256();
+  for (i = 0; i + 32 <= n; i += 32)
+  {
+    s = _mm256_loadu_si256((__m256i *)(S + i));
+    z = _mm256_cmpeq_epi8(s, zero);
+    h = _mm256_andnot_si256(z, _mm256_cmpeq_epi8(_mm256_and_si256(s, m), v)); // retires
+    t = _mm256_or_si256(t, h);
+    _mm256_storeu_si256((__m256i *)(S + i), _mm256_andnot_si256(_mm256_or_si256(z, h), r));
+  }
+  for (ret = (_mm256_movemask_epi8(t) != 0); i < n; i++)
+    if (S[i])
+    {
+      if ((S[i] & masque) == valeur) { S[i] = 0; ret = 1; }
+      else S[i] = reste;
+    }
+  return ret;
+} /* retire_avx2() */
+
+/* ==================================== */
+__attribute__((target("avx2")))
+static void echange16_avx2(uint16_t *T, int32_t n)
+/* ==================================== */
+{
+  int32_t i;
+  __m256i u;
+  for (i = 0; i + 16 <= n; i += 16)
+  {
+    u = _mm256_loadu_si256((__m256i *)(T + i));
+    _mm256_storeu_si256((__m256i *)(T + i), _mm256_or_si256(_mm256_slli_epi16(u, 8), _mm256_srli_epi16(u, 8)));
+  }
+  for (; i < n; i++) T[i] = (uint16_t)((T[i] >> 8) | (T[i] << 8));
+} /* echange16_avx2() */
+
+/* ==================================== */
+/* versions AVX-512 (F et BW)           */
+/* ==================================== */
+/* les fins de tableau sont traitees par des acces masques */
+
+#define MASQUE64(n) (((n) >= 64) ? ~0ULL : ((1ULL << (n)) - 1))
+
+/* ==================================== */
+__attribute__((target("avx512f,avx512bw")))
+static uint64_t non_nuls64_avx512(uint8_t *R, int32_t n)
+/* ==================================== */
+{
+  __m512i u = _mm512_maskz_loadu_epi8((__mmask64)MASQUE64(n), R);
+  return (uint64_t)_mm512_test_epi8_mask(u, u);
+} /* non_nuls64_avx512() */
+
+/* ==================================== */
+__attribute__((target("avx512f,avx512bw")))
+static void combine_avx512(uint8_t *a, uint8_t *b, uint8_t *c, uint8_t *r, int32_t n, int32_t et)
+/* ==================================== */
+{
+  int32_t x;
+  __mmask64 k;
+  __m512i u, v, w;
+  for (x = 0; x < n; x += 64)
+  {
+    k = (__mmask64)MASQUE64(n - x);
+    u = _mm512_maskz_loadu_epi8(k, a + x);
+    v = _mm512_maskz_loadu_epi8(k, b + x);
+    w = _mm512_maskz_loadu_epi8(k, c + x);
+    // table de verite : 0x80 = u et v et w, 0xfe = u ou v ou w
+    u = et ? _mm512_ternarylogic_epi32(u, v, w, 0x80) : _mm512_ternarylogic_epi32(u, v, w, 0xfe);
+    _mm512_mask_storeu_epi8(r + x, k, u);
+  }
+} /* combine_avx512() */
+
+/* ==================================== */
+__attribute__((target("avx512f,avx512bw")))
+static int32_t retire_avx512(uint8_t *S, int32_t n, uint8_t masque, uint8_t valeur, uint8_t reste)
+/* ==================================== */
+{
+  int32_t i;
+  __mmask64 k, nz, h, t = 0;
+  __m512i s;
+  const __m512i m = _mm512_set1_epi8((char)masque), v = _mm512_set1_epi8((char)valeur);
+  const __m512i r = _mm512_set1_epi8((char)reste);
+  for (i = 0; i < n; i += 64)
+  {
+    k = (__mmask64)MASQUE64(n - i);
+    s = _mm512_maskz_loadu_epi8(k, S + i);
+    nz = _mm512_test_epi8_mask(s, s);
+    h = nz & _mm512_cmpeq_epi8_mask(_mm512_and_si512(s, m), v); // retires
+    t |= h;
+    _mm512_mask_storeu_epi8(S + i, k, _mm512_maskz_mov_epi8(nz & ~h, r));
+  }
+  return t != 0;
+} /* retire_avx512() */
+
+/* ==================================== */
+__attribute__((target("avx512f,avx512bw")))
+static void echange16_avx512(uint16_t *T, int32_t n)
+/* ==================================== */
+{
+  int32_t i;
+  __mmask32 k;
+  __m512i u;
+  for (i = 0; i < n; i += 32)
+  {
+    k = (__mmask32)(((n - i) >= 32) ? 0xffffffffU : ((1U << (n - i)) - 1));
+    u = _mm512_maskz_loadu_epi16(k, T + i);
+    _mm512_mask_storeu_epi16(T + i, k, _mm512_or_si512(_mm512_slli_epi16(u, 8), _mm512_srli_epi16(u, 8)));
+  }
+} /* echange16_avx512() */
+#endif /* MC_SIMD_X86 */
+
+/* ==================================== */
+/* choix des versions                   */
+/* ==================================== */
+
+int32_t mc_isa = MC_ISA_PORTABLE;
+uint64_t (*mc_non_nuls64)(uint8_t *R, int32_t n) = non_nuls64_port;
+void (*mc_combine)(uint8_t *a, uint8_t *b, uint8_t *c, uint8_t *r, int32_t n, int32_t et) = combine_port;
+int32_t (*mc_retire)(uint8_t *S, int32_t n, uint8_t masque, uint8_t valeur, uint8_t reste) = retire_port;
+void (*mc_echange16)(uint16_t *T, int32_t n) = echange16_port;
+
+static const char *mc_isa_noms[] = { "portable", "sse2", "avx2", "avx512" };
+
+/* ==================================== */
+const char *mc_isa_nom(int32_t isa)
+/* ==================================== */
+{
+  if ((isa < MC_ISA_PORTABLE) || (isa > MC_ISA_AVX512)) return "?";
+  return mc_isa_noms[isa];
+} /* mc_isa_nom() */
+
+/* ==================================== */
+int32_t mc_isa_choix(int32_t isa)
+/* ==================================== */
+/*
+  Installe les versions du jeu d'instructions isa, ou du meilleur jeu 
+  disponible s'il n'est pas supporte par le processeur. Retourne le jeu
+  retenu.
+*/
+{
+  int32_t max = MC_ISA_PORTABLE;
+#ifdef MC_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) max = MC_ISA_SSE2;
+  if (__builtin_cpu_supports("avx2")) max = MC_ISA_AVX2;
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) max = MC_ISA_AVX512;
+#endif
+  if ((isa < MC_ISA_PORTABLE) || (isa > max)) isa = max;
+  mc_non_nuls64 = non_nuls64_port;
+  mc_combine = combine_port;
+  mc_retire = retire_port;
+  mc_echange16 = echange16_port;
+#ifdef MC_SIMD_X86
+  switch (isa)
+  {
+    case MC_ISA_SSE2:
+      mc_non_nuls64 = non_nuls64_sse2;
+      mc_combine = combine_sse2;
+      mc_retire = retire_sse2;
+      mc_echange16 = echange16_sse2;
+      break;
+    case MC_ISA_AVX2:
+      mc_non_nuls64 = non_nuls64_avx2;
+      mc_combine = combine_avx2;
+      mc_retire = retire_avx2;
+      mc_echange16 = echange16_avx2;
+      break;
+    case MC_ISA_AVX512:
+      mc_non_nuls64 = non_nuls64_avx512;
+      mc_combine = combine_avx512;
+      mc_retire = retire_avx512;
+      mc_echange16 = echange16_avx512;
+      break;
+  }
+#endif
+  mc_isa = isa;
+  return isa;
+} /* mc_isa_choix() */
+
+/* ==================================== */
+#ifdef __GNUC__
+__attribute__((constructor))
+#endif
+static void mc_isa_init()
+/* ==================================== */
+// au chargement : meilleur jeu disponible, limite par MC_ISA
+{
+  char *e = getenv("MC_ISA");
+  int32_t isa;
+  for (isa = MC_ISA_AVX512; (e != NULL) && (isa > MC_ISA_PORTABLE); isa--)
+    if (strcmp(e, mc_isa_noms[isa]) == 0) break;
+  mc_isa_choix((e != NULL) ? isa : MC_ISA_AVX512);
+} /* mc_isa_init() */
@@ -0,0 +1,200 @@
+/*
+Copyright ESIEE (2009) 
+
+m.couprie@esiee.fr
+
+This software is an image processing library whose purpose is to be
+used primarily for research and teaching.
+
+This software is governed by the CeCILL  license under French law and
+abiding by the rules of distribution of free software. You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+*/
+/* 
+   Librairie mctable :
+
+   tables de precalcul partagees entre processus
+
+   Les tables de 2^26 entrees des predicats topologiques 3D (lskelpar3d, 
+   mctopo3d) sont remplies a la demande : une entree nulle n'est pas encore
+   calculee, et chaque processus recalcule les configurations qu'il 
+   rencontre. Si la variable d'environnement MC_TABLES designe un 
+   repertoire, chaque table y est projetee en memoire (mmap partage) depuis
+   un fichier : les entrees calculees par un processus servent a tous les
+   suivants. L'ouverture ne coute que quelques appels systeme, les pages 
+   sont lues a la demande depuis le cache du systeme ; sans MC_TABLES, 
+   rien ne change.
+
+   Format : un en-tete binaire de TAILLE_ENTETE octets (marque MCTABLE1, 
+   boutisme, taille de la table, signature) suivi de la table. 
+   La signature est fournie par l'appelant : ce sont les entrees calculees 
+   pour les configurations de reference table_ref27. Un fichier dont 
+   l'en-tete ou la taille ne correspond pas (autre version des predicats, 
+   autre boutisme, fichier tronque) est reconstruit : une table vide est 
+   creee sous un nom temporaire puis renommee, les processus qui projettent 
+   encore l'ancien fichier n'en sont pas affectes. Les fichiers sont crees 
+   en mode 0644 (moins le umask). Chaque entree est ecrite en une seule 
+   fois, complete, par des acces atomiques : un processus interrompu ne 
+   laisse pas d'entree partielle. Le corps de la table n'a pas de somme de 
+   controle : il est complete sans cesse, entree par entree, par tous les 
+   processus qui le projettent, et une somme ne pourrait etre tenue a jour 
+   qu'en serialisant toutes les ecritures.
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef UNIXIO
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#endif
+#include <mctable.h>
+
+#define TAILLE_ENTETE 4096             /* la table commence sur une page */
+#define SIGNATURE_MAX 64
+
+typedef struct {
+  char marque[8];                      /* "MCTABLE1" */
+  uint32_t boutisme;                   /* 0x01020304 */
+  uint32_t lsig;                       /* octets utiles de signature */
+  uint64_t taille;                     /* taille de la table (octets) */
+  uint8_t signature[SIGNATURE_MAX];
+} entete_table;
+
+/* configurations (masques 27 bits, point central inclus) de reference */
+const uint32_t table_ref27[TABLE_NREF] = {
+  0x0002000, 0x7ffffff, 0x0417410, 0x003fe00, 0x2492492, 0x0007000, 0x0402010, 0x0006000,
+  0x4002001, 0x5a5a5a5, 0x2c3b4a1, 0x1f0f3c7, 0x7e03f80, 0x0a5e3e9, 0x6db6db6, 0x124a124
+};
+
+#ifdef UNIXIO
+/* ==================================== */
+static int32_t table_ecrit(int fd, entete_table *e, size_t taille)
+/* ==================================== */
+// ecrit l'en-tete e et etend le fichier a la taille de la table (vide)
+{
+  return (pwrite(fd, e, sizeof(*e), 0) == sizeof(*e)) && 
+         (ftruncate(fd, TAILLE_ENTETE + taille) == 0);
+} /* table_ecrit() */
+
+/* ==================================== */
+static int32_t table_reconstruit(char *chemin, entete_table *e, size_t taille)
+/* ==================================== */
+// remplace le fichier chemin par une table vide
+{
+  char *tmp = (char *)malloc(strlen(chemin) + 24);
+  int fd, ok;
+
+  if (tmp == NULL) return 0;
+  sprintf(tmp, "%s.%ld", chemin, (long)getpid());
+  unlink(tmp);
+  fd = open(tmp, O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) { free(tmp); return 0; }
+  ok = table_ecrit(fd, e, taille) && (rename(tmp, chemin) == 0);
+  close(fd);
+  if (!ok) unlink(tmp);
+  free(tmp);
+  return ok;
+} /* table_reconstruit() */
+#endif
+
+/* ==================================== */
+void *table_projette(char *nom, size_t taille, uint8_t *signature, int32_t lsig)
+/* ==================================== */
+// retourne la table nom de MC_TABLES, creee si besoin, ou NULL (pas de cache)
+#undef F_NAME
+#define F_NAME "table_projette"
+{
+#ifdef UNIXIO
+  char *rep = getenv("MC_TABLES"), *chemin;
+  entete_table e, f;
+  struct stat st, sc;
+  int fd = -1, ok = 0, essai;
+  void *t;
+
+  if ((rep == NULL) || (lsig > SIGNATURE_MAX)) return NULL;
+  memset(&e, 0, sizeof(e));
+  memcpy(e.marque, "MCTABLE1", 8);
+  e.boutisme = 0x01020304;
+  e.lsig = (uint32_t)lsig;
+  e.taille = (uint64_t)taille;
+  memcpy(e.signature, signature, lsig);
+
+  chemin = (char *)malloc(strlen(rep) + strlen(nom) + 2);
+  if (chemin == NULL) return NULL;
+  sprintf(chemin, "%s/%s", rep, nom);
+
+  for (essai = 0; (essai < 3) && !ok; essai++)
+  {
+    fd = open(chemin, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+      fprintf(stderr, "%s: cannot open %s\n", F_NAME, chemin);
+      free(chemin);
+      return NULL;
+    }
+    flock(fd, LOCK_EX); // un seul processus cree ou reconstruit la table
+    if ((fstat(fd, &st) != 0) || (stat(chemin, &sc) != 0) || 
+        (st.st_ino != sc.st_ino) || (st.st_dev != sc.st_dev))
+      ; // fichier remplace pendant l'attente du verrou : on le rouvre
+    else if (st.st_size == 0)
+    {
+      ok = table_ecrit(fd, &e, taille);
+      if (!ok && (ftruncate(fd, 0) != 0)) 
+        fprintf(stderr, "%s: cannot reset %s\n", F_NAME, chemin);
+    }
+    else if ((st.st_size == (off_t)(TAILLE_ENTETE + taille)) &&
+             (pread(fd, &f, sizeof(f), 0) == sizeof(f)) && 
+             (memcmp(&e, &f, sizeof(e)) == 0))
+      ok = 1;
+    else 
+    {
+      fprintf(stderr, "%s: %s: incompatible or corrupted table, rebuilt\n", F_NAME, chemin);
+      if (!table_reconstruit(chemin, &e, taille)) essai = 3;
+    }
+    flock(fd, LOCK_UN);
+    if (!ok) { close(fd); fd = -1; }
+  }
+  if (!ok)
+  {
+    fprintf(stderr, "%s: cannot create %s, ignored\n", F_NAME, chemin);
+    free(chemin);
+    return NULL;
+  }
+
+  t = mmap(NULL, TAILLE_ENTETE + taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  free(chemin);
+  if (t == MAP_FAILED) return NULL;
+  return (uint8_t *)t + TAILLE_ENTETE;
+#else
+  return NULL;
+#endif
+} /* table_projette() */
@@ -2988,6 +2988,31 @@ int32_t simple8(                   /* pour un objet en 8-connexite */
         return (t == 1) && (tb == 1);
 } /* simple8() */
 
+/* ==================================== */
+int32_t simple8_nb(                /* pour un objet en 8-connexite */
+  uint8_t *img,          /* pointeur base image */
+  int32_t p,                       /* index du point */
+  int32_t rs)                      /* taille rangee */
+/* ==================================== */
+/*
+  version rapide de simple8 : p ne doit pas etre un point de bord
+  (aucun test n'est fait).
+*/
+{
+	register uint8_t * ptr = img+p;
+	register int32_t v;
+
+	if ( *(ptr+1)   ) v=1; else v=0;
+ 	if ( *(ptr+1-rs)) v|=2;
+ 	if ( *(ptr-rs)  ) v|=4;
+ 	if ( *(ptr-rs-1)) v|=8;
+ 	if ( *(ptr-1)   ) v|=16;
+ 	if ( *(ptr-1+rs)) v|=32;
+ 	if ( *(ptr+rs)  ) v|=64;
+ 	if ( *(ptr+rs+1)) v|=128;
+        return (TopoTab[v][1] == 1) && (TopoTab[v][0] == 1);
+} /* simple8_nb() */
+
 /* ==================================== */
 int32_t simple4(                   /* pour un objet en 4-connexite */
   uint8_t *img,          /* pointeur base image */
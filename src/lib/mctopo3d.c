@@ -54,9 +54,14 @@ Update nov. 2006 : modif geodesic_neighborhood pour compatibilit
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <mclifo.h>
 #include <mcutil.h>
 #include <mccodimage.h>
+#include <mctable.h>
 #include <mctopo3d.h>
 
 /* globales privees */
@@ -64,6 +69,11 @@ static Lifo * LIFO_topo3d1 = NULL;
 static Lifo * LIFO_topo3d2 = NULL;
 static voxel cube_topo3d[27];
 static voxel cubec_topo3d[27];
+#ifdef _OPENMP
+/* un jeu de cubes et de listes par thread : init_topo3d et termine_topo3d
+   doivent alors etre appeles dans chaque thread */
+#pragma omp threadprivate(LIFO_topo3d1, LIFO_topo3d2, cube_topo3d, cubec_topo3d)
+#endif
   
 /* ========================================== */
 void init_topo3d()
@@ -305,17 +315,17 @@ uint8_t nbcomp(voxel * cube, uint8_t connex)
     {
       ncc++;
       p->lab2 = ncc;
-      LifoPush(LIFO_topo3d1, (int32_t)p);
+      LifoPush(LIFO_topo3d1, (int32_t)(p-cube));
       while (!LifoVide(LIFO_topo3d1))
       {
-        p = (pvoxel)LifoPop(LIFO_topo3d1);
+        p = cube + LifoPop(LIFO_topo3d1);
         for (v = 0; v < p->n6v; v++)
         {
           pp = p->v6[v];
           if ((pp->lab == 1) && (pp->lab2 == 0))
 	  {
             pp->lab2 = ncc;
-            LifoPush(LIFO_topo3d1, (int32_t)pp);
+            LifoPush(LIFO_topo3d1, (int32_t)(pp-cube));
 	  }
         } /* for v */
         if (connex > 6)
@@ -325,7 +335,7 @@ uint8_t nbcomp(voxel * cube, uint8_t connex)
             if ((pp->lab == 1) && (pp->lab2 == 0)) 
 	    {
               pp->lab2 = ncc;
-              LifoPush(LIFO_topo3d1, (int32_t)pp);
+              LifoPush(LIFO_topo3d1, (int32_t)(pp-cube));
 	    }
           } /* for v */
         if (connex > 18)
@@ -335,7 +345,7 @@ uint8_t nbcomp(voxel * cube, uint8_t connex)
             if ((pp->lab == 1) && (pp->lab2 == 0))
 	    {
               pp->lab2 = ncc;
-              LifoPush(LIFO_topo3d1, (int32_t)pp);
+              LifoPush(LIFO_topo3d1, (int32_t)(pp-cube));
 	    }
           } /* for v */
       } /* while (!LifoVide(LIFO_topo3d1)) */
@@ -902,6 +912,358 @@ int32_t simple26(                  /* pour un objet en 26-connexite */
   return ((T26(cube_topo3d) == 1) && (T6(cubec_topo3d) == 1));
 } /* simple26() */
 
+/* ==================================== */
+int32_t simple26_nb(               /* pour un objet en 26-connexite */
+  uint8_t *img,          /* pointeur base image */
+  int32_t p,                       /* index du point */
+  int32_t rs,                      /* taille rangee */
+  int32_t ps)                      /* taille plan */
+/* ==================================== */
+/*
+  version rapide de simple26 : p ne doit pas etre un point de bord
+  (aucun test n'est fait).
+*/
+#undef F_NAME
+#define F_NAME "simple26_nb"
+{
+  preparecubes(img, p, rs, ps, 0);
+  return ((T26(cube_topo3d) == 1) && (T6(cubec_topo3d) == 1));
+} /* simple26_nb() */
+
+/* ==================================== */
+static void preparecubes_mask(uint32_t m)
+/* ==================================== */
+// comme preparecubes, pour le masque 27 bits m (voir mask27 dans mccodimage)
+{
+  int32_t n;
+  for (n = 0; n < 27; n++, m >>= 1)
+  {
+    cube_topo3d[n].val = (uint8_t)(m & 1);
+    cubec_topo3d[n].val = (uint8_t)(1 - (m & 1));
+  }
+} /* preparecubes_mask() */
+
+/* ==================================== */
+int32_t simple26_mask(             /* pour un objet en 26-connexite */
+  uint32_t m)                      /* masque 27 bits du voisinage */
+/* ==================================== */
+/*
+  comme simple26_nb, le voisinage etant donne par son masque (mask27, 
+  colonnes27). Les points sans 6-voisin dans le fond (Tb = 0) et les points 
+  isoles (T = 0) sont rejetes sans calcul.
+*/
+{
+  if ((m & MASK27_V6) == MASK27_V6) return 0;
+  if ((m & ~MASK27_CENTRE) == 0) return 0;
+  preparecubes_mask(m);
+  return ((T26(cube_topo3d) == 1) && (T6(cubec_topo3d) == 1));
+} /* simple26_mask() */
+
+/* ==================================== */
+void top26_mask(                   /* pour un objet en 26-connexite */
+  uint32_t m,                      /* masque 27 bits du voisinage */
+  int32_t *t,
+  int32_t *tb)                     /* resultats */
+/* ==================================== */
+{
+  preparecubes_mask(m);
+  *t = T26(cube_topo3d);
+  *tb = T6(cubec_topo3d);
+} /* top26_mask() */
+
+/*
+  Les nombres topologiques d'un point pour une coupe h ne dependent que du 
+  masque 27 bits (voir mask27) des voisins de valeur >= h. Ce masque est 
+  obtenu par une seule comparaison vectorielle des 27 valeurs du voisinage 
+  (rangees dans un tableau par vois27) au seuil h (seuil27), et les nombres 
+  T6, T26, Tb6, Tb26 sont lus dans une table de 2^26 entrees indexee par les 
+  26 voisins, remplie a la demande. Chaque entree contient deux paires 
+  calculees separement, chacune avec son bit d'etat : (T26, Tb6) pour un 
+  objet 26-connexe (nbtopo26) et (T6, Tb26) pour un objet 6-connexe 
+  (nbtopo6). Chaque paire est ajoutee a l'entree par un ou atomique 
+  (OuAtomique), qui ne perd pas la paire ajoutee au meme moment par un 
+  autre thread. La table est projetee en memoire (mmap anonyme) au premier 
+  appel : les pages non touchees ne coutent rien. Si MC_TABLES est defini,
+  elle est projetee depuis le cache partage entre processus (mctable.c).
+  Si elle ne peut etre allouee, les nombres topologiques sont calcules 
+  sans table (avertissement unique).
+*/
+
+#define NBTOPO_26 0x8000               /* T26 et Tb6 sont calcules */
+#define NBTOPO_6  0x4000               /* T6 et Tb26 sont calcules */
+#define NBT26(c)  (((c) >> 10) & 15)   /* T26 de la coupe */
+#define NBT6(c)   (((c) >> 7) & 7)     /* T6 de la coupe */
+#define NBT26B(c) (((c) >> 3) & 15)    /* T26 du complementaire */
+#define NBT6B(c)  ((c) & 7)            /* T6 du complementaire */
+
+static uint16_t *tab_nbtopo = NULL;
+static int32_t nbtopo_echec = 0;       /* allocation impossible : pas de table */
+
+/* ==================================== */
+static uint16_t *nbtopo_alloue()
+/* ==================================== */
+// retourne la table, ou NULL si elle ne peut etre allouee
+{
+  if (LitAtomique(nbtopo_echec)) return NULL;
+#ifdef _OPENMP
+#pragma omp critical (tab_nbtopo)
+#endif
+  if ((tab_nbtopo == NULL) && !nbtopo_echec)
+  {
+    size_t taille = (size_t)(1 << 26) * sizeof(uint16_t);
+    uint16_t sig[TABLE_NREF];
+    int32_t k;
+    void *t;
+    for (k = 0; k < TABLE_NREF; k++) // signature : entrees completes de reference
+    {
+      preparecubes_mask(table_ref27[k]);
+      sig[k] = NBTOPO_26 | NBTOPO_6 | (T26(cube_topo3d) << 10) | (T6(cube_topo3d) << 7) |
+               (T26(cubec_topo3d) << 3) | T6(cubec_topo3d);
+    }
+    t = table_projette("nbtopo3d.tab", taille, (uint8_t *)sig, sizeof(sig));
+    if (t == NULL)
+    {
+      t = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (t == MAP_FAILED)
+      {
+        fprintf(stderr, "nbtopo_alloue: mmap failed, no table\n");
+        EcritAtomique(nbtopo_echec, 1);
+        t = NULL;
+      }
+#ifdef MADV_HUGEPAGE
+      else madvise(t, taille, MADV_HUGEPAGE); // acces aleatoires : moins de defauts de TLB
+#endif
+    }
+    if (t != NULL) Publie(tab_nbtopo, (uint16_t *)t);
+  }
+  return LitPublie(tab_nbtopo);
+} /* nbtopo_alloue() */
+
+/* ==================================== */
+static uint16_t nbtopo26(uint32_t m)
+/* ==================================== */
+// code (voir NBT26, NBT6B) de la coupe de masque 27 bits m, objet 26-connexe
+{
+  uint32_t k = ((m >> 14) << 13) | (m & 0x1fff);
+  uint16_t c, v, *t = LitPublie(tab_nbtopo);
+  if ((t == NULL) && ((t = nbtopo_alloue()) == NULL))
+  {
+    preparecubes_mask(m);
+    return NBTOPO_26 | (T26(cube_topo3d) << 10) | T6(cubec_topo3d);
+  }
+  c = LitAtomique(t[k]);
+  if (!(c & NBTOPO_26))
+  {
+    preparecubes_mask(m);
+    v = NBTOPO_26 | (T26(cube_topo3d) << 10) | T6(cubec_topo3d);
+    c = OuAtomique(t[k], v) | v;
+  }
+  return c;
+} /* nbtopo26() */
+
+/* ==================================== */
+static uint16_t nbtopo6(uint32_t m)
+/* ==================================== */
+// code (voir NBT6, NBT26B) de la coupe de masque 27 bits m, objet 6-connexe
+{
+  uint32_t k = ((m >> 14) << 13) | (m & 0x1fff);
+  uint16_t c, v, *t = LitPublie(tab_nbtopo);
+  if ((t == NULL) && ((t = nbtopo_alloue()) == NULL))
+  {
+    preparecubes_mask(m);
+    return NBTOPO_6 | (T6(cube_topo3d) << 7) | (T26(cubec_topo3d) << 3);
+  }
+  c = LitAtomique(t[k]);
+  if (!(c & NBTOPO_6))
+  {
+    preparecubes_mask(m);
+    v = NBTOPO_6 | (T6(cube_topo3d) << 7) | (T26(cubec_topo3d) << 3);
+    c = OuAtomique(t[k], v) | v;
+  }
+  return c;
+} /* nbtopo6() */
+
+/* ==================================== */
+void nbtopo_mask(
+  uint32_t m,                      /* masque 27 bits du voisinage (mask27) */
+  int32_t *t6,
+  int32_t *t26,
+  int32_t *t6b,
+  int32_t *t26b)                   /* resultats */
+/* ==================================== */
+{
+  uint16_t c = nbtopo26(m) | nbtopo6(m);
+  *t6 = NBT6(c);
+  *t26 = NBT26(c);
+  *t6b = NBT6B(c);
+  *t26b = NBT26B(c);
+} /* nbtopo_mask() */
+
+/* ==================================== */
+void vois27(
+  uint8_t *img,          /* pointeur base image */
+  int32_t p,                       /* index du point */
+  int32_t rs,                      /* taille rangee */
+  int32_t ps,                      /* taille plan */
+  uint8_t *v)                      /* resultat : 32 octets */
+/* ==================================== */
+/*
+  Range dans v[n] la valeur du voisin (x,y,z) de p, n = (x+1) + 3(y+1) + 9(z+1)
+  (ordre des bits de mask27). p ne doit pas etre un point de bord.
+*/
+{
+  int32_t y, z;
+  uint8_t *q = img + p - ps - rs - 1;
+  for (z = 0; z < 3; z++, q += ps - 3 * rs)
+    for (y = 0; y < 3; y++, q += rs, v += 3)
+    {
+      v[0] = q[0]; v[1] = q[1]; v[2] = q[2];
+    }
+  v[0] = v[1] = v[2] = v[3] = v[4] = 0;
+} /* vois27() */
+
+/* ==================================== */
+void vois27_s(
+  uint16_t *img,         /* pointeur base image */
+  int32_t p,                       /* index du point */
+  int32_t rs,                      /* taille rangee */
+  int32_t ps,                      /* taille plan */
+  uint16_t *v)                     /* resultat : 32 valeurs */
+/* ==================================== */
+// comme vois27, pour une image 16 bits
+{
+  int32_t y, z;
+  uint16_t *q = img + p - ps - rs - 1;
+  for (z = 0; z < 3; z++, q += ps - 3 * rs)
+    for (y = 0; y < 3; y++, q += rs, v += 3)
+    {
+      v[0] = q[0]; v[1] = q[1]; v[2] = q[2];
+    }
+  v[0] = v[1] = v[2] = v[3] = v[4] = 0;
+} /* vois27_s() */
+
+/* ==================================== */
+uint32_t seuil27(
+  uint8_t *v,                      /* voisinage (vois27) */
+  int32_t h)                       /* seuil */
+/* ==================================== */
+// masque 27 bits des valeurs v[n] >= h
+{
+  if (h <= 0) return MASK27_TOUS;
+  if (h > 255) return 0;
+#ifdef __SSE2__
+  {
+    __m128i t = _mm_set1_epi8((char)h);
+    __m128i a = _mm_loadu_si128((__m128i *)v);
+    __m128i b = _mm_loadu_si128((__m128i *)(v + 16));
+    a = _mm_cmpeq_epi8(_mm_max_epu8(a, t), a);
+    b = _mm_cmpeq_epi8(_mm_max_epu8(b, t), b);
+    return ((uint32_t)_mm_movemask_epi8(a) | ((uint32_t)_mm_movemask_epi8(b) << 16)) & MASK27_TOUS;
+  }
+#else
+  {
+    uint32_t m = 0;
+    int32_t n;
+    for (n = 0; n < 27; n++) if (v[n] >= h) m |= (1 << n);
+    return m;
+  }
+#endif
+} /* seuil27() */
+
+/* ==================================== */
+uint32_t seuil27_s(
+  uint16_t *v,                     /* voisinage (vois27_s) */
+  int32_t h)                       /* seuil */
+/* ==================================== */
+// masque 27 bits des valeurs v[n] >= h
+{
+  if (h <= 0) return MASK27_TOUS;
+  if (h > 65535) return 0;
+#ifdef __SSE2__
+  {
+    // comparaison non signee : on decale les deux operandes de 2^15
+    __m128i d = _mm_set1_epi16((int16_t)0x8000);
+    __m128i t = _mm_set1_epi16((int16_t)(h ^ 0x8000));
+    __m128i a = _mm_cmplt_epi16(_mm_xor_si128(_mm_loadu_si128((__m128i *)v), d), t);
+    __m128i b = _mm_cmplt_epi16(_mm_xor_si128(_mm_loadu_si128((__m128i *)(v + 8)), d), t);
+    __m128i c = _mm_cmplt_epi16(_mm_xor_si128(_mm_loadu_si128((__m128i *)(v + 16)), d), t);
+    __m128i e = _mm_cmplt_epi16(_mm_xor_si128(_mm_loadu_si128((__m128i *)(v + 24)), d), t);
+    uint32_t lt = (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(a, b)) | 
+                  ((uint32_t)_mm_movemask_epi8(_mm_packs_epi16(c, e)) << 16);
+    return ~lt & MASK27_TOUS;
+  }
+#else
+  {
+    uint32_t m = 0;
+    int32_t n;
+    for (n = 0; n < 27; n++) if (v[n] >= h) m |= (1 << n);
+    return m;
+  }
+#endif
+} /* seuil27_s() */
+
+/* ==================================== */
+uint32_t mask27h(
+  uint8_t *img,          /* pointeur base image */
+  int32_t p,                       /* index du point */
+  int32_t h,                       /* seuil */
+  int32_t rs,                      /* taille rangee */
+  int32_t ps)                      /* taille plan */
+/* ==================================== */
+/*
+  masque 27 bits du voisinage de p dans l'image seuillee au niveau h.
+  ATTENTION: p ne doit pas etre un point de bord (test a faire avant).
+*/
+{
+  uint8_t v[32];
+  vois27(img, p, rs, ps, v);
+  return seuil27(v, h);
+} /* mask27h() */
+
+/* ==================================== */
+uint32_t mask27h_l(
+  uint32_t *img,          /* pointeur base image */
+  int32_t p,                       /* index du point */
+  uint32_t h,                      /* seuil */
+  int32_t rs,                      /* taille rangee */
+  int32_t ps)                      /* taille plan */
+/* ==================================== */
+// comme mask27h, pour une image 32 bits
+{
+  uint32_t m = 0;
+  int32_t x, y, z, n = 0;
+  for (z = -ps; z <= ps; z += ps)
+    for (y = -rs; y <= rs; y += rs)
+      for (x = -1; x <= 1; x++, n++)
+        if (img[p + z + y + x] >= h) m |= (1 << n);
+  return m;
+} /* mask27h_l() */
+
+/* ==================================== */
+int32_t destr27(
+  uint32_t m,                      /* masque de la coupe (seuil27) */
+  int32_t connex)                  /* connexite des minima : 6 ou 26 */
+/* ==================================== */
+/*
+  Teste si le point est destructible pour la coupe de masque m : 
+  T26 = 1 et Tb6 = 1 (minima 6-connexes), T6 = 1 et Tb26 = 1 (minima 
+  26-connexes).
+*/
+{
+  uint16_t c;
+  if (connex == 6)
+  {
+    if ((m & MASK27_V6) == MASK27_V6) return 0;       /* Tb6 = 0 */
+    if ((m & ~MASK27_CENTRE) == 0) return 0;          /* T26 = 0 */
+    c = nbtopo26(m);
+    return (NBT26(c) == 1) && (NBT6B(c) == 1);
+  }
+  if ((m & MASK27_V6) == 0) return 0;                 /* T6 = 0 */
+  if ((m | MASK27_CENTRE) == MASK27_TOUS) return 0;   /* Tb26 = 0 */
+  c = nbtopo6(m);
+  return (NBT6(c) == 1) && (NBT26B(c) == 1);
+} /* destr27() */
+
 /* ==================================== */
 int32_t simple6h(                   /* pour un objet en 6-connexite */
   uint8_t *img,          /* pointeur base image */
@@ -914,12 +1276,13 @@ int32_t simple6h(                   /* pour un objet en 6-connexite */
 #undef F_NAME
 #define F_NAME "simple6h"
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, h, rs, ps, N);
-  return ((T6(cube_topo3d) == 1) && (T26(cubec_topo3d) == 1));
+  c = nbtopo6(mask27h(img, p, h, rs, ps));
+  return ((NBT6(c) == 1) && (NBT26B(c) == 1));
 } /* simple6h() */
 
 /* ==================================== */
@@ -954,12 +1317,13 @@ int32_t simple26h(                  /* pour un objet en 26-connexite */
 #undef F_NAME
 #define F_NAME "simple26h"
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, h, rs, ps, N);
-  return ((T26(cube_topo3d) == 1) && (T6(cubec_topo3d) == 1));
+  c = nbtopo26(mask27h(img, p, h, rs, ps));
+  return ((NBT26(c) == 1) && (NBT6B(c) == 1));
 } /* simple26h() */
 
 /* ==================================== */
@@ -972,12 +1336,13 @@ int32_t tbar6h(               /* pour un objet en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return -1;
-  preparecubesh(img, p, h, rs, ps, N);
-  return T26(cubec_topo3d);
+  c = nbtopo6(mask27h(img, p, h, rs, ps));
+  return NBT26B(c);
 } /* tbar6h() */
 
 /* ==================================== */
@@ -990,12 +1355,13 @@ int32_t tbar26h(              /* pour un objet en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return -1;
-  preparecubesh(img, p, h, rs, ps, N);
-  return T6(cubec_topo3d);
+  c = nbtopo26(mask27h(img, p, h, rs, ps));
+  return NBT6B(c);
 } /* tbar26h() */
 
 /* ========================================== */
@@ -1184,12 +1550,13 @@ int32_t pdestr6(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return ((T26(cube_topo3d) == 1) && (T6(cubec_topo3d) == 1));
+  c = nbtopo26(mask27h(img, p, img[p], rs, ps));
+  return ((NBT26(c) == 1) && (NBT6B(c) == 1));
 } /* pdestr6() */
 
 /* ==================================== */
@@ -1218,12 +1585,13 @@ int32_t pdestr26(                  /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return ((T6(cube_topo3d) == 1) && (T26(cubec_topo3d) == 1));
+  c = nbtopo6(mask27h(img, p, img[p], rs, ps));
+  return ((NBT6(c) == 1) && (NBT26B(c) == 1));
 } /* pdestr26() */
 
 /* ==================================== */
@@ -1235,12 +1603,13 @@ int32_t plevdestr6(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return (T6(cubec_topo3d) == 1);
+  c = nbtopo26(mask27h(img, p, img[p], rs, ps));
+  return (NBT6B(c) == 1);
 } /* plevdestr6() */
 
 /* ==================================== */
@@ -1269,12 +1638,13 @@ int32_t plevdestr26(                  /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return (T26(cubec_topo3d) == 1);
+  c = nbtopo6(mask27h(img, p, img[p], rs, ps));
+  return (NBT26B(c) == 1);
 } /* plevdestr26() */
 
 /* ==================================== */
@@ -1286,12 +1656,13 @@ int32_t pconstr6(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return ((T26(cube_topo3d) == 1) && (T6(cubec_topo3d) == 1));
+  c = nbtopo26(mask27h(img, p, img[p]+1, rs, ps));
+  return ((NBT26(c) == 1) && (NBT6B(c) == 1));
 } /* pconstr6() */
 
 /* ==================================== */
@@ -1320,12 +1691,13 @@ int32_t pconstr26(                  /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return ((T6(cube_topo3d) == 1) && (T26(cubec_topo3d) == 1));
+  c = nbtopo6(mask27h(img, p, img[p]+1, rs, ps));
+  return ((NBT6(c) == 1) && (NBT26B(c) == 1));
 } /* pconstr26() */
 
 /* ==================================== */
@@ -1337,12 +1709,13 @@ int32_t plevconstr6(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return (T26(cube_topo3d) == 1);
+  c = nbtopo26(mask27h(img, p, img[p]+1, rs, ps));
+  return (NBT26(c) == 1);
 } /* plevconstr6() */
 
 /* ==================================== */
@@ -1371,12 +1744,13 @@ int32_t plevconstr26(                  /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return (T6(cube_topo3d) == 1);
+  c = nbtopo6(mask27h(img, p, img[p]+1, rs, ps));
+  return (NBT6(c) == 1);
 } /* plevconstr26() */
 
 /* ==================================== */
@@ -1388,12 +1762,13 @@ int32_t peak6(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return (T26(cube_topo3d) == 0);
+  c = nbtopo26(mask27h(img, p, img[p], rs, ps));
+  return (NBT26(c) == 0);
 } /* peak6() */
 
 /* ==================================== */
@@ -1405,12 +1780,13 @@ int32_t peak26(                    /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return (T6(cube_topo3d) == 0);
+  c = nbtopo6(mask27h(img, p, img[p], rs, ps));
+  return (NBT6(c) == 0);
 } /* peak26() */
 
 /* ==================================== */
@@ -1422,12 +1798,13 @@ int32_t well6(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return (T6(cubec_topo3d) == 0);
+  c = nbtopo26(mask27h(img, p, img[p]+1, rs, ps));
+  return (NBT6B(c) == 0);
 } /* well6() */
 
 /* ==================================== */
@@ -1439,12 +1816,13 @@ int32_t well26(                    /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return (T26(cubec_topo3d) == 0);
+  c = nbtopo6(mask27h(img, p, img[p]+1, rs, ps));
+  return (NBT26B(c) == 0);
 } /* well26() */
 
 /* ==================================== */
@@ -1597,11 +1975,22 @@ uint8_t delta6m(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {	
-  uint8_t ret, sav = img[p];
-  while (pdestr6(img, p, rs, ps, N)) img[p] = alpha26m(img, p, rs, ps, N);
-  ret = img[p];
-  img[p] = sav;
-  return ret;
+  int32_t k, a, val = img[p];
+  uint8_t v[32];
+
+  if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
+      (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
+      (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
+    return img[p];
+  vois27(img, p, rs, ps, v);
+  while (destr27(seuil27(v, val), 6))
+  {
+    for (a = -1, k = 0; k < 27; k++) 
+      if ((k != 13) && (v[k] < val) && (v[k] > a)) a = v[k];
+    if (a < 0) break;
+    val = a;
+  }
+  return (uint8_t)val;
 } /* delta6m() */
 
 /* ==================================== */
@@ -1614,11 +2003,22 @@ uint8_t delta26m(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {	
-  uint8_t ret, sav = img[p];
-  while (pdestr26(img, p, rs, ps, N)) img[p] = alpha26m(img, p, rs, ps, N);
-  ret = img[p];
-  img[p] = sav;
-  return ret;
+  int32_t k, a, val = img[p];
+  uint8_t v[32];
+
+  if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
+      (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
+      (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
+    return img[p];
+  vois27(img, p, rs, ps, v);
+  while (destr27(seuil27(v, val), 26))
+  {
+    for (a = -1, k = 0; k < 27; k++) 
+      if ((k != 13) && (v[k] < val) && (v[k] > a)) a = v[k];
+    if (a < 0) break;
+    val = a;
+  }
+  return (uint8_t)val;
 } /* delta26m() */
 
 /* ==================================== */
@@ -1631,11 +2031,22 @@ uint8_t delta6p(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {	
-  uint8_t ret, sav = img[p];
-  while (pconstr6(img, p, rs, ps, N)) img[p] = alpha26p(img, p, rs, ps, N);
-  ret = img[p];
-  img[p] = sav;
-  return ret;
+  int32_t k, a, val = img[p];
+  uint8_t v[32];
+
+  if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
+      (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
+      (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
+    return img[p];
+  vois27(img, p, rs, ps, v);
+  while (destr27(seuil27(v, val + 1), 6))
+  {
+    for (a = NDG_MAX + 1, k = 0; k < 27; k++) 
+      if ((k != 13) && (v[k] > val) && (v[k] < a)) a = v[k];
+    if (a > NDG_MAX) break;
+    val = a;
+  }
+  return (uint8_t)val;
 } /* delta6p() */
 
 /* ==================================== */
@@ -1648,11 +2059,22 @@ uint8_t delta26p(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {	
-  uint8_t ret, sav = img[p];
-  while (pconstr26(img, p, rs, ps, N)) img[p] = alpha26p(img, p, rs, ps, N);
-  ret = img[p];
-  img[p] = sav;
-  return ret;
+  int32_t k, a, val = img[p];
+  uint8_t v[32];
+
+  if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
+      (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
+      (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
+    return img[p];
+  vois27(img, p, rs, ps, v);
+  while (destr27(seuil27(v, val + 1), 26))
+  {
+    for (a = NDG_MAX + 1, k = 0; k < 27; k++) 
+      if ((k != 13) && (v[k] > val) && (v[k] < a)) a = v[k];
+    if (a > NDG_MAX) break;
+    val = a;
+  }
+  return (uint8_t)val;
 } /* delta26p() */
 
 /* ==================================== */
@@ -1665,25 +2087,20 @@ int32_t separant6(  /* teste si un point est separant - minima 6-connexes
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
-  int32_t k, q;
+  int32_t k;
+  uint8_t v[32];
 
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
 
-  preparecubesh(img, p, img[p], rs, ps, N);
-  if (T6(cubec_topo3d) >= 2) return 1;
+  vois27(img, p, rs, ps, v);
+  if (NBT6B(nbtopo26(seuil27(v, img[p]))) >= 2) return 1;
 
-  for (k = 0; k < 26; k += 1)
-  {
-    q = voisin26(p, k, rs, ps, N);
-    if ((q != -1) && (img[q] <= img[p]))
-    {
-      preparecubesh(img, p, img[q], rs, ps, N);
-      if (T6(cubec_topo3d) >= 2) return 1;
-    }
-  }	
+  for (k = 0; k < 27; k += 1)
+    if ((k != 13) && (v[k] <= img[p]))
+      if (NBT6B(nbtopo26(seuil27(v, v[k]))) >= 2) return 1;
   return 0;
 } /* separant6() */
 
@@ -1698,15 +2115,12 @@ int32_t hseparant6(  /* teste si un point est hseparant - minima 6-connexes
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
-  int32_t k, q;
-
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
 
-  preparecubesh(img, p, h, rs, ps, N);
-  if (T6(cubec_topo3d) >= 2) return 1;
+  if (NBT6B(nbtopo26(mask27h(img, p, h, rs, ps))) >= 2) return 1;
   return 0;
 } /* hseparant6() */
 
@@ -1721,25 +2135,20 @@ int32_t hfseparant6(  /* teste si un point est hfseparant - minima 6-connexes
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
-  int32_t k, q;
+  int32_t k;
+  uint8_t v[32];
 
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
 
-  preparecubesh(img, p, img[p], rs, ps, N);
-  if (T6(cubec_topo3d) >= 2) return 1;
+  vois27(img, p, rs, ps, v);
+  if (NBT6B(nbtopo26(seuil27(v, img[p]))) >= 2) return 1;
 
-  for (k = 0; k < 26; k += 1)
-  {
-    q = voisin26(p, k, rs, ps, N);
-    if ((q != -1) && (img[q] > h) && (img[q] <= img[p]))
-    {
-      preparecubesh(img, p, img[q], rs, ps, N);
-      if (T6(cubec_topo3d) >= 2) return 1;
-    }
-  }	
+  for (k = 0; k < 27; k += 1)
+    if ((k != 13) && (v[k] > h) && (v[k] <= img[p]))
+      if (NBT6B(nbtopo26(seuil27(v, v[k]))) >= 2) return 1;
   return 0;
 } /* hfseparant6() */
 
@@ -1878,12 +2287,13 @@ int32_t t6mm(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return T6(cubec_topo3d);
+  c = nbtopo26(mask27h(img, p, img[p], rs, ps));
+  return NBT6B(c);
 } /* t6mm() */
 
 /* ==================================== */
@@ -1895,12 +2305,13 @@ int32_t t6m(                   /* pour des minima en 6-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return T6(cubec_topo3d);
+  c = nbtopo26(mask27h(img, p, img[p]+1, rs, ps));
+  return NBT6B(c);
 } /* t6m() */
 
 /* ==================================== */
@@ -1912,12 +2323,13 @@ int32_t t26mm(                   /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return T26(cubec_topo3d);
+  c = nbtopo6(mask27h(img, p, img[p], rs, ps));
+  return NBT26B(c);
 } /* t26mm() */
 
 /* ==================================== */
@@ -1929,12 +2341,13 @@ int32_t t26m(                   /* pour des minima en 26-connexite */
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return T26(cubec_topo3d);
+  c = nbtopo6(mask27h(img, p, img[p]+1, rs, ps));
+  return NBT26B(c);
 } /* t26m() */
 
 /* ==================================== */
@@ -1946,12 +2359,13 @@ int32_t t6pp(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return T6(cube_topo3d);
+  c = nbtopo6(mask27h(img, p, img[p]+1, rs, ps));
+  return NBT6(c);
 } /* t6pp() */
 
 /* ==================================== */
@@ -1963,12 +2377,13 @@ int32_t t6p(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return T6(cube_topo3d);
+  c = nbtopo6(mask27h(img, p, img[p], rs, ps));
+  return NBT6(c);
 } /* t6p() */
 
 /* ==================================== */
@@ -1980,12 +2395,13 @@ int32_t t26pp(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p]+1, rs, ps, N);
-  return T26(cube_topo3d);
+  c = nbtopo26(mask27h(img, p, img[p]+1, rs, ps));
+  return NBT26(c);
 } /* t26pp() */
 
 /* ==================================== */
@@ -1997,12 +2413,13 @@ int32_t t26p(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh(img, p, img[p], rs, ps, N);
-  return T26(cube_topo3d);
+  c = nbtopo26(mask27h(img, p, img[p], rs, ps));
+  return NBT26(c);
 } /* t26p() */
 
 /* ==================================== */
@@ -2014,12 +2431,13 @@ int32_t t26pp_l(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh_l(img, p, img[p]+1, rs, ps, N);
-  return T26(cube_topo3d);
+  c = nbtopo26(mask27h_l(img, p, img[p]+1, rs, ps));
+  return NBT26(c);
 } /* t26pp_l() */
 
 /* ==================================== */
@@ -2031,12 +2449,13 @@ int32_t t6pp_l(
   int32_t N)                       /* taille image */
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
     return 0;
-  preparecubesh_l(img, p, img[p]+1, rs, ps, N);
-  return T6(cube_topo3d);
+  c = nbtopo6(mask27h_l(img, p, img[p]+1, rs, ps));
+  return NBT6(c);
 } /* t6pp_l() */
 
 /* ==================================== */
@@ -2051,6 +2470,7 @@ void nbtopoh3d26_l( /* pour les minima en 26-connexite */
   int32_t *t26mm)
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
@@ -2058,9 +2478,9 @@ void nbtopoh3d26_l( /* pour les minima en 26-connexite */
       printf("ERREUR: nbtopoh3d26_l: point de bord\n");
       exit(0);
     }
-  preparecubesh_l(img, p, h, rs, ps, N);
-  *t6p = T6(cube_topo3d);
-  *t26mm = T26(cubec_topo3d);
+  c = nbtopo6(mask27h_l(img, p, h, rs, ps));
+  *t6p = NBT6(c);
+  *t26mm = NBT26B(c);
 } /* nbtopoh3d26_l() */
 
 /* ==================================== */
@@ -2075,6 +2495,7 @@ void nbtopoh3d6_l( /* pour les minima en 6-connexite */
   int32_t *t6mm)
 /* ==================================== */
 {
+  uint16_t c;
   if ((p < ps) || (p >= N-ps) ||         /* premier ou dernier plan */
       (p%ps < rs) || (p%ps >= ps-rs) ||  /* premiere ou derniere colonne */
       (p%rs == 0) || (p%rs == rs-1))     /* premiere ou derniere ligne */
@@ -2082,9 +2503,9 @@ void nbtopoh3d6_l( /* pour les minima en 6-connexite */
       printf("ERREUR: nbtopoh3d6_l: point de bord\n");
       exit(0);
     }
-  preparecubesh_l(img, p, h, rs, ps, N);
-  *t26p = T26(cube_topo3d);
-  *t6mm = T6(cubec_topo3d);
+  c = nbtopo26(mask27h_l(img, p, h, rs, ps));
+  *t26p = NBT26(c);
+  *t6mm = NBT6B(c);
 } /* nbtopoh3d6_l() */
 
 /* ==================================== */